@@ -1,4 +1,4 @@
-// sng_rand.h v0.1.0
+// sng_rand.h v0.2.0
 // James Gray, Jan 2016
 //
 // OVERVIEW
@@ -17,12 +17,31 @@
 // In a .c or .cpp file, define SNG_RAND_IMPLEMENTATION before including the
 // header.
 //
+// Distribution functions are provided on top of sngRandU32:
+//
+//  - sngRandBounded uses Lemire's multiply-shift method for unbiased
+//    integers in [0, n), which only divides on the rare rejection path.
+//    Prefer it over sngRandU32(state) % n, which is biased.
+//  - sngRandNormal and sngRandExponential use the Ziggurat method by
+//    Marsaglia and Tsang, with tables precomputed into this header. The
+//    layer index and the sample come from disjoint bits of one u32.
+//
+// sngRandF32 and sngRandF64 place random bits directly into the mantissa
+// of a float in [1, 2) and subtract 1, so they never divide, and never
+// round up to 1.0.
+//
+// Each distribution has a bulk variant (suffixed with N) that fills an
+// array, which keeps the generator state in registers across calls.
+//
+// The implementation uses log and exp from the C math library for the
+// Ziggurat tails, so link with -lm where required.
+//
 // TODO
 //
 //  - Build tests for C and C++
-//  - Diehard validation tests (TestU01?)
+//  - Run TestU01's BigCrush. test/rand_test.c has a small built-in battery,
+//    and a pipe mode for PractRand.
 //  - User defined parameters (cycle, c max, etc.)
-//  - Maybe provide some distribution functions
 //
 // LICENSE
 //
@@ -35,11 +54,14 @@
 #ifndef SNG_RAND_H
 #define SNG_RAND_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef uint32_t u32;
 typedef uint64_t u64;
+typedef int32_t  s32;
 typedef float    f32;
+typedef double   f64;
 
 #ifndef SNG_RAND_API
 #define SNG_RAND_API
@@ -65,13 +87,50 @@ SNG_RAND_API void sngRandInit(SngRand *state, u32 seed);
 // sngRandU32 returns a random integer between 0 and 2^32.
 SNG_RAND_API u32 sngRandU32(SngRand *state);
 
-// sngRandF32 returns a random float between 0.0 and 1.0
+// sngRandF32 returns a random float in [0.0, 1.0), with 23 random bits.
 SNG_RAND_API f32 sngRandF32(SngRand *state);
 
+// sngRandF64 returns a random double in [0.0, 1.0), with 52 random bits
+// taken from two calls to sngRandU32.
+SNG_RAND_API f64 sngRandF64(SngRand *state);
+
+// sngRandBounded returns a uniformly distributed integer in [0, n).
+// Returns 0 when n is 0.
+SNG_RAND_API u32 sngRandBounded(SngRand *state, u32 n);
+
+// sngRandNormal returns a normally distributed float with a mean of 0.0
+// and a standard deviation of 1.0.
+SNG_RAND_API f32 sngRandNormal(SngRand *state);
+
+// sngRandExponential returns an exponentially distributed float with a
+// rate (and mean) of 1.0. Divide by the rate for other distributions.
+SNG_RAND_API f32 sngRandExponential(SngRand *state);
+
+// sngRandU32N fills out with count results of sngRandU32.
+SNG_RAND_API void sngRandU32N(SngRand *state, u32 *out, size_t count);
+
+// sngRandF32N fills out with count results of sngRandF32.
+SNG_RAND_API void sngRandF32N(SngRand *state, f32 *out, size_t count);
+
+// sngRandF64N fills out with count results of sngRandF64.
+SNG_RAND_API void sngRandF64N(SngRand *state, f64 *out, size_t count);
+
+// sngRandBoundedN fills out with count results of sngRandBounded.
+SNG_RAND_API void sngRandBoundedN(SngRand *state, u32 n, u32 *out, size_t count);
+
+// sngRandNormalN fills out with count results of sngRandNormal.
+SNG_RAND_API void sngRandNormalN(SngRand *state, f32 *out, size_t count);
+
+// sngRandExponentialN fills out with count results of sngRandExponential.
+SNG_RAND_API void sngRandExponentialN(SngRand *state, f32 *out, size_t count);
+
 #endif // SNG_RAND_H
 
 #ifdef SNG_RAND_IMPLEMENTATION
 
+#include <math.h>   // logf, expf
+#include <string.h> // memcpy
+
 #ifndef SNG_RAND_NO_STDLIB
 
 #include <stdlib.h>
@@ -94,27 +153,477 @@ SNG_RAND_API void sngRandInit(SngRand *state, u32 seed) {
 
 #endif // !SNG_RAND_NO_STDLIB
 
+// _sngRandIndex is the position in Q of the last generated value.
+static u32 _sngRandIndex = SNG_RAND_CMWC_CYCLE - 1;
+
+static inline u32 _sngRandNext(SngRand *state) {
+	u64 t = 0;
+	u64 a = 18782;      // from Marsaglia
+	u32 r = 0xfffffffe; // from Marsaglia
+	u32 x = 0;
+
+	u32 i = _sngRandIndex = (_sngRandIndex + 1) & (SNG_RAND_CMWC_CYCLE - 1);
+	t = a * state->Q[i] + state->c;
+	state->c = (u32)(t >> 32);
+	x = (u32)t + state->c;
+	if (x < state->c) {
+		x++;
+		state->c++;
+	}
+
+	return state->Q[i] = r - x;
+}
+
 SNG_RAND_API u32 sngRandU32(SngRand *state) {
-    static u32 i = SNG_RAND_CMWC_CYCLE - 1;
-    u64 t = 0;
-    u64 a = 18782;      // from Marsaglia
-    u32 r = 0xfffffffe; // from Marsaglia
-    u32 x = 0;
+	return _sngRandNext(state);
+}
 
-    i = (i + 1) & (SNG_RAND_CMWC_CYCLE - 1);
-    t = a * state->Q[i] + state->c;
-    state->c = t >> 32;
-    x = (u32)t + state->c;
-    if (x < state->c) {
-        x++;
-        state->c++;
-    }
+static inline f32 _sngRandF32(SngRand *state) {
+	u32 bits = 0x3f800000u | (_sngRandNext(state) >> 9);
+	f32 f;
+	memcpy(&f, &bits, sizeof(f));
+	return f - 1.0f;
+}
 
-    return state->Q[i] = r - x;
+static inline f64 _sngRandF64(SngRand *state) {
+	u64 hi = _sngRandNext(state);
+	u64 lo = _sngRandNext(state);
+	u64 bits = 0x3ff0000000000000ull | (((hi << 32) | lo) >> 12);
+	f64 f;
+	memcpy(&f, &bits, sizeof(f));
+	return f - 1.0;
 }
 
 SNG_RAND_API f32 sngRandF32(SngRand *state) {
-	return (f32)sngRandU32(state) / 4294967296.0f;
+	return _sngRandF32(state);
+}
+
+SNG_RAND_API f64 sngRandF64(SngRand *state) {
+	return _sngRandF64(state);
+}
+
+static inline u32 _sngRandBounded(SngRand *state, u32 n) {
+	// Lemire, "Fast Random Integer Generation in an Interval", 2019.
+	u64 m = (u64)_sngRandNext(state) * n;
+	u32 l = (u32)m;
+	if (l < n) {
+		u32 threshold = (0u - n) % n;
+		while (l < threshold) {
+			m = (u64)_sngRandNext(state) * n;
+			l = (u32)m;
+		}
+	}
+	return (u32)(m >> 32);
+}
+
+SNG_RAND_API u32 sngRandBounded(SngRand *state, u32 n) {
+	return _sngRandBounded(state, n);
+}
+
+// Ziggurat tables, as computed by zigset() from Marsaglia and Tsang's
+// "The Ziggurat Method for Generating Random Variables" (2000), but with
+// the k tables scaled to 24 bit samples rather than 31/32 bit samples.
+// Normal: 128 layers, r = 3.442619855899, v = 9.91256303526217e-3.
+// Exponential: 256 layers, r = 7.697117470131487,
+// v = 3.949659822581572e-3.
+
+static const u32 _sngRandZigKn[128] = {
+	0x00ed5a44, 0x00000000, 0x00c01e36, 0x00d9c88f, 0x00e4b68d, 0x00eac00a,
+	0x00ee9243, 0x00f1344b, 0x00f3208b, 0x00f4979c, 0x00f5bec5, 0x00f6ad05,
+	0x00f77151, 0x00f815ce, 0x00f8a199, 0x00f919d8, 0x00f98259, 0x00f9ddfd,
+	0x00fa2efc, 0x00fa7711, 0x00fab79c, 0x00faf1ba, 0x00fb2651, 0x00fb561c,
+	0x00fb81ba, 0x00fba9ad, 0x00fbce63, 0x00fbf039, 0x00fc0f81, 0x00fc2c7d,
+	0x00fc476b, 0x00fc607b, 0x00fc77dd, 0x00fc8db6, 0x00fca22a, 0x00fcb557,
+	0x00fcc757, 0x00fcd844, 0x00fce832, 0x00fcf734, 0x00fd055b, 0x00fd12b8,
+	0x00fd1f58, 0x00fd2b47, 0x00fd3692, 0x00fd4141, 0x00fd4b60, 0x00fd54f5,
+	0x00fd5e09, 0x00fd66a4, 0x00fd6ecb, 0x00fd7684, 0x00fd7dd5, 0x00fd84c4,
+	0x00fd8b53, 0x00fd9188, 0x00fd9766, 0x00fd9cf1, 0x00fda22c, 0x00fda71a,
+	0x00fdabbe, 0x00fdb019, 0x00fdb42e, 0x00fdb800, 0x00fdbb8f, 0x00fdbedd,
+	0x00fdc1ec, 0x00fdc4bd, 0x00fdc751, 0x00fdc9a8, 0x00fdcbc4, 0x00fdcda5,
+	0x00fdcf4c, 0x00fdd0b8, 0x00fdd1e9, 0x00fdd2e0, 0x00fdd39c, 0x00fdd41d,
+	0x00fdd462, 0x00fdd46a, 0x00fdd435, 0x00fdd3c0, 0x00fdd30c, 0x00fdd215,
+	0x00fdd0da, 0x00fdcf58, 0x00fdcd8e, 0x00fdcb79, 0x00fdc914, 0x00fdc65d,
+	0x00fdc350, 0x00fdbfe8, 0x00fdbc1f, 0x00fdb7f1, 0x00fdb357, 0x00fdae49,
+	0x00fda8bf, 0x00fda2b0, 0x00fd9c12, 0x00fd94d9, 0x00fd8cf7, 0x00fd845d,
+	0x00fd7afa, 0x00fd70b8, 0x00fd6580, 0x00fd5938, 0x00fd4bbe, 0x00fd3ced,
+	0x00fd2c98, 0x00fd1a89, 0x00fd0680, 0x00fcf02e, 0x00fcd732, 0x00fcbb14,
+	0x00fc9b3b, 0x00fc76e6, 0x00fc4d18, 0x00fc1c7f, 0x00fbe354, 0x00fb9f18,
+	0x00fb4c34, 0x00fae541, 0x00fa61c1, 0x00f9b369, 0x00f8c01e, 0x00f75217,
+	0x00f4e442, 0x00efacc9,
+};
+
+static const f32 _sngRandZigWn[128] = {
+	2.213171868e-07f, 1.623158841e-08f, 2.162882275e-08f, 2.542424121e-08f,
+	2.845751269e-08f, 3.103351824e-08f, 3.330064883e-08f, 3.534334555e-08f,
+	3.721467241e-08f, 3.895036213e-08f, 4.057573787e-08f, 4.210946627e-08f,
+	4.356574480e-08f, 4.495565083e-08f, 4.628801274e-08f, 4.756999377e-08f,
+	4.880749623e-08f, 5.000544872e-08f, 5.116801519e-08f, 5.229875023e-08f,
+	5.340071634e-08f, 5.447657412e-08f, 5.552865247e-08f, 5.655900392e-08f,
+	5.756944891e-08f, 5.856161139e-08f, 5.953694782e-08f, 6.049677105e-08f,
+	6.144227004e-08f, 6.237452631e-08f, 6.329452775e-08f, 6.420318037e-08f,
+	6.510131818e-08f, 6.598971173e-08f, 6.686907545e-08f, 6.774007392e-08f,
+	6.860332740e-08f, 6.945941664e-08f, 7.030888704e-08f, 7.115225243e-08f,
+	7.198999825e-08f, 7.282258454e-08f, 7.365044852e-08f, 7.447400687e-08f,
+	7.529365787e-08f, 7.610978327e-08f, 7.692274999e-08f, 7.773291171e-08f,
+	7.854061027e-08f, 7.934617696e-08f, 8.014993380e-08f, 8.095219459e-08f,
+	8.175326600e-08f, 8.255344854e-08f, 8.335303748e-08f, 8.415232375e-08f,
+	8.495159474e-08f, 8.575113515e-08f, 8.655122774e-08f, 8.735215410e-08f,
+	8.815419537e-08f, 8.895763301e-08f, 8.976274948e-08f, 9.056982903e-08f,
+	9.137915836e-08f, 9.219102739e-08f, 9.300573005e-08f, 9.382356501e-08f,
+	9.464483648e-08f, 9.546985508e-08f, 9.629893869e-08f, 9.713241336e-08f,
+	9.797061425e-08f, 9.881388670e-08f, 9.966258729e-08f, 1.005170850e-07f,
+	1.013777625e-07f, 1.022450173e-07f, 1.031192637e-07f, 1.040009337e-07f,
+	1.048904791e-07f, 1.057883737e-07f, 1.066951145e-07f, 1.076112249e-07f,
+	1.085372565e-07f, 1.094737923e-07f, 1.104214496e-07f, 1.113808835e-07f,
+	1.123527906e-07f, 1.133379133e-07f, 1.143370450e-07f, 1.153510349e-07f,
+	1.163807946e-07f, 1.174273050e-07f, 1.184916242e-07f, 1.195748967e-07f,
+	1.206783636e-07f, 1.218033753e-07f, 1.229514047e-07f, 1.241240643e-07f,
+	1.253231248e-07f, 1.265505379e-07f, 1.278084625e-07f, 1.290992972e-07f,
+	1.304257174e-07f, 1.317907219e-07f, 1.331976888e-07f, 1.346504434e-07f,
+	1.361533439e-07f, 1.377113869e-07f, 1.393303419e-07f, 1.410169226e-07f,
+	1.427790092e-07f, 1.446259407e-07f, 1.465689050e-07f, 1.486214711e-07f,
+	1.508003278e-07f, 1.531263367e-07f, 1.556260734e-07f, 1.583341605e-07f,
+	1.612969382e-07f, 1.645785196e-07f, 1.682713837e-07f, 1.725163464e-07f,
+	1.775441320e-07f, 1.837747609e-07f, 1.921108356e-07f, 2.051961336e-07f,
+};
+
+static const f32 _sngRandZigFn[128] = {
+	1.000000000e+00f, 9.635996931e-01f, 9.362826817e-01f, 9.130436480e-01f,
+	8.922816508e-01f, 8.732430489e-01f, 8.555006079e-01f, 8.387836053e-01f,
+	8.229072114e-01f, 8.077382947e-01f, 7.931770118e-01f, 7.791460859e-01f,
+	7.655841739e-01f, 7.524415592e-01f, 7.396772437e-01f, 7.272569183e-01f,
+	7.151515074e-01f, 7.033360990e-01f, 6.917891434e-01f, 6.804918410e-01f,
+	6.694276673e-01f, 6.585820001e-01f, 6.479418211e-01f, 6.374954773e-01f,
+	6.272324852e-01f, 6.171433708e-01f, 6.072195366e-01f, 5.974531509e-01f,
+	5.878370544e-01f, 5.783646811e-01f, 5.690299911e-01f, 5.598274127e-01f,
+	5.507517931e-01f, 5.417983550e-01f, 5.329626594e-01f, 5.242405727e-01f,
+	5.156282382e-01f, 5.071220511e-01f, 4.987186355e-01f, 4.904148253e-01f,
+	4.822076463e-01f, 4.740943007e-01f, 4.660721527e-01f, 4.581387163e-01f,
+	4.502916437e-01f, 4.425287153e-01f, 4.348478302e-01f, 4.272469983e-01f,
+	4.197243320e-01f, 4.122780401e-01f, 4.049064208e-01f, 3.976078565e-01f,
+	3.903808082e-01f, 3.832238111e-01f, 3.761354695e-01f, 3.691144537e-01f,
+	3.621594954e-01f, 3.552693848e-01f, 3.484429675e-01f, 3.416791412e-01f,
+	3.349768533e-01f, 3.283350984e-01f, 3.217529159e-01f, 3.152293881e-01f,
+	3.087636380e-01f, 3.023548278e-01f, 2.960021568e-01f, 2.897048604e-01f,
+	2.834622082e-01f, 2.772735029e-01f, 2.711380791e-01f, 2.650553023e-01f,
+	2.590245674e-01f, 2.530452985e-01f, 2.471169475e-01f, 2.412389935e-01f,
+	2.354109423e-01f, 2.296323252e-01f, 2.239026994e-01f, 2.182216466e-01f,
+	2.125887731e-01f, 2.070037094e-01f, 2.014661101e-01f, 1.959756531e-01f,
+	1.905320403e-01f, 1.851349970e-01f, 1.797842721e-01f, 1.744796383e-01f,
+	1.692208922e-01f, 1.640078547e-01f, 1.588403711e-01f, 1.537183122e-01f,
+	1.486415742e-01f, 1.436100801e-01f, 1.386237800e-01f, 1.336826526e-01f,
+	1.287867062e-01f, 1.239359802e-01f, 1.191305467e-01f, 1.143705124e-01f,
+	1.096560210e-01f, 1.049872554e-01f, 1.003644410e-01f, 9.578784912e-02f,
+	9.125780083e-02f, 8.677467189e-02f, 8.233889824e-02f, 7.795098251e-02f,
+	7.361150188e-02f, 6.932111739e-02f, 6.508058521e-02f, 6.089077035e-02f,
+	5.675266348e-02f, 5.266740190e-02f, 4.863629586e-02f, 4.466086220e-02f,
+	4.074286807e-02f, 3.688438879e-02f, 3.308788615e-02f, 2.935631744e-02f,
+	2.569329194e-02f, 2.210330462e-02f, 1.859210274e-02f, 1.516729801e-02f,
+	1.183947866e-02f, 8.624484413e-03f, 5.548995221e-03f, 2.669629084e-03f,
+};
+
+static const u32 _sngRandZigKe[256] = {
+	0x00e290a1, 0x00000000, 0x009beade, 0x00c377ac, 0x00d4ddb9, 0x00de893f,
+	0x00e4a8e8, 0x00e8dff1, 0x00ebf2de, 0x00ee49a6, 0x00f0204e, 0x00f19bdb,
+	0x00f2d458, 0x00f3da10, 0x00f4b86d, 0x00f577ad, 0x00f61de8, 0x00f6afb7,
+	0x00f730a5, 0x00f7a376, 0x00f80a5b, 0x00f86718, 0x00f8bb1b, 0x00f90790,
+	0x00f94d70, 0x00f98d8c, 0x00f9c892, 0x00f9ff17, 0x00fa3199, 0x00fa6085,
+	0x00fa8c3a, 0x00fab508, 0x00fadb36, 0x00faff04, 0x00fb20a6, 0x00fb404f,
+	0x00fb5e29, 0x00fb7a59, 0x00fb9503, 0x00fbae44, 0x00fbc638, 0x00fbdcf8,
+	0x00fbf29a, 0x00fc0731, 0x00fc1ad1, 0x00fc2d8b, 0x00fc3f6c, 0x00fc5083,
+	0x00fc60dd, 0x00fc7086, 0x00fc7f88, 0x00fc8dec, 0x00fc9bbd, 0x00fca902,
+	0x00fcb5c3, 0x00fcc208, 0x00fccdd7, 0x00fcd935, 0x00fce42a, 0x00fceeba,
+	0x00fcf8eb, 0x00fd02c0, 0x00fd0c3f, 0x00fd156b, 0x00fd1e48, 0x00fd26da,
+	0x00fd2f25, 0x00fd372a, 0x00fd3eee, 0x00fd4673, 0x00fd4dbc, 0x00fd54cb,
+	0x00fd5ba2, 0x00fd6245, 0x00fd68b4, 0x00fd6ef1, 0x00fd7500, 0x00fd7ae1,
+	0x00fd8096, 0x00fd8620, 0x00fd8b82, 0x00fd90bc, 0x00fd95d1, 0x00fd9ac1,
+	0x00fd9f8d, 0x00fda437, 0x00fda8bf, 0x00fdad28, 0x00fdb171, 0x00fdb59c,
+	0x00fdb9a9, 0x00fdbd9b, 0x00fdc170, 0x00fdc52b, 0x00fdc8cc, 0x00fdcc54,
+	0x00fdcfc3, 0x00fdd319, 0x00fdd659, 0x00fdd982, 0x00fddc94, 0x00fddf91,
+	0x00fde279, 0x00fde54d, 0x00fde80c, 0x00fdeab7, 0x00fded50, 0x00fdefd5,
+	0x00fdf248, 0x00fdf4aa, 0x00fdf6f9, 0x00fdf937, 0x00fdfb64, 0x00fdfd81,
+	0x00fdff8d, 0x00fe018a, 0x00fe0376, 0x00fe0553, 0x00fe0721, 0x00fe08df,
+	0x00fe0a8f, 0x00fe0c30, 0x00fe0dc3, 0x00fe0f48, 0x00fe10bf, 0x00fe1228,
+	0x00fe1383, 0x00fe14d1, 0x00fe1611, 0x00fe1745, 0x00fe186b, 0x00fe1984,
+	0x00fe1a90, 0x00fe1b8f, 0x00fe1c82, 0x00fe1d68, 0x00fe1e42, 0x00fe1f0f,
+	0x00fe1fcf, 0x00fe2083, 0x00fe212b, 0x00fe21c7, 0x00fe2256, 0x00fe22d9,
+	0x00fe234f, 0x00fe23ba, 0x00fe2418, 0x00fe2469, 0x00fe24af, 0x00fe24e8,
+	0x00fe2514, 0x00fe2534, 0x00fe2547, 0x00fe254e, 0x00fe2548, 0x00fe2535,
+	0x00fe2515, 0x00fe24e8, 0x00fe24ae, 0x00fe2466, 0x00fe2411, 0x00fe23af,
+	0x00fe233e, 0x00fe22c0, 0x00fe2233, 0x00fe2198, 0x00fe20ee, 0x00fe2035,
+	0x00fe1f6d, 0x00fe1e96, 0x00fe1dae, 0x00fe1cb7, 0x00fe1bb0, 0x00fe1a97,
+	0x00fe196e, 0x00fe1832, 0x00fe16e5, 0x00fe1586, 0x00fe1414, 0x00fe128e,
+	0x00fe10f5, 0x00fe0f47, 0x00fe0d84, 0x00fe0bac, 0x00fe09bd, 0x00fe07b7,
+	0x00fe059a, 0x00fe0364, 0x00fe0115, 0x00fdfeab, 0x00fdfc26, 0x00fdf986,
+	0x00fdf6c8, 0x00fdf3ec, 0x00fdf0f0, 0x00fdedd3, 0x00fdea95, 0x00fde733,
+	0x00fde3ab, 0x00fddffd, 0x00fddc27, 0x00fdd826, 0x00fdd3f9, 0x00fdcf9d,
+	0x00fdcb11, 0x00fdc651, 0x00fdc15b, 0x00fdbc2c, 0x00fdb6c2, 0x00fdb117,
+	0x00fdab2a, 0x00fda4f5, 0x00fd9e76, 0x00fd97a6, 0x00fd9081, 0x00fd8901,
+	0x00fd8121, 0x00fd78d9, 0x00fd7022, 0x00fd66f4, 0x00fd5d47, 0x00fd530f,
+	0x00fd4843, 0x00fd3cd5, 0x00fd30b9, 0x00fd23de, 0x00fd1634, 0x00fd07a7,
+	0x00fcf821, 0x00fce789, 0x00fcd5c2, 0x00fcc2aa, 0x00fcae1d, 0x00fc97ed,
+	0x00fc7fe6, 0x00fc65cc, 0x00fc4957, 0x00fc2a2f, 0x00fc07ee, 0x00fbe213,
+	0x00fbb805, 0x00fb8900, 0x00fb5411, 0x00fb1800, 0x00fad334, 0x00fa8392,
+	0x00fa263b, 0x00f9b72d, 0x00f930a1, 0x00f889f0, 0x00f7b577, 0x00f69c65,
+	0x00f51530, 0x00f2cb0e, 0x00eeefb1, 0x00e6da6e,
+};
+
+static const f32 _sngRandZigWe[256] = {
+	5.183885974e-07f, 3.805885542e-09f, 6.248862002e-09f, 8.184014615e-09f,
+	9.842373286e-09f, 1.132242022e-08f, 1.267620985e-08f, 1.393499869e-08f,
+	1.511921664e-08f, 1.624305162e-08f, 1.731681558e-08f, 1.834827391e-08f,
+	1.934344274e-08f, 2.030709273e-08f, 2.124308111e-08f, 2.215457829e-08f,
+	2.304422724e-08f, 2.391425841e-08f, 2.476657448e-08f, 2.560281397e-08f,
+	2.642439998e-08f, 2.723257786e-08f, 2.802844495e-08f, 2.881297419e-08f,
+	2.958703312e-08f, 3.035139933e-08f, 3.110677311e-08f, 3.185378797e-08f,
+	3.259301932e-08f, 3.332499179e-08f, 3.405018547e-08f, 3.476904111e-08f,
+	3.548196461e-08f, 3.618933091e-08f, 3.689148732e-08f, 3.758875638e-08f,
+	3.828143838e-08f, 3.896981358e-08f, 3.965414413e-08f, 4.033467579e-08f,
+	4.101163940e-08f, 4.168525226e-08f, 4.235571926e-08f, 4.302323403e-08f,
+	4.368797979e-08f, 4.435013029e-08f, 4.500985051e-08f, 4.566729741e-08f,
+	4.632262050e-08f, 4.697596245e-08f, 4.762745961e-08f, 4.827724243e-08f,
+	4.892543593e-08f, 4.957216011e-08f, 5.021753024e-08f, 5.086165725e-08f,
+	5.150464802e-08f, 5.214660563e-08f, 5.278762965e-08f, 5.342781637e-08f,
+	5.406725900e-08f, 5.470604790e-08f, 5.534427075e-08f, 5.598201275e-08f,
+	5.661935674e-08f, 5.725638340e-08f, 5.789317137e-08f, 5.852979738e-08f,
+	5.916633639e-08f, 5.980286169e-08f, 6.043944502e-08f, 6.107615668e-08f,
+	6.171306561e-08f, 6.235023951e-08f, 6.298774490e-08f, 6.362564722e-08f,
+	6.426401088e-08f, 6.490289938e-08f, 6.554237536e-08f, 6.618250064e-08f,
+	6.682333635e-08f, 6.746494290e-08f, 6.810738013e-08f, 6.875070731e-08f,
+	6.939498321e-08f, 7.004026617e-08f, 7.068661412e-08f, 7.133408464e-08f,
+	7.198273500e-08f, 7.263262225e-08f, 7.328380321e-08f, 7.393633451e-08f,
+	7.459027269e-08f, 7.524567420e-08f, 7.590259542e-08f, 7.656109275e-08f,
+	7.722122262e-08f, 7.788304153e-08f, 7.854660607e-08f, 7.921197302e-08f,
+	7.987919930e-08f, 8.054834206e-08f, 8.121945873e-08f, 8.189260699e-08f,
+	8.256784488e-08f, 8.324523079e-08f, 8.392482350e-08f, 8.460668223e-08f,
+	8.529086667e-08f, 8.597743702e-08f, 8.666645401e-08f, 8.735797895e-08f,
+	8.805207379e-08f, 8.874880108e-08f, 8.944822412e-08f, 9.015040689e-08f,
+	9.085541417e-08f, 9.156331152e-08f, 9.227416537e-08f, 9.298804304e-08f,
+	9.370501276e-08f, 9.442514375e-08f, 9.514850624e-08f, 9.587517153e-08f,
+	9.660521202e-08f, 9.733870128e-08f, 9.807571407e-08f, 9.881632641e-08f,
+	9.956061564e-08f, 1.003086604e-07f, 1.010605409e-07f, 1.018163387e-07f,
+	1.025761367e-07f, 1.033400199e-07f, 1.041080744e-07f, 1.048803884e-07f,
+	1.056570518e-07f, 1.064381561e-07f, 1.072237951e-07f, 1.080140643e-07f,
+	1.088090616e-07f, 1.096088867e-07f, 1.104136417e-07f, 1.112234311e-07f,
+	1.120383617e-07f, 1.128585430e-07f, 1.136840868e-07f, 1.145151079e-07f,
+	1.153517238e-07f, 1.161940550e-07f, 1.170422249e-07f, 1.178963602e-07f,
+	1.187565910e-07f, 1.196230506e-07f, 1.204958760e-07f, 1.213752079e-07f,
+	1.222611910e-07f, 1.231539738e-07f, 1.240537092e-07f, 1.249605543e-07f,
+	1.258746711e-07f, 1.267962260e-07f, 1.277253905e-07f, 1.286623414e-07f,
+	1.296072608e-07f, 1.305603365e-07f, 1.315217622e-07f, 1.324917378e-07f,
+	1.334704696e-07f, 1.344581708e-07f, 1.354550615e-07f, 1.364613694e-07f,
+	1.374773299e-07f, 1.385031864e-07f, 1.395391910e-07f, 1.405856048e-07f,
+	1.416426981e-07f, 1.427107513e-07f, 1.437900551e-07f, 1.448809111e-07f,
+	1.459836324e-07f, 1.470985443e-07f, 1.482259847e-07f, 1.493663051e-07f,
+	1.505198711e-07f, 1.516870634e-07f, 1.528682784e-07f, 1.540639293e-07f,
+	1.552744471e-07f, 1.565002815e-07f, 1.577419021e-07f, 1.589997995e-07f,
+	1.602744871e-07f, 1.615665016e-07f, 1.628764055e-07f, 1.642047880e-07f,
+	1.655522672e-07f, 1.669194919e-07f, 1.683071436e-07f, 1.697159389e-07f,
+	1.711466320e-07f, 1.726000171e-07f, 1.740769319e-07f, 1.755782601e-07f,
+	1.771049356e-07f, 1.786579460e-07f, 1.802383366e-07f, 1.818472157e-07f,
+	1.834857592e-07f, 1.851552166e-07f, 1.868569170e-07f, 1.885922765e-07f,
+	1.903628053e-07f, 1.921701172e-07f, 1.940159386e-07f, 1.959021194e-07f,
+	1.978306455e-07f, 1.998036522e-07f, 2.018234397e-07f, 2.038924907e-07f,
+	2.060134900e-07f, 2.081893477e-07f, 2.104232245e-07f, 2.127185622e-07f,
+	2.150791176e-07f, 2.175090024e-07f, 2.200127298e-07f, 2.225952681e-07f,
+	2.252621050e-07f, 2.280193221e-07f, 2.308736843e-07f, 2.338327468e-07f,
+	2.369049827e-07f, 2.400999394e-07f, 2.434284276e-07f, 2.469027558e-07f,
+	2.505370208e-07f, 2.543474722e-07f, 2.583529759e-07f, 2.625756081e-07f,
+	2.670414297e-07f, 2.717815078e-07f, 2.768332890e-07f, 2.822424767e-07f,
+	2.880656565e-07f, 2.943740538e-07f, 3.012590700e-07f, 3.088407088e-07f,
+	3.172809187e-07f, 3.268057482e-07f, 3.377443652e-07f, 3.506031225e-07f,
+	3.662207523e-07f, 3.861414488e-07f, 4.137178439e-07f, 4.587839526e-07f,
+};
+
+static const f32 _sngRandZigFe[256] = {
+	1.000000000e+00f, 9.381436809e-01f, 9.004699299e-01f, 8.717043324e-01f,
+	8.477855006e-01f, 8.269932966e-01f, 8.084216515e-01f, 7.915276370e-01f,
+	7.759568520e-01f, 7.614633888e-01f, 7.478686220e-01f, 7.350380924e-01f,
+	7.228676596e-01f, 7.112747608e-01f, 7.001926551e-01f, 6.895664961e-01f,
+	6.793505723e-01f, 6.695063167e-01f, 6.600008411e-01f, 6.508058334e-01f,
+	6.418967164e-01f, 6.332519942e-01f, 6.248527387e-01f, 6.166821809e-01f,
+	6.087253821e-01f, 6.009689664e-01f, 5.934009017e-01f, 5.860103185e-01f,
+	5.787873586e-01f, 5.717230487e-01f, 5.648091929e-01f, 5.580382823e-01f,
+	5.514034165e-01f, 5.448982377e-01f, 5.385168720e-01f, 5.322538803e-01f,
+	5.261042140e-01f, 5.200631774e-01f, 5.141263938e-01f, 5.082897764e-01f,
+	5.025495018e-01f, 4.969019872e-01f, 4.913438696e-01f, 4.858719873e-01f,
+	4.804833639e-01f, 4.751751930e-01f, 4.699448253e-01f, 4.647897563e-01f,
+	4.597076156e-01f, 4.546961575e-01f, 4.497532512e-01f, 4.448768734e-01f,
+	4.400651008e-01f, 4.353161032e-01f, 4.306281373e-01f, 4.259995411e-01f,
+	4.214287290e-01f, 4.169141864e-01f, 4.124544660e-01f, 4.080481832e-01f,
+	4.036940125e-01f, 3.993906845e-01f, 3.951369818e-01f, 3.909317370e-01f,
+	3.867738291e-01f, 3.826621815e-01f, 3.785957594e-01f, 3.745735676e-01f,
+	3.705946484e-01f, 3.666580798e-01f, 3.627629734e-01f, 3.589084729e-01f,
+	3.550937529e-01f, 3.513180164e-01f, 3.475804946e-01f, 3.438804447e-01f,
+	3.402171491e-01f, 3.365899140e-01f, 3.329980688e-01f, 3.294409643e-01f,
+	3.259179724e-01f, 3.224284850e-01f, 3.189719128e-01f, 3.155476852e-01f,
+	3.121552488e-01f, 3.087940669e-01f, 3.054636192e-01f, 3.021634007e-01f,
+	2.988929210e-01f, 2.956517043e-01f, 2.924392882e-01f, 2.892552235e-01f,
+	2.860990737e-01f, 2.829704145e-01f, 2.798688332e-01f, 2.767939284e-01f,
+	2.737453097e-01f, 2.707225968e-01f, 2.677254199e-01f, 2.647534188e-01f,
+	2.618062427e-01f, 2.588835497e-01f, 2.559850070e-01f, 2.531102900e-01f,
+	2.502590824e-01f, 2.474310757e-01f, 2.446259691e-01f, 2.418434694e-01f,
+	2.390832903e-01f, 2.363451525e-01f, 2.336287834e-01f, 2.309339172e-01f,
+	2.282602939e-01f, 2.256076601e-01f, 2.229757681e-01f, 2.203643758e-01f,
+	2.177732471e-01f, 2.152021511e-01f, 2.126508620e-01f, 2.101191594e-01f,
+	2.076068277e-01f, 2.051136563e-01f, 2.026394391e-01f, 2.001839747e-01f,
+	1.977470661e-01f, 1.953285207e-01f, 1.929281500e-01f, 1.905457697e-01f,
+	1.881811994e-01f, 1.858342628e-01f, 1.835047871e-01f, 1.811926035e-01f,
+	1.788975466e-01f, 1.766194546e-01f, 1.743581692e-01f, 1.721135353e-01f,
+	1.698854013e-01f, 1.676736186e-01f, 1.654780419e-01f, 1.632985288e-01f,
+	1.611349399e-01f, 1.589871390e-01f, 1.568549924e-01f, 1.547383694e-01f,
+	1.526371420e-01f, 1.505511850e-01f, 1.484803756e-01f, 1.464245939e-01f,
+	1.443837222e-01f, 1.423576454e-01f, 1.403462511e-01f, 1.383494289e-01f,
+	1.363670709e-01f, 1.343990717e-01f, 1.324453279e-01f, 1.305057385e-01f,
+	1.285802045e-01f, 1.266686294e-01f, 1.247709186e-01f, 1.228869795e-01f,
+	1.210167218e-01f, 1.191600572e-01f, 1.173168992e-01f, 1.154871636e-01f,
+	1.136707679e-01f, 1.118676317e-01f, 1.100776764e-01f, 1.083008255e-01f,
+	1.065370041e-01f, 1.047861393e-01f, 1.030481602e-01f, 1.013229974e-01f,
+	9.961058367e-02f, 9.791085331e-02f, 9.622374255e-02f, 9.454918938e-02f,
+	9.288713356e-02f, 9.123751663e-02f, 8.960028191e-02f, 8.797537447e-02f,
+	8.636274114e-02f, 8.476233053e-02f, 8.317409301e-02f, 8.159798071e-02f,
+	8.003394754e-02f, 7.848194920e-02f, 7.694194317e-02f, 7.541388873e-02f,
+	7.389774699e-02f, 7.239348088e-02f, 7.090105516e-02f, 6.942043650e-02f,
+	6.795159342e-02f, 6.649449639e-02f, 6.504911779e-02f, 6.361543200e-02f,
+	6.219341541e-02f, 6.078304645e-02f, 5.938430563e-02f, 5.799717563e-02f,
+	5.662164128e-02f, 5.525768968e-02f, 5.390531020e-02f, 5.256449459e-02f,
+	5.123523706e-02f, 4.991753428e-02f, 4.861138557e-02f, 4.731679291e-02f,
+	4.603376108e-02f, 4.476229773e-02f, 4.350241357e-02f, 4.225412241e-02f,
+	4.101744138e-02f, 3.979239102e-02f, 3.857899550e-02f, 3.737728277e-02f,
+	3.618728478e-02f, 3.500903770e-02f, 3.384258215e-02f, 3.268796351e-02f,
+	3.154523217e-02f, 3.041444391e-02f, 2.929566022e-02f, 2.818894876e-02f,
+	2.709438378e-02f, 2.601204665e-02f, 2.494202642e-02f, 2.388442051e-02f,
+	2.283933541e-02f, 2.180688750e-02f, 2.078720407e-02f, 1.978042434e-02f,
+	1.878670074e-02f, 1.780620041e-02f, 1.683910683e-02f, 1.588562184e-02f,
+	1.494596801e-02f, 1.402039140e-02f, 1.310916493e-02f, 1.221259243e-02f,
+	1.133101360e-02f, 1.046481018e-02f, 9.614413643e-03f, 8.780314986e-03f,
+	7.963077438e-03f, 7.163353184e-03f, 6.381905937e-03f, 5.619642207e-03f,
+	4.877655984e-03f, 4.157295121e-03f, 3.460264778e-03f, 2.788798794e-03f,
+	2.145967744e-03f, 1.536299780e-03f, 9.672692823e-04f, 4.541343538e-04f,
+};
+
+#define _SNG_RAND_ZIG_NORMAL_R 3.442619855899f
+#define _SNG_RAND_ZIG_EXPONENTIAL_R 7.697117470131487f
+
+// _sngRandUnitOpen returns a float in the open interval (0, 1), which is
+// safe to pass to log. The top 24 bits with the lowest set are odd and
+// below 2^24, so they convert exactly and never reach 0 or 1.
+static inline f32 _sngRandUnitOpen(SngRand *state) {
+	return (f32)((_sngRandNext(state) >> 8) | 1) * (1.0f / 16777216.0f);
+}
+
+static inline u32 _sngRandAbs(s32 x) {
+	return (x < 0) ? (u32)-x : (u32)x;
+}
+
+static f32 _sngRandNormalSlow(SngRand *state, s32 hz, u32 iz) {
+	for (;;) {
+		f32 x = (f32)hz * _sngRandZigWn[iz];
+		if (iz == 0) {
+			// sample from the tail
+			f32 y;
+			do {
+				x = -logf(_sngRandUnitOpen(state)) / _SNG_RAND_ZIG_NORMAL_R;
+				y = -logf(_sngRandUnitOpen(state));
+			} while (y + y < x * x);
+			return (hz > 0) ? _SNG_RAND_ZIG_NORMAL_R + x : -_SNG_RAND_ZIG_NORMAL_R - x;
+		}
+		f32 f0 = _sngRandZigFn[iz];
+		f32 f1 = _sngRandZigFn[iz-1];
+		if (f0 + _sngRandUnitOpen(state) * (f1 - f0) < expf(-0.5f * x * x)) {
+			return x;
+		}
+		u32 u = _sngRandNext(state);
+		iz = u & 127;
+		hz = (s32)u >> 7;
+		if (_sngRandAbs(hz) < _sngRandZigKn[iz]) {
+			return (f32)hz * _sngRandZigWn[iz];
+		}
+	}
+}
+
+static inline f32 _sngRandNormal(SngRand *state) {
+	u32 u = _sngRandNext(state);
+	u32 iz = u & 127;
+	s32 hz = (s32)u >> 7;
+	if (_sngRandAbs(hz) < _sngRandZigKn[iz]) {
+		return (f32)hz * _sngRandZigWn[iz];
+	}
+	return _sngRandNormalSlow(state, hz, iz);
+}
+
+SNG_RAND_API f32 sngRandNormal(SngRand *state) {
+	return _sngRandNormal(state);
+}
+
+static f32 _sngRandExponentialSlow(SngRand *state, u32 jz, u32 iz) {
+	for (;;) {
+		if (iz == 0) {
+			return _SNG_RAND_ZIG_EXPONENTIAL_R - logf(_sngRandUnitOpen(state));
+		}
+		f32 x = (f32)jz * _sngRandZigWe[iz];
+		f32 f0 = _sngRandZigFe[iz];
+		f32 f1 = _sngRandZigFe[iz-1];
+		if (f0 + _sngRandUnitOpen(state) * (f1 - f0) < expf(-x)) {
+			return x;
+		}
+		u32 u = _sngRandNext(state);
+		iz = u & 255;
+		jz = u >> 8;
+		if (jz < _sngRandZigKe[iz]) {
+			return (f32)jz * _sngRandZigWe[iz];
+		}
+	}
+}
+
+static inline f32 _sngRandExponential(SngRand *state) {
+	u32 u = _sngRandNext(state);
+	u32 iz = u & 255;
+	u32 jz = u >> 8;
+	if (jz < _sngRandZigKe[iz]) {
+		return (f32)jz * _sngRandZigWe[iz];
+	}
+	return _sngRandExponentialSlow(state, jz, iz);
+}
+
+SNG_RAND_API f32 sngRandExponential(SngRand *state) {
+	return _sngRandExponential(state);
+}
+
+SNG_RAND_API void sngRandU32N(SngRand *state, u32 *out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		out[i] = _sngRandNext(state);
+	}
+}
+
+SNG_RAND_API void sngRandF32N(SngRand *state, f32 *out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		out[i] = _sngRandF32(state);
+	}
+}
+
+SNG_RAND_API void sngRandF64N(SngRand *state, f64 *out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		out[i] = _sngRandF64(state);
+	}
+}
+
+SNG_RAND_API void sngRandBoundedN(SngRand *state, u32 n, u32 *out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		out[i] = _sngRandBounded(state, n);
+	}
+}
+
+SNG_RAND_API void sngRandNormalN(SngRand *state, f32 *out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		out[i] = _sngRandNormal(state);
+	}
+}
+
+SNG_RAND_API void sngRandExponentialN(SngRand *state, f32 *out, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		out[i] = _sngRandExponential(state);
+	}
 }
 
 #endif // SNG_RAND_IMPLEMENTATION
@@ -0,0 +1,228 @@
+// sng_ring.h v0.0.0
+//
+// OVERVIEW
+//
+// sng_ring implements a lock-free ring buffer of bytes between exactly
+// one producer thread and one consumer thread.
+//
+// It is meant to sit between a thread reading a PTY and a thread parsing
+// its output: the producer reads straight into ring memory, and the
+// consumer passes ring memory straight to sngTermWrite, so the bytes are
+// never copied in between.
+//
+// USAGE
+//
+// In a .c or .cpp file, define SNG_RING_IMPLEMENTATION before including
+// the header.
+//
+// The producer asks for free space with sngRingWriteSpan, fills some of
+// it, and publishes what it filled with sngRingWriteCommit. The consumer
+// asks for published bytes with sngRingReadSpan, uses some of them, and
+// hands the space back with sngRingReadConsume. Spans stop at the end of
+// the buffer, so take a second span after the first runs out:
+//
+//     const u8 *data;
+//     size_t n;
+//     while ((n = sngRingReadSpan(ring, &data)) > 0) {
+//         sngTermWrite(t, data, n);
+//         sngRingReadConsume(ring, n);
+//     }
+//
+// Commit and consume in batches where possible. Each is one atomic store
+// to a cache line the other thread reads, so the fewer there are, the
+// less the two threads contend. Each side keeps a copy of the other's
+// position, and only loads it again when the copy says the ring is full
+// or empty.
+//
+// Neither side ever blocks. Waiting for data or space, by spinning or
+// with a condition variable or eventfd, is left to the user.
+//
+// DEPENDENCIES
+//
+// C standard library - stddef.h stdint.h string.h
+// GCC or Clang, for the __atomic builtins
+//
+// LICENSE
+//
+// This software is in the public domain. Where that dedication is not
+// recognized, you are granted a perpetual, irrevocable license to copy,
+// distribute, and modify this file as you see fit.
+//
+// No warranty. Use at your own risk.
+
+#ifndef SNG_RING_H
+#define SNG_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t  u8;
+typedef uint32_t b32;
+
+#ifndef SNG_RING_API
+#define SNG_RING_API
+#endif
+
+// SNG_RING_CACHE_LINE is the size of a cache line. The producer's and
+// consumer's state are each padded out to one, so the two threads do not
+// invalidate each other's cache lines as they go.
+#ifndef SNG_RING_CACHE_LINE
+#define SNG_RING_CACHE_LINE 64
+#endif
+
+// SngRingSide is the state written by one side of the ring.
+typedef struct {
+	size_t pos;   // bytes ever committed, or ever consumed
+	size_t other; // last seen pos of the other side
+	u8 _pad[SNG_RING_CACHE_LINE - 2*sizeof(size_t)];
+} SngRingSide;
+
+// SngRing is a ring buffer between one producer and one consumer. Align
+// it to SNG_RING_CACHE_LINE so that each side has a line to itself.
+typedef struct {
+	SngRingSide producer;
+	SngRingSide consumer;
+	u8 *buf;
+	size_t size;
+	u8 _pad[SNG_RING_CACHE_LINE - sizeof(u8 *) - sizeof(size_t)];
+} SngRing;
+
+// sngRingInit initializes ring over buf, whose size must be a power of
+// two. Returns zero if it is not.
+SNG_RING_API b32 sngRingInit(SngRing *ring, void *buf, size_t size);
+
+// sngRingWriteSpan points data at free space following the bytes written
+// so far, and returns how large it is. Producer only.
+SNG_RING_API size_t sngRingWriteSpan(SngRing *ring, u8 **data);
+
+// sngRingWriteCommit publishes n bytes written to the space from
+// sngRingWriteSpan to the consumer. Producer only.
+SNG_RING_API void sngRingWriteCommit(SngRing *ring, size_t n);
+
+// sngRingWrite copies up to len bytes of data into the ring and commits
+// them, and returns how many fit. Producer only.
+SNG_RING_API size_t sngRingWrite(SngRing *ring, const void *data, size_t len);
+
+// sngRingReadSpan points data at bytes committed by the producer and not
+// yet consumed, and returns how many there are. Consumer only.
+SNG_RING_API size_t sngRingReadSpan(SngRing *ring, const u8 **data);
+
+// sngRingReadConsume hands n bytes from sngRingReadSpan back to the
+// producer. Consumer only.
+SNG_RING_API void sngRingReadConsume(SngRing *ring, size_t n);
+
+// sngRingRead copies up to len bytes out of the ring and consumes them,
+// and returns how many there were. Consumer only.
+SNG_RING_API size_t sngRingRead(SngRing *ring, void *data, size_t len);
+
+#endif // SNG_RING_H
+
+#ifdef SNG_RING_IMPLEMENTATION
+
+#include <string.h> // memcpy, memset
+
+// Positions count bytes ever passed through the ring, and wrap around
+// with size_t. size is a power of two, so their difference and their
+// offset into buf stay correct across the wrap.
+
+SNG_RING_API b32 sngRingInit(SngRing *ring, void *buf, size_t size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return 0;
+	}
+	memset(ring, 0, sizeof(*ring));
+	ring->buf = (u8 *)buf;
+	ring->size = size;
+	return 1;
+}
+
+// _sngRingWriteSpanAt is sngRingWriteSpan, for the free space following
+// tail rather than the bytes committed.
+static size_t _sngRingWriteSpanAt(SngRing *ring, size_t tail, u8 **data) {
+	size_t space = ring->size - (tail - ring->producer.other);
+	if (space == 0) {
+		// The copy of head says full; see how far the consumer got.
+		ring->producer.other = __atomic_load_n(&ring->consumer.pos, __ATOMIC_ACQUIRE);
+		space = ring->size - (tail - ring->producer.other);
+	}
+	size_t offset = tail & (ring->size - 1);
+	size_t end = ring->size - offset;
+	*data = &ring->buf[offset];
+	return space < end ? space : end;
+}
+
+SNG_RING_API size_t sngRingWriteSpan(SngRing *ring, u8 **data) {
+	return _sngRingWriteSpanAt(ring, ring->producer.pos, data);
+}
+
+SNG_RING_API void sngRingWriteCommit(SngRing *ring, size_t n) {
+	__atomic_store_n(&ring->producer.pos, ring->producer.pos + n, __ATOMIC_RELEASE);
+}
+
+SNG_RING_API size_t sngRingWrite(SngRing *ring, const void *data, size_t len) {
+	const u8 *src = (const u8 *)data;
+	size_t written = 0;
+	// At most two spans, on either side of the end of buf, go out in one
+	// commit.
+	while (written < len) {
+		u8 *dest;
+		size_t n = _sngRingWriteSpanAt(ring, ring->producer.pos + written, &dest);
+		if (n == 0) {
+			break;
+		}
+		if (n > len - written) {
+			n = len - written;
+		}
+		memcpy(dest, &src[written], n);
+		written += n;
+	}
+	if (written > 0) {
+		sngRingWriteCommit(ring, written);
+	}
+	return written;
+}
+
+// _sngRingReadSpanAt is sngRingReadSpan, for the bytes following head
+// rather than the bytes consumed.
+static size_t _sngRingReadSpanAt(SngRing *ring, size_t head, const u8 **data) {
+	size_t used = ring->consumer.other - head;
+	if (used == 0) {
+		// The copy of tail says empty; see how far the producer got.
+		ring->consumer.other = __atomic_load_n(&ring->producer.pos, __ATOMIC_ACQUIRE);
+		used = ring->consumer.other - head;
+	}
+	size_t offset = head & (ring->size - 1);
+	size_t end = ring->size - offset;
+	*data = &ring->buf[offset];
+	return used < end ? used : end;
+}
+
+SNG_RING_API size_t sngRingReadSpan(SngRing *ring, const u8 **data) {
+	return _sngRingReadSpanAt(ring, ring->consumer.pos, data);
+}
+
+SNG_RING_API void sngRingReadConsume(SngRing *ring, size_t n) {
+	__atomic_store_n(&ring->consumer.pos, ring->consumer.pos + n, __ATOMIC_RELEASE);
+}
+
+SNG_RING_API size_t sngRingRead(SngRing *ring, void *data, size_t len) {
+	u8 *dest = (u8 *)data;
+	size_t read = 0;
+	while (read < len) {
+		const u8 *src;
+		size_t n = _sngRingReadSpanAt(ring, ring->consumer.pos + read, &src);
+		if (n == 0) {
+			break;
+		}
+		if (n > len - read) {
+			n = len - read;
+		}
+		memcpy(&dest[read], src, n);
+		read += n;
+	}
+	if (read > 0) {
+		sngRingReadConsume(ring, read);
+	}
+	return read;
+}
+
+#endif // SNG_RING_IMPLEMENTATION
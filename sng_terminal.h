@@ -7,16 +7,32 @@
 //
 // Use for terminal muxing, a terminal emulation frontend, or wherever
 // else you need terminal emulation. There are no dependencies aside
-// from the C standard library. Influenced largely by st, rxvt, xterm,
-// and iTerm as reference.
+// from the C standard library and, for snapshots, the __atomic builtins
+// of GCC or Clang. Influenced largely by st, rxvt, xterm, and iTerm as
+// reference.
 //
 // USAGE
 //
 // define SNG_TERMINAL_IMPLEMENTATION, etc. etc.
 //
+// sngTermWrite parses UTF-8 bytes, and is preferred over calling
+// sngTermUpdate per codepoint. It also lets OSC, DCS, APC and PM payloads
+// be passed to a SngTermStrFunc as slices of the input, without being
+// copied, no matter how large they are. For example, an OSC 52 clipboard
+// transfer may be decoded as it arrives with sngTermBase64Decode.
+//
+// Define SNG_TERM_DIAGNOSTICS to count unknown or unsupported input per
+// terminal, and to receive SNG_TERM_EVENT_* codes through a callback set
+// with sngTermSetEventFunc. Without it, unknown input is silently
+// ignored, and the diagnostics compile to nothing.
+//
 // DEPENDENCIES
 //
 // C standard library - stdint.h stdio.h stdlib.h string.h
+// GCC or Clang, for the __atomic builtins of sngTermPublish and
+// sngTermSnapshotAcquire
+// x86intrin.h or intrin.h, with SNG_TERM_STATS_CYCLES and no
+// SNG_TERM_STATS_CLOCK of your own
 //
 // LICENSE
 //
@@ -31,7 +47,7 @@
 
 #include <stdint.h>
 #include <stdlib.h> // strtol
-#include <stdio.h>  // fprintf
+#include <stdio.h>  // snprintf
 #include <string.h> // memmove
 
 typedef    float f32;
@@ -42,6 +58,7 @@ typedef  int32_t s32;
 typedef  uint8_t u8;
 typedef uint16_t u16;
 typedef uint32_t u32;
+typedef uint64_t u64;
 typedef       u8 b8;
 typedef      u32 b32;
 
@@ -58,6 +75,12 @@ enum {
 	SNG_TERM_ATTR_ITALIC    = (1 << 4),
 	SNG_TERM_ATTR_BLINK     = (1 << 5),
 	SNG_TERM_ATTR_WRAP      = (1 << 6),
+
+	// Double width characters take two cells. The first has
+	// SNG_TERM_ATTR_WIDE set, and the second is a spacer with codepoint
+	// zero, which renderers should skip.
+	SNG_TERM_ATTR_WIDE        = (1 << 7),
+	SNG_TERM_ATTR_WIDE_SPACER = (1 << 8),
 };
 
 // SNG_TERM_CHANGED_* represent change flags to inform the user of any
@@ -65,6 +88,7 @@ enum {
 enum {
 	SNG_TERM_CHANGED_SCREEN = (1 << 0),
 	SNG_TERM_CHANGED_TITLE  = (1 << 1),
+	SNG_TERM_CHANGED_OUTPUT = (1 << 2), // see sngTermOutputPeek
 };
 
 // SNG_TERM_COLOR_* represent color codes.
@@ -91,9 +115,47 @@ enum {
 	// Otherwise, the simple case is to map default colors to another
 	// color. These values are specific to sng_terminal.
 	SNG_TERM_COLOR_DEFAULT_FG = 0xff80,
-	SNG_TERM_COLOR_DEFAULT_BG = 0xff81
+	SNG_TERM_COLOR_DEFAULT_BG = 0xff81,
+
+	// 24-bit colors are stored in a per-terminal table, and cells refer
+	// to them by index with this flag set. Use sngTermColorRGB to look
+	// them up.
+	SNG_TERM_COLOR_RGB_FLAG = 0x8000,
 };
 
+// SNG_TERM_RGB_TABLE_SIZE is the number of distinct 24-bit colors each
+// terminal can hold, and must be a power of two no greater than 4096.
+// Once the table is three quarters full, colors no longer on either
+// screen are swept out, and if that frees too little, new colors are
+// mapped to the nearest color in the 256 color palette.
+#ifndef SNG_TERM_RGB_TABLE_SIZE
+#define SNG_TERM_RGB_TABLE_SIZE 512
+#endif
+
+// SNG_TERM_MARKS_TABLE_SIZE is the number of distinct sequences of
+// combining marks each terminal can hold, and must be a power of two no
+// greater than 32768. Each cell may carry up to two marks. Once the table
+// is three quarters full, combinations no longer on either screen are
+// swept out, and if that frees too little, marks in new combinations are
+// dropped.
+#ifndef SNG_TERM_MARKS_TABLE_SIZE
+#define SNG_TERM_MARKS_TABLE_SIZE 256
+#endif
+
+// SNG_TERM_OUTPUT_SIZE is the size of each terminal's output buffer, for
+// replies to be written back to the application, and must be a power of
+// two. Replies that do not fit are dropped whole.
+#ifndef SNG_TERM_OUTPUT_SIZE
+#define SNG_TERM_OUTPUT_SIZE 256
+#endif
+
+// SNG_TERM_SYNC_TIMEOUT is how long, in milliseconds, a synchronized
+// update may hold back changes before sngTermFrameReady gives up on it,
+// so an application that dies mid-frame does not freeze its screen.
+#ifndef SNG_TERM_SYNC_TIMEOUT
+#define SNG_TERM_SYNC_TIMEOUT 150
+#endif
+
 // SNG_TERM_MODE_* represent terminal modes.
 enum {
 	SNG_TERM_MODE_WRAP          = (1 << 0),
@@ -103,7 +165,7 @@ enum {
 	SNG_TERM_MODE_CRLF          = (1 << 4),
 	SNG_TERM_MODE_MOUSE_BUTTON  = (1 << 5),
 	SNG_TERM_MODE_MOUSE_MOTION  = (1 << 6),
-	SNG_TERM_MODE_REVERSE       = (1 << 7),
+	SNG_TERM_MODE_REVERSE       = (1 << 7),  // see sngTermResolveColors
 	SNG_TERM_MODE_KEYBOARD_LOCK = (1 << 8),
 	SNG_TERM_MODE_HIDE          = (1 << 9),
 	SNG_TERM_MODE_ECHO          = (1 << 10),
@@ -115,6 +177,7 @@ enum {
 	SNG_TERM_MODE_FOCUS         = (1 << 16),
 	SNG_TERM_MODE_MOUSE_X10     = (1 << 17),
 	SNG_TERM_MODE_MOUSE_MANY    = (1 << 18),
+	SNG_TERM_MODE_SYNC          = (1 << 19), // see sngTermFrameReady
 	SNG_TERM_MODE_MOUSE_MASK    =
 		SNG_TERM_MODE_MOUSE_BUTTON |
 		SNG_TERM_MODE_MOUSE_MOTION |
@@ -124,31 +187,541 @@ enum {
 
 typedef struct SngTerm SngTerm;
 
+// SngTermCell is a single character cell of the screen.
+typedef struct {
+	u32 codepoint;
+	u16 fg, bg;
+	u16 attr;
+	u16 marks; // combining marks, if nonzero; see sngTermCellMarks
+} SngTermCell;
+
+// SngTermRun is a run of cells with the same colors and attributes, as
+// found by sngTermLineRun.
+typedef struct {
+	int x, width; // columns covered
+	u16 fg, bg;   // resolved, as by sngTermResolveColors
+	u16 attr;     // without SNG_TERM_ATTR_WRAP, GFX, WIDE or WIDE_SPACER
+	u8 _pad[2];
+	size_t textLen;
+} SngTermRun;
+
+// SNG_TERM_RUN_TEXT_MIN is the smallest text buffer for sngTermLineRun,
+// enough for one cell: a character and two combining marks.
+#define SNG_TERM_RUN_TEXT_MIN 12
+
+// SngTermSearch is a pattern to find with sngTermSearch, and what it saw
+// of the screen last time.
+typedef struct SngTermSearch SngTermSearch;
+
+// SngTermSnapshot is a copy of a terminal's screen, for rendering on
+// another thread. SngTermSnapshots passes them from the thread that
+// parses to the one that renders.
+typedef struct SngTermSnapshot SngTermSnapshot;
+typedef struct SngTermSnapshots SngTermSnapshots;
+
+// SNG_TERM_SEARCH_MAX is the longest pattern of a SngTermSearch, in
+// characters.
+#define SNG_TERM_SEARCH_MAX 128
+
+// SNG_TERM_SEARCH_* are flags passed to sngTermSearch.
+enum {
+	SNG_TERM_SEARCH_CHANGED = (1 << 0), // only rows changed since last time
+};
+
+// SngTermMatch is where sngTermSearch found its pattern: the column of
+// the first cell, and the row.
+typedef struct {
+	int x, y;
+} SngTermMatch;
+
+// SNG_TERM_STR_* are flags passed to SngTermStrFunc.
+enum {
+	SNG_TERM_STR_BEGIN = (1 << 0), // first call for this sequence
+	SNG_TERM_STR_END   = (1 << 1), // sequence was terminated normally
+	SNG_TERM_STR_ABORT = (1 << 2), // sequence was cut off by other input
+};
+
+// SngTermStrFunc receives the payload of STR sequences (OSC, DCS, APC,
+// PM) in chunks, as they are parsed. type is the character that started
+// the sequence, such as ']' for OSC. data is only valid during the call.
+//
+// Each sequence ends with exactly one call with SNG_TERM_STR_END or
+// SNG_TERM_STR_ABORT set, which may have no data. SNG_TERM_STR_BEGIN is
+// set on the first call.
+typedef void (*SngTermStrFunc)(
+	void *user, SngTerm *t,
+	u32 type,
+	const char *data, size_t len,
+	int flags
+);
+
+// SngTermBase64 stores the state of an incremental base64 decoder. Zero
+// it to begin decoding.
+typedef struct {
+	u32 bits;
+	int bitsLen;
+} SngTermBase64;
+
+#ifdef SNG_TERM_DIAGNOSTICS
+// SNG_TERM_EVENT_* represent diagnostic events, reported when the parser
+// meets input it does not understand. Each comment describes the event's
+// arg.
+enum {
+	SNG_TERM_EVENT_UNKNOWN_ESC,          // final character
+	SNG_TERM_EVENT_UNKNOWN_CHARSET,      // charset character
+	SNG_TERM_EVENT_UNKNOWN_CSI,          // final character
+	SNG_TERM_EVENT_UNEXPECTED_CSI_ARGS,  // final character
+	SNG_TERM_EVENT_BAD_CSI,              // offending character
+	SNG_TERM_EVENT_UNKNOWN_MODE,         // mode number
+	SNG_TERM_EVENT_UNKNOWN_PRIVATE_MODE, // mode number
+	SNG_TERM_EVENT_UNSUPPORTED_MODE,     // mode number
+	SNG_TERM_EVENT_UNKNOWN_SGR,          // attribute number
+	SNG_TERM_EVENT_BAD_SGR_COLOR,        // 38 or 48
+	SNG_TERM_EVENT_UNKNOWN_OSC,          // command number
+	SNG_TERM_EVENT_UNKNOWN_STR,          // type character
+	SNG_TERM_EVENT_NO_ALT_SCREEN,        // mode number
+	SNG_TERM_EVENT_NO_ROW,               // line number
+	SNG_TERM_EVENT_OUTPUT_FULL,          // bytes dropped
+	SNG_TERM_EVENT_SYNC_TIMEOUT,         // milliseconds held
+	SNG_TERM_EVENT_COUNT,
+};
+
+// SngTermEventFunc is called for each diagnostic event. It is called from
+// within sngTermUpdate, so it must not call back into t.
+typedef void (*SngTermEventFunc)(void *user, SngTerm *t, int event, int arg);
+#endif
+
+#ifdef SNG_TERM_STATS
+#ifdef SNG_TERM_STATS_CYCLES
+// SNG_TERM_TIMER_* represent the handlers timed with SNG_TERM_STATS_CYCLES.
+// Times are inclusive, so a scroll done by a CSI sequence counts toward
+// both. The clock is read around every character that is not part of an
+// ASCII run, which can double the cost of parsing escape-heavy output,
+// so leave it off except while looking into a workload.
+enum {
+	SNG_TERM_TIMER_CHARS,  // putting printable characters on the screen
+	SNG_TERM_TIMER_CSI,    // CSI sequences
+	SNG_TERM_TIMER_STR,    // OSC and other string sequences
+	SNG_TERM_TIMER_SCROLL, // scrolling, and inserting or deleting lines
+	SNG_TERM_TIMER_COUNT,
+};
+
+// SNG_TERM_STATS_CLOCK returns a cycle count, read before and after each
+// timed handler. It defaults to the TSC on x86, and must be defined
+// elsewhere.
+#ifndef SNG_TERM_STATS_CLOCK
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SNG_TERM_STATS_CLOCK() __rdtsc()
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SNG_TERM_STATS_CLOCK() __rdtsc()
+#else
+#error "define SNG_TERM_STATS_CLOCK for SNG_TERM_STATS_CYCLES"
+#endif
+#endif
+#endif
+
+// SngTermStats counts the work a terminal has done since it was
+// initialized or its stats were reset, so hosts can tell which terminals
+// are costly without a profiler. Terminals only keep them when
+// SNG_TERM_STATS is defined; counting costs a few percent.
+typedef struct {
+	u64 bytes;         // bytes passed to sngTermWrite
+	u64 chars;         // printable characters put, combining marks included
+	u64 csi[64];       // CSI sequences, by final character - 0x40
+	u64 esc[96];       // escape sequences, by the character after ESC - 0x20
+	u64 strs;          // string sequences ended, OSC included
+	u64 osc;           // OSC sequences ended
+	u64 scrolls;       // scrolls, and lines inserted or deleted at once
+	u64 linesScrolled; // lines moved by them
+	u64 cellsCleared;  // cells erased, by erase sequences and scrolls
+	u64 frames;        // times sngTermFrameReady has returned nonzero
+	u64 frameRows;     // dirty rows at those times, summed
+	u64 frameRowsMax;  // the most dirty rows at any one of them
+#ifdef SNG_TERM_STATS_CYCLES
+	u64 cycles[SNG_TERM_TIMER_COUNT]; // SNG_TERM_STATS_CLOCK cycles spent
+	u64 calls[SNG_TERM_TIMER_COUNT];  // times each handler ran
+#endif
+} SngTermStats;
+#endif
+
+// SngTermAllocFunc allocates size bytes, aligned for pointers, or frees
+// ptr when size is zero. It returns NULL if it is out of memory.
+typedef void *(*SngTermAllocFunc)(void *user, void *ptr, size_t size);
+
+// SNG_TERM_POOL_LOCK and SNG_TERM_POOL_UNLOCK are called around every use
+// of a SngTermAltPool or SngTermRowPool. They do nothing by default, so
+// terminals sharing a pool must be used from one thread, unless these are
+// defined to lock a mutex.
+#ifndef SNG_TERM_POOL_LOCK
+#define SNG_TERM_POOL_LOCK(pool)
+#define SNG_TERM_POOL_UNLOCK(pool)
+#endif
+
+// SngTermAltPool hands out alternate screens, for any number of terminals
+// of the same maximum size, from one block of memory.
+typedef struct {
+	void *free; // singly linked list of free blocks
+	size_t blockSize;
+	int blocksFree;
+	u8 _pad[4];
+} SngTermAltPool;
+
+// SngTermRowPool hands out lines to terminals initialized with
+// sngTermInitPooled, so their memory follows what they display rather
+// than their maximum size. Lines that are entirely blank, in the default
+// colors, all share one read only row of the pool, and only take a row
+// of their own once written to.
+typedef struct {
+	void *free; // singly linked list of free rows
+	SngTermCell *blank; // shared blank line
+	size_t rowSize;
+	int width;
+	int rowsFree;
+} SngTermRowPool;
+
 // sngTermAllocSize returns how many bytes should be allocated for the
-// memory passed into sngTermInit.
+// memory passed into sngTermInit. It is the same as sngTermAllocSizeMax.
 size_t sngTermAllocSize(int maxWidth, int maxHeight);
 
+// sngTermAllocSizeMin returns the smallest memory size sngTermInit
+// accepts, which leaves out the alternate screen. It is then allocated
+// with the SngTermAllocFunc set by sngTermSetAltAlloc, the first time an
+// application switches to it.
+size_t sngTermAllocSizeMin(int maxWidth, int maxHeight);
+
+// sngTermAllocSizeMax returns the memory size a terminal needs with its
+// alternate screen, whether it lives in the memory passed to sngTermInit
+// or was allocated later.
+size_t sngTermAllocSizeMax(int maxWidth, int maxHeight);
+
+// sngTermAltAllocSize returns the size of the alternate screen, as
+// requested from a SngTermAllocFunc.
+size_t sngTermAltAllocSize(int maxWidth, int maxHeight);
+
 // sngTermInit initializes memory, expected to be sized by
-// sngTermAllocSize, and returns a pointer to SngTerm. If seedTerm is
-// not NULL, we initialize with seedTerm's state.
+// sngTermAllocSize, and returns a pointer to SngTerm. If memorySize is
+// at least sngTermAllocSizeMin but less than sngTermAllocSizeMax, the
+// alternate screen is allocated on demand instead. If seedTerm is not
+// NULL, we initialize with seedTerm's state.
 SngTerm *sngTermInit(
 	void *memory, size_t memorySize,
 	int maxWidth, int maxHeight,
 	SngTerm *seedTerm
 );
 
+// sngTermAllocSizePooled returns how many bytes should be allocated for
+// the memory passed into sngTermInitPooled. It holds no cells, only line
+// pointers and other per-line state.
+size_t sngTermAllocSizePooled(int maxWidth, int maxHeight);
+
+// sngTermInitPooled initializes memory, expected to be sized by
+// sngTermAllocSizePooled, as a terminal that takes the lines of both of
+// its screens from pool. maxWidth may be no greater than the pool's. The
+// terminal holds at most rowQuota rows at once; output to lines beyond
+// that, or while the pool is empty, is dropped.
+SngTerm *sngTermInitPooled(
+	void *memory, size_t memorySize,
+	int maxWidth, int maxHeight,
+	SngTermRowPool *pool, int rowQuota
+);
+
 // sngTermSetSize resizes the terminal, where width and height must be
 // less than maxWidth and maxHeight. Returns zero on error.
 b32 sngTermSetSize(SngTerm *t, int width, int height);
 
+// sngTermReflowScratchSize returns how many bytes of scratch memory
+// sngTermSetSizeReflow needs for a terminal of maxWidth by maxHeight.
+size_t sngTermReflowScratchSize(int maxWidth, int maxHeight);
+
+// sngTermSetSizeReflow resizes the terminal like sngTermSetSize, but
+// rewraps the lines of the main screen to the new width, joining lines
+// that were wrapped before. It takes a single pass over the cells, through
+// scratch, which must be aligned for pointers and sized by
+// sngTermReflowScratchSize. Lines pushed off the top are lost. The
+// alternate screen is resized without reflow, as applications redraw it.
+// Returns zero on error.
+b32 sngTermSetSizeReflow(SngTerm *t, int width, int height, void *scratch, size_t scratchSize);
+
 // sngTermUpdate updates t's state as it parses another codepoint.
 void sngTermUpdate(SngTerm *t, u32 codepoint);
 
+// sngTermCell returns the cell at x, y.
+SngTermCell sngTermCell(const SngTerm *t, int x, int y);
+
+// sngTermLine returns the cells of line y. Cleared lines are only written
+// out when first needed, so this may cost up to one pass over the line.
+const SngTermCell *sngTermLine(SngTerm *t, int y);
+
+// sngTermLineBlank returns the column from which line y is filled with
+// blank, to its end. Renderers may use it to skip cells, or to call
+// sngTermLine for only the part of the line before it. Returns the
+// terminal width if the line has no blank tail. blank is usually a
+// space, but is an 'E' on lines filled by DECALN.
+int sngTermLineBlank(const SngTerm *t, int y, SngTermCell *blank);
+
+// sngTermLineRun finds the longest run of cells in line y that starts at
+// column x and shares one style, and writes its text to text as UTF-8,
+// with combining marks and without the spacers of wide characters. text
+// may be NULL; otherwise it must hold at least SNG_TERM_RUN_TEXT_MIN
+// bytes, and a run whose text does not fit is cut short. Returns the
+// column after the run, or zero if x is not on screen, so a line is
+// walked with:
+//
+//     for (int x = 0; (x = sngTermLineRun(t, y, x, &run, text, size)) != 0;)
+//
+// Run boundaries are kept as cells are written, so this never compares
+// cells.
+int sngTermLineRun(const SngTerm *t, int y, int x, SngTermRun *run, char *text, size_t textSize);
+
+// sngTermCopyText copies the text from x0,y0 through x1,y1 to buf as
+// UTF-8, in reading order as a selection would take it: the first and
+// last lines are partial, and the lines between are whole. Rows that
+// wrapped into the next are joined, other lines end with '\n' and lose
+// their trailing blanks.
+//
+// Like snprintf, it writes at most len-1 bytes, never splitting a
+// character, then a '\0' if len is nonzero, and returns the length of
+// the whole text.
+size_t sngTermCopyText(const SngTerm *t, int x0, int y0, int x1, int y1, char *buf, size_t len);
+
+// sngTermSearchSize returns the memory size of a SngTermSearch for
+// terminals of up to maxWidth by maxHeight.
+size_t sngTermSearchSize(int maxWidth, int maxHeight);
+
+// sngTermSearchInit initializes a search for len bytes of UTF-8 pattern
+// in memory, which must be aligned for pointers. Returns NULL if memory
+// is too small, or the pattern is empty or longer than
+// SNG_TERM_SEARCH_MAX characters.
+SngTermSearch *sngTermSearchInit(
+	void *memory, size_t memorySize,
+	int maxWidth, int maxHeight,
+	const char *pattern, size_t len
+);
+
+// sngTermSearch finds the pattern of s on t's screen, row by row from
+// the top, and stores up to matchesLen matches. Returns how many matches
+// there are, which may be more than were stored. Matches on a row do not
+// overlap, do not span rows, and ignore combining marks. The spacers of
+// wide characters are skipped, so a wide character is one character of
+// the pattern.
+//
+// With SNG_TERM_SEARCH_CHANGED, only rows written since the last search
+// of t with s are searched; rows that were only scrolled are not, so a
+// host watching output for a pattern sees a match again only if its
+// row is written to.
+int sngTermSearch(
+	SngTermSearch *s, const SngTerm *t, int flags,
+	SngTermMatch *matches, int matchesLen
+);
+
+// sngTermWrite updates t's state as it parses len bytes of UTF-8. Partial
+// UTF-8 sequences at the end of data are completed by the next call.
+void sngTermWrite(SngTerm *t, const void *data, size_t len);
+
+// sngTermSetAltAlloc sets the function used to allocate the alternate
+// screen of a terminal initialized without one. Once the application has
+// left the alternate screen for idleMs, sngTermReleaseIdle frees it.
+// Without a func, requests to switch to the alternate screen are ignored.
+void sngTermSetAltAlloc(SngTerm *t, SngTermAllocFunc func, void *user, u32 idleMs);
+
+// sngTermReleaseIdle frees the alternate screen if the application left
+// it at least idleMs ago, where nowMs is a monotonic time in milliseconds.
+// Call it periodically; the idle period is timed from the first call after
+// the switch back. Returns nonzero if the alternate screen was freed.
+b32 sngTermReleaseIdle(SngTerm *t, u64 nowMs);
+
+// sngTermFrameReady reports whether there are screen or title changes to
+// render, where nowMs is a monotonic time in milliseconds. Use it in place
+// of testing t->changed directly.
+//
+// While the application has a synchronized update open (mode 2026),
+// sngTermWrite moves changes out of t->changed and holds them until the
+// update ends, so a frame that arrives over several reads is rendered
+// once, whole. Output is never held. An update still open
+// SNG_TERM_SYNC_TIMEOUT after the first call that saw it is ended here.
+b32 sngTermFrameReady(SngTerm *t, u64 nowMs);
+
+// sngTermReleaseAlt frees the alternate screen now, switching back to the
+// main screen first if needed. Call it before freeing a terminal that was
+// initialized without an alternate screen.
+void sngTermReleaseAlt(SngTerm *t);
+
+// sngTermRelease returns all memory t holds from allocators and pools.
+// Call it before freeing t's memory.
+void sngTermRelease(SngTerm *t);
+
+// sngTermRowsHeld returns how many rows t holds from its SngTermRowPool.
+int sngTermRowsHeld(const SngTerm *t);
+
+// sngTermRowPoolSize returns the memory size of a SngTermRowPool holding
+// rows lines of up to maxWidth cells.
+size_t sngTermRowPoolSize(int maxWidth, int rows);
+
+// sngTermRowPoolInit initializes pool with as many lines of maxWidth
+// cells as fit in memory, which must be aligned for pointers. One line is
+// kept as the blank line all terminals share. Returns zero, leaving pool
+// unusable, if memory holds fewer than two lines.
+b32 sngTermRowPoolInit(SngTermRowPool *pool, void *memory, size_t memorySize, int maxWidth);
+
+// sngTermAltPoolInit initializes pool with as many alternate screens for
+// terminals of maxWidth by maxHeight as fit in memory, which must be
+// aligned for pointers.
+void sngTermAltPoolInit(
+	SngTermAltPool *pool,
+	void *memory, size_t memorySize,
+	int maxWidth, int maxHeight
+);
+
+// sngTermAltPoolAlloc is a SngTermAllocFunc that takes an alternate
+// screen from the SngTermAltPool passed as user.
+void *sngTermAltPoolAlloc(void *user, void *ptr, size_t size);
+
+// sngTermOutputPeek points data at output waiting to be written back to
+// the application, such as replies to device status requests, and
+// returns how many bytes are there. The output may be split in two, so
+// call it again after sngTermOutputConsume until it returns zero.
+// SNG_TERM_CHANGED_OUTPUT is set whenever output is added.
+size_t sngTermOutputPeek(const SngTerm *t, const char **data);
+
+// sngTermOutputConsume removes n bytes, as written by the host, from the
+// front of the output.
+void sngTermOutputConsume(SngTerm *t, size_t n);
+
+// sngTermOutputPut appends len bytes to the output, for the host's own
+// input encoding to share the same channel. Returns zero, and appends
+// nothing, if they do not fit.
+b32 sngTermOutputPut(SngTerm *t, const char *data, size_t len);
+
+// sngTermSetStrFunc sets the function that receives STR sequence
+// payloads. A NULL func disables it. Titles are handled regardless.
+void sngTermSetStrFunc(SngTerm *t, SngTermStrFunc func, void *user);
+
+// sngTermBase64Decode decodes len characters of base64 from src into
+// dest, carrying partial groups over in b, and returns how many bytes
+// were written. dest must have room for len*3/4 + 3 bytes. Padding and
+// characters outside the base64 alphabet are skipped.
+size_t sngTermBase64Decode(SngTermBase64 *b, const char *src, size_t len, u8 *dest);
+
+// sngTermCellMarks stores the combining marks of cell, in the order they
+// were put, in marks, and returns how many there are, up to two.
+int sngTermCellMarks(const SngTerm *t, const SngTermCell *cell, u32 *marks);
+
+// sngTermCharWidth returns how many cells codepoint takes: 0 for
+// combining marks and other zero width characters, 2 for East Asian wide
+// and fullwidth characters, and 1 otherwise. It does not depend on the C
+// library's locale.
+int sngTermCharWidth(u32 codepoint);
+
+// sngTermColorRGB stores the 0xRRGGBB value of a cell color in rgb, using
+// the xterm palette for the 256 indexed colors. Returns zero for
+// SNG_TERM_COLOR_DEFAULT_FG and SNG_TERM_COLOR_DEFAULT_BG, which are left
+// to the user.
+b32 sngTermColorRGB(const SngTerm *t, u16 color, u32 *rgb);
+
+// sngTermResolveColors stores in fg and bg the colors to draw each of len
+// cells with, for a terminal in mode. Cells keep the colors the
+// application set, and their attributes: here bold brightens the first
+// eight foreground colors, then SNG_TERM_ATTR_REVERSE swaps the colors,
+// as does SNG_TERM_MODE_REVERSE for the whole screen. So switching
+// reverse video only needs a redraw. Pass snap->mode for the cells of a
+// snapshot.
+void sngTermResolveColors(const SngTermCell *cells, int len, s32 mode, u16 *fg, u16 *bg);
+
+// sngTermSnapshotsSize returns the memory size of a SngTermSnapshots for
+// terminals of up to maxWidth by maxHeight. It holds three snapshots.
+size_t sngTermSnapshotsSize(int maxWidth, int maxHeight);
+
+// sngTermSnapshotsInit initializes memory, which must be aligned for
+// pointers, as a SngTermSnapshots. Returns NULL if memory is too small.
+//
+// One thread, the one writing to the terminal, publishes snapshots with
+// sngTermPublish, and one other thread renders them, taking the latest
+// with sngTermSnapshotAcquire. Neither ever waits for the other: there is
+// always a snapshot free to publish into, and snapshots the renderer is
+// too slow to take are replaced.
+SngTermSnapshots *sngTermSnapshotsInit(void *memory, size_t memorySize, int maxWidth, int maxHeight);
+
+// sngTermPublish copies t's screen into a snapshot and makes it the
+// latest, from the thread that writes to t. Only rows written since that
+// snapshot was last used are copied. A SngTermSnapshots may only be
+// published to from one terminal.
+void sngTermPublish(SngTermSnapshots *s, const SngTerm *t);
+
+// sngTermSnapshotAcquire returns the latest snapshot if one has been
+// published since the last call, or NULL. The snapshot it returns stays
+// unchanged until it returns another. snap->dirty marks the rows that
+// differ from that snapshot before.
+const SngTermSnapshot *sngTermSnapshotAcquire(SngTermSnapshots *s);
+
+// sngTermSnapshotLine returns the cells of line y of snap, with no lazily
+// cleared tail.
+const SngTermCell *sngTermSnapshotLine(const SngTermSnapshot *snap, int y);
+
+// sngTermSnapshotCellMarks is sngTermCellMarks for a cell of snap.
+int sngTermSnapshotCellMarks(const SngTermSnapshot *snap, const SngTermCell *cell, u32 *marks);
+
+// sngTermSnapshotColorRGB is sngTermColorRGB for a cell color of snap.
+b32 sngTermSnapshotColorRGB(const SngTermSnapshot *snap, u16 color, u32 *rgb);
+
+// sngTermSaveSize returns the most bytes sngTermSave needs for a terminal
+// of up to maxWidth by maxHeight.
+size_t sngTermSaveSize(int maxWidth, int maxHeight);
+
+// sngTermSave writes t's state to buf, for sngTermLoad to restore later:
+// both screens, the cursor, modes and tables, and the parser, even in the
+// middle of a sequence. Callbacks, allocators and output waiting in t are
+// not saved. The layout is that of this build on this machine, and is not
+// meant to be portable.
+//
+// Like snprintf, it writes at most len bytes, and returns how many the
+// whole state takes; buf is only usable if that is no more than len.
+size_t sngTermSave(const SngTerm *t, void *buf, size_t len);
+
+// sngTermLoad restores the state saved by sngTermSave into t, whose
+// maxWidth and maxHeight must hold the saved width and height, and marks
+// every row dirty. Rows a pooled terminal has no room for are left blank.
+// Returns zero, leaving t as it was, if data is not a whole save, its
+// tables or parser state are inconsistent, or it is on the alternate
+// screen and t cannot get one.
+b32 sngTermLoad(SngTerm *t, const void *data, size_t len);
+
+#ifdef SNG_TERM_DIAGNOSTICS
+// sngTermSetEventFunc sets the function called for diagnostic events. A
+// NULL func disables the callback, but events are still counted.
+void sngTermSetEventFunc(SngTerm *t, SngTermEventFunc func, void *user);
+
+// sngTermEventCount returns how many times event has occurred in t.
+u32 sngTermEventCount(const SngTerm *t, int event);
+
+// sngTermEventName returns a static, human readable name for event.
+const char *sngTermEventName(int event);
+#endif
+
+#ifdef SNG_TERM_STATS
+// sngTermGetStats copies t's counters to stats.
+void sngTermGetStats(const SngTerm *t, SngTermStats *stats);
+
+// sngTermResetStats zeroes t's counters, as when a host samples them
+// over intervals.
+void sngTermResetStats(SngTerm *t);
+
+#ifdef SNG_TERM_STATS_CYCLES
+// sngTermTimerName returns a static, human readable name for timer.
+const char *sngTermTimerName(int timer);
+#endif
+#endif
+
 #endif // SNG_TERMINAL_H
 
 
 #ifdef SNG_TERMINAL_IMPLEMENTATION
 
+#ifdef __SSE2__
+#include <emmintrin.h> // sngTermCopyText
+#endif
+
 enum {
 	_SNG_TERM_CURSOR_DEFAULT   = (1 << 0),
 	_SNG_TERM_CURSOR_WRAP_NEXT = (1 << 1),
@@ -159,13 +732,6 @@ enum {
 	_SNG_TERM_TAB_SPACES = 8,
 };
 
-typedef struct {
-	u32 codepoint;
-	u16 fg, bg;
-	u16 attr;
-	u8 _pad[2];
-} SngTermCell;
-
 typedef struct {
 	SngTermCell attr;
 	int x, y;
@@ -173,15 +739,45 @@ typedef struct {
 	u8 _pad[2];
 } SngTermCursor;
 
+// _SngTermLineInfo is stored in front of the cells of each line, so it
+// moves with the line when lines are scrolled or swapped.
+//
+// Clearing a line to its end only sets eraseX and erase. The cells from
+// eraseX onward hold stale data, and are only written out by
+// _sngTermLineFill once something needs them.
+//
+// seq changes whenever the line is modified, taking the next value of
+// SngTerm.rowSeq, and is zero for lines never written. Lines that only
+// move keep it.
+typedef struct {
+	int eraseX;
+	SngTermCell erase;
+	u32 seq;
+} _SngTermLineInfo;
+
+// _SngTermReflowLine is a line as the application wrote it, before it was
+// wrapped, gathered into scratch memory by sngTermSetSizeReflow.
+typedef struct {
+	int start, len;    // cells in scratch memory
+	SngTermCell erase; // blank tail of its last row
+} _SngTermReflowLine;
+
 // _SngTermCSI stores state for "Control Sequence Introducor"
 // sequences. (ESC+[)
+//
+// Parameters are accumulated as their digits arrive, so there is no
+// buffer to parse once the final character is reached.
 typedef struct {
-	char buf[256];
-	int bufLen;
-	int args[8];
+	int args[16];
 	int argsLen;
-	char mode;
-	b8 priv;
+	int arg;    // parameter being accumulated
+	u32 sub;    // bit i is set if args[i] followed a ':' rather than ';'
+	char mode;  // final character
+	char priv;  // private marker, usually '?'
+	char inter; // intermediate character, if any
+	char bad;   // first unparseable character, if any
+	b8 argOpen; // arg holds a parameter that has not been stored yet
+	b8 argSub;  // arg followed a ':'
 	u8 _pad[2];
 } _SngTermCSI;
 
@@ -195,7 +791,8 @@ typedef struct {
 	int bufLen;
 	char *args[8];
 	int argsLen;
-	u8 _pad[4];
+	b8 begun; // SngTermStrFunc has been called for this sequence
+	u8 _pad[3];
 } _SngTermSTR;
 
 typedef void (*_SngTermState)(SngTerm *, u32);
@@ -215,13 +812,137 @@ struct SngTerm {
 	b8 *tabs;
 	int tabsLen;
 	char title[256];
-	u8 _pad[4];
+	// rgb is an open addressed table of 24-bit colors. Used slots have
+	// 0x1000000 set, and empty slots are zero.
+	u32 rgb[SNG_TERM_RGB_TABLE_SIZE];
+	int rgbLen;
+	// markTable is an open addressed table of combining mark pairs, where
+	// the second is zero for a single mark, and cells refer to them by
+	// index+1. Empty slots are zero.
+	u32 markTable[SNG_TERM_MARKS_TABLE_SIZE][2];
+	int markTableLen;
+	u32 tableSeq; // changes whenever rgb or markTable does
+	u16 rgbSweepWait; // new colors to map to the cube before sweeping again
+	u16 marksSweepWait; // new marks to drop before sweeping again
+	u32 rowSeq; // last _SngTermLineInfo.seq given out
+	// output is a ring buffer, where outputHead and outputTail count bytes
+	// ever consumed and put.
+	char output[SNG_TERM_OUTPUT_SIZE];
+	u32 outputHead;
+	u32 outputTail;
+	// utf8 holds the bits of a partially decoded codepoint, and utf8Len
+	// how many continuation bytes it still needs.
+	u32 utf8;
+	int utf8Len;
+	SngTermStrFunc strFunc;
+	void *strUser;
+	// altMem is the alternate screen when it was allocated by altFunc,
+	// rather than laid out after the terminal.
+	void *altMem;
+	SngTermAllocFunc altFunc;
+	void *altUser;
+	u64 altIdleSince;
+	u64 syncSince;
+	u32 altIdleMs;
+	s32 syncChanged; // changes held back by a synchronized update
+	b8 altIdleTimed; // altIdleSince has been set since leaving
+	b8 syncTimed;    // syncSince has been set since the update began
+	u8 _pad[6];
+	// pool is set for terminals initialized with sngTermInitPooled.
+	SngTermRowPool *pool;
+	int rowsHeld;
+	int rowQuota;
+#ifdef SNG_TERM_DIAGNOSTICS
+	SngTermEventFunc eventFunc;
+	void *eventUser;
+	u32 events[(SNG_TERM_EVENT_COUNT + 1) & ~1]; // even, for alignment
+#endif
+#ifdef SNG_TERM_STATS
+	SngTermStats stats;
+#endif
 	union {
 		_SngTermCSI csi;
 		_SngTermSTR str;
 	};
 };
 
+#define _SNG_TERM_PTR_ALIGN (sizeof(void *) - 1)
+
+#define _SNG_TERM_SIZEOF_W(w) \
+	(((size_t)w + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+#define _SNG_TERM_SIZEOF_H(h) \
+	(((size_t)h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+#define _SNG_TERM_SIZEOF_TERM \
+	((sizeof(SngTerm) + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+#define _SNG_TERM_SIZEOF_LINES(w, h) \
+	((sizeof(SngTermCell *)*h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+// A line is its _SngTermLineInfo, its cells, then its run boundaries.
+#define _SNG_TERM_SIZEOF_RUNS(w) \
+	(sizeof(u32)*(((size_t)(w) + 31) / 32))
+
+#define _SNG_TERM_SIZEOF_LINE(w) \
+	(sizeof(_SngTermLineInfo) + sizeof(SngTermCell)*w + _SNG_TERM_SIZEOF_RUNS(w))
+
+#define _SNG_TERM_SIZEOF_LINES_DATA(w, h) \
+	((_SNG_TERM_SIZEOF_LINE(w)*h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+#define _SNG_TERM_SIZEOF_DIRTYLINES(h) \
+	((sizeof(b8)*h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+#define _SNG_TERM_SIZEOF_TABS(w) \
+	((sizeof(b8)*w + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+#ifdef SNG_TERM_DIAGNOSTICS
+static void _sngTermEvent(SngTerm *t, int event, int arg) {
+	t->events[event]++;
+	if (t->eventFunc) {
+		t->eventFunc(t->eventUser, t, event, arg);
+	}
+}
+#define _SNG_TERM_EVENT(t, event, arg) _sngTermEvent(t, event, arg)
+#else
+#define _SNG_TERM_EVENT(t, event, arg) ((void)0)
+#endif
+
+// _sngTermResolveColors stores the colors to draw cell with in fg and bg,
+// where screen is SNG_TERM_ATTR_REVERSE if the whole screen is reversed.
+// It has no branches, so mixed attributes cost no mispredictions.
+static void _sngTermResolveColors(const SngTermCell *cell, u32 screen, u16 *fg, u16 *bg) {
+	u32 f = cell->fg;
+	u32 b = cell->bg;
+	u32 attr = cell->attr;
+	f += (u32)((attr & SNG_TERM_ATTR_BOLD) != 0 && f < 8) << 3;
+	// all ones if the colors swap; SNG_TERM_ATTR_REVERSE is bit zero
+	u32 swap = 0u - ((attr ^ screen) & SNG_TERM_ATTR_REVERSE);
+	u32 x = (f ^ b) & swap;
+	*fg = (u16)(f ^ x);
+	*bg = (u16)(b ^ x);
+}
+
+// _SNG_TERM_STAT adds n to counter of t's stats.
+#ifdef SNG_TERM_STATS
+#define _SNG_TERM_STAT(t, counter, n) ((t)->stats.counter += (u64)(n))
+#else
+#define _SNG_TERM_STAT(t, counter, n) ((void)0)
+#endif
+
+// _SNG_TERM_TIMER_START and _SNG_TERM_TIMER_STOP time the code between
+// them, within one block, toward timer.
+#ifdef SNG_TERM_STATS_CYCLES
+#define _SNG_TERM_TIMER_START(t) u64 _sngTermTimerStart = SNG_TERM_STATS_CLOCK()
+#define _SNG_TERM_TIMER_STOP(t, timer) do { \
+	(t)->stats.cycles[timer] += SNG_TERM_STATS_CLOCK() - _sngTermTimerStart; \
+	(t)->stats.calls[timer]++; \
+} while (0)
+#else
+#define _SNG_TERM_TIMER_START(t) ((void)0)
+#define _SNG_TERM_TIMER_STOP(t, timer) ((void)0)
+#endif
+
 static int _sngTermClamp(int value, int min, int max) {
 	if (value < min) {
 		return min;
@@ -239,6 +960,13 @@ static int _sngTermMin(int a, int b) {
 	return b;
 }
 
+static int _sngTermMax(int a, int b) {
+	if (a > b) {
+		return a;
+	}
+	return b;
+}
+
 static b32 _sngTermBetween(int val, int min, int max) {
 	if (val < min || val > max) {
 		return 0;
@@ -273,80 +1001,416 @@ static void _sngTermRestoreCursor(SngTerm *t) {
 	_sngTermMoveTo(t, t->cur.x, t->cur.y);
 }
 
-static void _sngTermClear(SngTerm *t, int x0, int y0, int x1, int y1) {
-	if (x0 > x1) {
-		int tmp = x1;
-		x1 = x0;
-		x0 = tmp;
-	}
-	if (y0 > y1) {
-		int tmp = y1;
-		y1 = y0;
-		y0 = tmp;
-	}
-	x0 = _sngTermClamp(x0, 0, t->width-1);
-	x1 = _sngTermClamp(x1, 0, t->width-1);
-	y0 = _sngTermClamp(y0, 0, t->height-1);
-	y1 = _sngTermClamp(y1, 0, t->height-1);
-	t->changed |= SNG_TERM_CHANGED_SCREEN;
-	for (intptr_t y = y0; y <= y1; y++) {
-		t->dirtyLines[y] = 1;
-		for (intptr_t x = x0; x <= x1; x++) {
-			t->lines[y][x] = t->cur.attr;
-			t->lines[y][x].codepoint = ' ';
-		}
-	}
+static _SngTermLineInfo *_sngTermLineInfo(SngTermCell *line) {
+	return (_SngTermLineInfo *)(void *)((u8 *)line - sizeof(_SngTermLineInfo));
 }
 
-static void _sngTermClearAll(SngTerm *t) {
-	_sngTermClear(t, 0, 0, t->width-1, t->height-1);
+static const _SngTermLineInfo *_sngTermLineInfoConst(const SngTermCell *line) {
+	return (const _SngTermLineInfo *)(const void *)((const u8 *)line - sizeof(_SngTermLineInfo));
 }
 
-static void _sngTermDirtyAll(SngTerm *t) {
-	t->changed |= SNG_TERM_CHANGED_SCREEN;
-	for (intptr_t y = 0; y < t->height; y++) {
-		t->dirtyLines[y] = 1;
-	}
+static b32 _sngTermCellEqual(const SngTermCell *a, const SngTermCell *b) {
+	return
+		a->codepoint == b->codepoint &&
+		a->fg == b->fg &&
+		a->bg == b->bg &&
+		a->attr == b->attr &&
+		a->marks == b->marks;
 }
 
-static void _sngTermMoveTo(SngTerm *t, int x, int y) {
-	int miny, maxy;	
-	if (t->cur.state & _SNG_TERM_CURSOR_ORIGIN) {
-		miny = t->top;
-		maxy = t->bottom;
-	} else {
-		miny = 0;
-		maxy = t->height - 1;
-	}
-	t->changed |= SNG_TERM_CHANGED_SCREEN;
-	t->cur.state &= ~_SNG_TERM_CURSOR_WRAP_NEXT;
-	t->cur.x = _sngTermClamp(x, 0, t->width-1);
-	t->cur.y = _sngTermClamp(y, miny, maxy);
+// Each line has a bit per cell, after its cells, that is set where a run
+// of cells of one style begins, other than at column zero. The bits before
+// eraseX are kept up to date by calling _sngTermRunsUpdate, or
+// _sngTermRunsSpan, after writing cells.
+
+enum {
+	// _SNG_TERM_ATTR_NOT_STYLE are the attributes that do not end a run
+	_SNG_TERM_ATTR_NOT_STYLE =
+		SNG_TERM_ATTR_WRAP |
+		SNG_TERM_ATTR_GFX |
+		SNG_TERM_ATTR_WIDE |
+		SNG_TERM_ATTR_WIDE_SPACER,
+};
+
+// _sngTermStyleKey returns a number that is equal for cells of the same
+// style.
+static u64 _sngTermStyleKey(const SngTermCell *cell) {
+	u64 attr = cell->attr & (u16)~_SNG_TERM_ATTR_NOT_STYLE;
+	return (u64)cell->fg | (u64)cell->bg << 16 | attr << 32;
 }
 
-static void _sngTermMoveAbsTo(SngTerm *t, int x, int y) {
-	if (t->cur.state & _SNG_TERM_CURSOR_ORIGIN) {
-		y += t->top;
-	}
-	_sngTermMoveTo(t, x, y);
+static b32 _sngTermSameStyle(const SngTermCell *a, const SngTermCell *b) {
+	return _sngTermStyleKey(a) == _sngTermStyleKey(b);
 }
 
-static void _sngTermReset(SngTerm *t) {
-	t->cur = _sngTermDefaultCursor();
-	_sngTermSaveCursor(t);
-	for (intptr_t i = 0; i < t->tabsLen; i++) {
-		t->tabs[i] = 0;
+// _sngTermRowWidth returns how many cells each line has room for.
+static int _sngTermRowWidth(const SngTerm *t) {
+	if (t->pool != NULL) {
+		return t->pool->width;
 	}
-	for (intptr_t i = _SNG_TERM_TAB_SPACES; i < t->tabsLen; i += _SNG_TERM_TAB_SPACES) {
-		t->tabs[i] = 1;
-	}
-	t->top = 0;
-	t->bottom = t->height - 1;
-	_sngTermClearAll(t);
-	_sngTermMoveTo(t, 0, 0);
+	return (int)_SNG_TERM_SIZEOF_W(t->maxWidth);
 }
 
-static void _sngTermSetScroll(SngTerm *t, int top, int bottom) {
+static u32 *_sngTermLineRuns(const SngTerm *t, SngTermCell *line) {
+	return (u32 *)(void *)(line + _sngTermRowWidth(t));
+}
+
+static const u32 *_sngTermLineRunsConst(const SngTerm *t, const SngTermCell *line) {
+	return (const u32 *)(const void *)(line + _sngTermRowWidth(t));
+}
+
+// _sngTermRunsCompare recomputes the run boundaries from column x0
+// through x1, a word of bits at a time.
+static void _sngTermRunsCompare(u32 *runs, const SngTermCell *line, int x0, int x1) {
+	for (int x = _sngTermMax(x0, 1); x <= x1;) {
+		int last = _sngTermMin(x1, x | 31);
+		u32 bits = 0;
+		u64 prev = _sngTermStyleKey(&line[x-1]);
+		for (int i = x; i <= last; i++) {
+			u64 key = _sngTermStyleKey(&line[i]);
+			bits |= (u32)(key != prev) << (i & 31);
+			prev = key;
+		}
+		u32 mask = (~0u << (x & 31)) & (~0u >> (31 - (last & 31)));
+		runs[x >> 5] = (runs[x >> 5] & ~mask) | bits;
+		x = last + 1;
+	}
+}
+
+// _sngTermRunsUpdate recomputes the run boundaries of line after cells x0
+// through x1-1 were written, including the one at x1.
+static void _sngTermRunsUpdate(SngTerm *t, SngTermCell *line, int x0, int x1) {
+	int end = _sngTermMin(x1, _sngTermLineInfo(line)->eraseX - 1);
+	_sngTermRunsCompare(_sngTermLineRuns(t, line), line, x0, end);
+}
+
+// _sngTermRunsBit recomputes the single run boundary at x, which must be
+// greater than zero.
+static void _sngTermRunsBit(u32 *runs, const SngTermCell *line, int x) {
+	u32 bit = 1u << (x & 31);
+	u32 diff = (u32)(_sngTermStyleKey(&line[x-1]) != _sngTermStyleKey(&line[x])) << (x & 31);
+	runs[x >> 5] = (runs[x >> 5] & ~bit) | diff;
+}
+
+// _sngTermRunsCell is _sngTermRunsUpdate for the single cell at x.
+static void _sngTermRunsCell(SngTerm *t, SngTermCell *line, int x) {
+	u32 *runs = _sngTermLineRuns(t, line);
+	if (x > 0) {
+		_sngTermRunsBit(runs, line, x);
+	}
+	if (x+1 < _sngTermLineInfo(line)->eraseX) {
+		_sngTermRunsBit(runs, line, x+1);
+	}
+}
+
+// _sngTermRunsSpan is _sngTermRunsUpdate for cells that were all written
+// in one style, so only the boundaries at either end need comparing.
+static void _sngTermRunsSpan(SngTerm *t, SngTermCell *line, int x0, int x1) {
+	u32 *runs = _sngTermLineRuns(t, line);
+	int end = _sngTermMin(x1, _sngTermLineInfo(line)->eraseX - 1);
+	for (int x = x0+1; x <= end;) {
+		int last = _sngTermMin(end, x | 31);
+		u32 mask = (~0u << (x & 31)) & (~0u >> (31 - (last & 31)));
+		runs[x >> 5] &= ~mask;
+		x = last + 1;
+	}
+	if (x0 > 0 && x0 <= end) {
+		_sngTermRunsBit(runs, line, x0);
+	}
+	if (x1 > x0 && x1 <= end) {
+		_sngTermRunsBit(runs, line, x1);
+	}
+}
+
+// _sngTermBitsGet returns n bits, at most 32, of bits from x on.
+static u32 _sngTermBitsGet(const u32 *bits, int x, int n) {
+	u64 word = bits[x >> 5];
+	if ((x & 31) + n > 32) {
+		word |= (u64)bits[(x >> 5) + 1] << 32;
+	}
+	word >>= x & 31;
+	return (u32)word & (n == 32 ? ~0u : (1u << n) - 1);
+}
+
+// _sngTermBitsPut sets n bits, at most 32 and all in one word, of bits
+// from x on.
+static void _sngTermBitsPut(u32 *bits, int x, int n, u32 value) {
+	u32 mask = (n == 32 ? ~0u : (1u << n) - 1) << (x & 31);
+	bits[x >> 5] = (bits[x >> 5] & ~mask) | (value << (x & 31));
+}
+
+// _sngTermBitsCopy copies n bits of src from srcX on to dst from dstX on.
+static void _sngTermBitsCopy(u32 *dst, int dstX, const u32 *src, int srcX, int n) {
+	int k = _sngTermMin(n, (32 - (dstX & 31)) & 31);
+	if (k > 0) {
+		_sngTermBitsPut(dst, dstX, k, _sngTermBitsGet(src, srcX, k));
+		dstX += k;
+		srcX += k;
+		n -= k;
+	}
+	// whole words of dst
+	int shift = srcX & 31;
+	const u32 *p = &src[srcX >> 5];
+	u32 *q = &dst[dstX >> 5];
+	for (; n >= 32; n -= 32, p++, q++) {
+		*q = shift == 0 ? p[0] : (p[0] >> shift) | (p[1] << (32 - shift));
+	}
+	if (n > 0) {
+		_sngTermBitsPut(q, 0, n, _sngTermBitsGet(p, shift, n));
+	}
+}
+
+// _sngTermBitsMove copies n bits of bits from srcX on to dstX on, where
+// the two may overlap.
+static void _sngTermBitsMove(u32 *bits, int dstX, int srcX, int n) {
+	if (dstX <= srcX) {
+		_sngTermBitsCopy(bits, dstX, bits, srcX, n);
+		return;
+	}
+	// from the end, so no bits are overwritten before they are read
+	while (n > 0) {
+		int k = _sngTermMin(n, ((dstX + n - 1) & 31) + 1);
+		n -= k;
+		_sngTermBitsCopy(bits, dstX + n, bits, srcX + n, k);
+	}
+}
+
+// _sngTermRunsNext returns the first run boundary from column x0 on,
+// or x1 if there is none before it.
+static int _sngTermRunsNext(const u32 *runs, int x0, int x1) {
+	for (int x = x0; x < x1;) {
+		u32 word = runs[x >> 5] >> (x & 31);
+		if (word != 0) {
+			while ((word & 1) == 0) {
+				word >>= 1;
+				x++;
+			}
+			return _sngTermMin(x, x1);
+		}
+		x = (x | 31) + 1;
+	}
+	return x1;
+}
+
+// _sngTermLineFill writes out the lazily cleared cells of line before
+// column x, so they may be read or modified directly.
+static void _sngTermLineFill(SngTerm *t, SngTermCell *line, int x) {
+	_SngTermLineInfo *info = _sngTermLineInfo(line);
+	int eraseX = info->eraseX;
+	x = _sngTermMin(x, t->width);
+	for (intptr_t i = eraseX; i < x; i++) {
+		line[i] = info->erase;
+	}
+	if (x > eraseX) {
+		info->eraseX = x;
+		_sngTermRunsSpan(t, line, eraseX, x);
+	}
+}
+
+static b32 _sngTermLineShared(const SngTerm *t, const SngTermCell *line) {
+	return t->pool != NULL && line == t->pool->blank;
+}
+
+// _sngTermLineOwn returns line y, ready to be modified. A line sharing the
+// pool's blank row first gets a row of its own. Returns NULL if there is
+// no row to be had, in which case the output is dropped.
+static SngTermCell *_sngTermLineOwn(SngTerm *t, intptr_t y) {
+	SngTermCell *line = t->lines[y];
+	if (!_sngTermLineShared(t, line)) {
+		_sngTermLineInfo(line)->seq = ++t->rowSeq;
+		return line;
+	}
+	SngTermRowPool *pool = t->pool;
+	void **row = NULL;
+	if (t->rowsHeld < t->rowQuota) {
+		SNG_TERM_POOL_LOCK(pool);
+		row = (void **)pool->free;
+		if (row != NULL) {
+			pool->free = *row;
+			pool->rowsFree--;
+		}
+		SNG_TERM_POOL_UNLOCK(pool);
+	}
+	if (row == NULL) {
+		_SNG_TERM_EVENT(t, SNG_TERM_EVENT_NO_ROW, (int)y);
+		return NULL;
+	}
+	t->rowsHeld++;
+	line = (SngTermCell *)(void *)((u8 *)row + sizeof(_SngTermLineInfo));
+	*_sngTermLineInfo(line) = *_sngTermLineInfo(pool->blank);
+	_sngTermLineInfo(line)->seq = ++t->rowSeq;
+	t->lines[y] = line;
+	return line;
+}
+
+// _sngTermLineDisown returns line y to the pool, sharing the blank row.
+static void _sngTermLineDisown(SngTerm *t, intptr_t y) {
+	SngTermCell *line = t->lines[y];
+	if (_sngTermLineShared(t, line)) {
+		return;
+	}
+	SngTermRowPool *pool = t->pool;
+	void **row = (void **)(void *)_sngTermLineInfo(line);
+	SNG_TERM_POOL_LOCK(pool);
+	*row = pool->free;
+	pool->free = row;
+	pool->rowsFree++;
+	SNG_TERM_POOL_UNLOCK(pool);
+	t->rowsHeld--;
+	t->lines[y] = pool->blank;
+}
+
+static void _sngTermClear(SngTerm *t, int x0, int y0, int x1, int y1) {
+	if (x0 > x1) {
+		int tmp = x1;
+		x1 = x0;
+		x0 = tmp;
+	}
+	if (y0 > y1) {
+		int tmp = y1;
+		y1 = y0;
+		y0 = tmp;
+	}
+	x0 = _sngTermClamp(x0, 0, t->width-1);
+	x1 = _sngTermClamp(x1, 0, t->width-1);
+	y0 = _sngTermClamp(y0, 0, t->height-1);
+	y1 = _sngTermClamp(y1, 0, t->height-1);
+	// Erased cells take the background color, even in reverse video. Set
+	// field by field, as patching attr after copying the cell stalls the
+	// wide loads comparing it below.
+	SngTermCell blank;
+	blank.codepoint = ' ';
+	blank.fg = t->cur.attr.fg;
+	blank.bg = t->cur.attr.bg;
+	blank.attr = t->cur.attr.attr & (u16)~SNG_TERM_ATTR_REVERSE;
+	blank.marks = t->cur.attr.marks;
+	t->changed |= SNG_TERM_CHANGED_SCREEN;
+	_SNG_TERM_STAT(t, cellsCleared, (x1-x0+1) * (y1-y0+1));
+	b32 poolBlank =
+		t->pool != NULL &&
+		x0 == 0 && x1 == t->width-1 &&
+		_sngTermCellEqual(&_sngTermLineInfo(t->pool->blank)->erase, &blank);
+	for (intptr_t y = y0; y <= y1; y++) {
+		SngTermCell *line = t->lines[y];
+		_SngTermLineInfo *info = _sngTermLineInfo(line);
+		b32 sameBlank = _sngTermCellEqual(&info->erase, &blank);
+		t->dirtyLines[y] = 1;
+		if (x0 >= info->eraseX && sameBlank) {
+			// already blank
+			continue;
+		}
+		if (poolBlank) {
+			_sngTermLineDisown(t, y);
+			continue;
+		}
+		line = _sngTermLineOwn(t, y);
+		if (line == NULL) {
+			continue;
+		}
+		info = _sngTermLineInfo(line);
+		if (x1 == t->width-1) {
+			// clear to the end of the line, lazily
+			if (x0 > info->eraseX) {
+				_sngTermLineFill(t, line, x0);
+			}
+			info->eraseX = x0;
+			info->erase = blank;
+			continue;
+		}
+		_sngTermLineFill(t, line, x1+1);
+		for (intptr_t x = x0; x <= x1; x++) {
+			line[x] = blank;
+		}
+		_sngTermRunsSpan(t, line, x0, x1+1);
+	}
+}
+
+// _sngTermClearAll clears the screen. On the main screen, whatever colors
+// and marks it held are now likely free, and the alternate screen was
+// cleared when it was left, so a full table is swept on the next new
+// entry rather than after the usual wait. On the alternate screen the
+// main screen may still hold the tables full, so the waits stand.
+static void _sngTermClearAll(SngTerm *t) {
+	_sngTermClear(t, 0, 0, t->width-1, t->height-1);
+	if (!(t->mode & SNG_TERM_MODE_ALT_SCREEN)) {
+		t->rgbSweepWait = 0;
+		t->marksSweepWait = 0;
+	}
+}
+
+static void _sngTermDirtyAll(SngTerm *t) {
+	t->changed |= SNG_TERM_CHANGED_SCREEN;
+	for (intptr_t y = 0; y < t->height; y++) {
+		t->dirtyLines[y] = 1;
+	}
+}
+
+static void _sngTermMoveTo(SngTerm *t, int x, int y) {
+	int miny, maxy;	
+	if (t->cur.state & _SNG_TERM_CURSOR_ORIGIN) {
+		miny = t->top;
+		maxy = t->bottom;
+	} else {
+		miny = 0;
+		maxy = t->height - 1;
+	}
+	t->changed |= SNG_TERM_CHANGED_SCREEN;
+	t->cur.state &= (u16)~_SNG_TERM_CURSOR_WRAP_NEXT;
+	t->cur.x = _sngTermClamp(x, 0, t->width-1);
+	t->cur.y = _sngTermClamp(y, miny, maxy);
+}
+
+static void _sngTermMoveAbsTo(SngTerm *t, int x, int y) {
+	if (t->cur.state & _SNG_TERM_CURSOR_ORIGIN) {
+		y += t->top;
+	}
+	_sngTermMoveTo(t, x, y);
+}
+
+// _sngTermSyncHold moves changes made during a synchronized update out
+// of t->changed, where the renderer would see them.
+static void _sngTermSyncHold(SngTerm *t) {
+	if (t->mode & SNG_TERM_MODE_SYNC) {
+		t->syncChanged |= t->changed & ~SNG_TERM_CHANGED_OUTPUT;
+		t->changed &= SNG_TERM_CHANGED_OUTPUT;
+	}
+}
+
+// _sngTermSyncEnd ends a synchronized update, and hands over the changes
+// it held.
+static void _sngTermSyncEnd(SngTerm *t) {
+	t->mode &= ~SNG_TERM_MODE_SYNC;
+	t->changed |= t->syncChanged;
+	t->syncChanged = 0;
+	t->syncTimed = 0;
+}
+
+static void _sngTermSweepTables(SngTerm *t);
+
+static void _sngTermReset(SngTerm *t) {
+	_sngTermSyncEnd(t);
+	t->cur = _sngTermDefaultCursor();
+	_sngTermSaveCursor(t);
+	for (intptr_t i = 0; i < t->tabsLen; i++) {
+		t->tabs[i] = 0;
+	}
+	for (intptr_t i = _SNG_TERM_TAB_SPACES; i < t->tabsLen; i += _SNG_TERM_TAB_SPACES) {
+		t->tabs[i] = 1;
+	}
+	t->top = 0;
+	t->bottom = t->height - 1;
+	_sngTermClearAll(t);
+	_sngTermMoveTo(t, 0, 0);
+	// Free the colors and marks of the cleared screen now, rather than
+	// when the tables fill. The alternate screen was cleared when it was
+	// left, so this is cheap, but the main screen behind the alternate one
+	// may be full, and is left for that sweep to read.
+	if (!(t->mode & SNG_TERM_MODE_ALT_SCREEN) && (t->rgbLen > 0 || t->markTableLen > 0)) {
+		_sngTermSweepTables(t);
+	}
+}
+
+static void _sngTermSetScroll(SngTerm *t, int top, int bottom) {
 	top = _sngTermClamp(top, 0, t->height-1);
 	bottom = _sngTermClamp(bottom, 0, t->height-1);
 	if (top > bottom) {
@@ -359,19 +1423,26 @@ static void _sngTermSetScroll(SngTerm *t, int top, int bottom) {
 }
 
 static void _sngTermScrollDown(SngTerm *t, int orig, int n) {
+	_SNG_TERM_TIMER_START(t);
 	n = _sngTermClamp(n, 0, t->bottom-orig+1);
+	_SNG_TERM_STAT(t, scrolls, 1);
+	_SNG_TERM_STAT(t, linesScrolled, n);
 	_sngTermClear(t, 0, t->bottom-n+1, t->width-1, t->bottom);
 	for (intptr_t i = t->bottom; i >= orig+n; i--) {
 		SngTermCell *tmp = t->lines[i];
-		t->lines[i] = t->lines[i+n];
-		t->lines[i+n] = tmp;
+		t->lines[i] = t->lines[i-n];
+		t->lines[i-n] = tmp;
 		t->dirtyLines[i] = 1;
-		t->dirtyLines[i+n] = 1;
+		t->dirtyLines[i-n] = 1;
 	}
+	_SNG_TERM_TIMER_STOP(t, SNG_TERM_TIMER_SCROLL);
 }
 
 static void _sngTermScrollUp(SngTerm *t, int orig, int n) {
+	_SNG_TERM_TIMER_START(t);
 	n = _sngTermClamp(n, 0, t->bottom-orig+1);
+	_SNG_TERM_STAT(t, scrolls, 1);
+	_SNG_TERM_STAT(t, linesScrolled, n);
 	_sngTermClear(t, 0, orig, t->width-1, orig+n-1);
 	for (intptr_t i = orig; i <= t->bottom-n; i++) {
 		SngTermCell *tmp = t->lines[i];
@@ -380,6 +1451,7 @@ static void _sngTermScrollUp(SngTerm *t, int orig, int n) {
 		t->dirtyLines[i] = 1;
 		t->dirtyLines[i+n] = 1;
 	}
+	_SNG_TERM_TIMER_STOP(t, SNG_TERM_TIMER_SCROLL);
 }
 
 static void _sngTermSwapScreen(SngTerm *t) {
@@ -387,9 +1459,41 @@ static void _sngTermSwapScreen(SngTerm *t) {
 	t->lines = t->altLines;
 	t->altLines = tmp_lines;
 	t->mode ^= SNG_TERM_MODE_ALT_SCREEN;
+	t->altIdleTimed = 0;
 	_sngTermDirtyAll(t);
 }
 
+static void _sngTermInitLines(SngTermCell **lines, void *data, size_t w, size_t h);
+
+// _sngTermAcquireAlt makes sure the alternate screen exists, allocating it
+// if t was initialized without one. Returns zero if it is unavailable.
+static b32 _sngTermAcquireAlt(SngTerm *t) {
+	if (t->altLines != NULL) {
+		return 1;
+	}
+	if (t->altFunc == NULL) {
+		return 0;
+	}
+	size_t size = sngTermAltAllocSize(t->maxWidth, t->maxHeight);
+	void *mem = t->altFunc(t->altUser, NULL, size);
+	if (mem == NULL) {
+		return 0;
+	}
+	memset(mem, 0, size);
+	size_t w = _SNG_TERM_SIZEOF_W(t->maxWidth);
+	size_t h = _SNG_TERM_SIZEOF_H(t->maxHeight);
+	t->altMem = mem;
+	t->altLines = (SngTermCell **)mem;
+	_sngTermInitLines(t->altLines, (u8 *)mem + _SNG_TERM_SIZEOF_LINES(w, h), w, h);
+	// Blank every line with an erase marker rather than writing the cells.
+	SngTermCell blank = _sngTermDefaultCursor().attr;
+	blank.codepoint = ' ';
+	for (size_t y = 0; y < h; y++) {
+		_sngTermLineInfo(t->altLines[y])->erase = blank;
+	}
+	return 1;
+}
+
 static void _sngTermPutTab(SngTerm *t, b32 forward) {
 	int x = t->cur.x;
 	if (forward) {
@@ -438,11 +1542,13 @@ static void _sngTermInsertBlanks(SngTerm *t, int n) {
 	if (dst >= t->width) {
 		_sngTermClear(t, t->cur.x, t->cur.y, t->width-1, t->cur.y);
 	} else {
-		memmove(
-			&t->lines[t->cur.y][dst],
-			&t->lines[t->cur.y][src],
-			(u32)size * sizeof(t->lines[0][0])
-		);
+		SngTermCell *line = _sngTermLineOwn(t, t->cur.y);
+		if (line == NULL) {
+			return;
+		}
+		_sngTermLineFill(t, line, t->width);
+		memmove(&line[dst], &line[src], (u32)size * sizeof(line[0]));
+		_sngTermBitsMove(_sngTermLineRuns(t, line), dst+1, src+1, size-1);
 		_sngTermClear(t, src, t->cur.y, dst-1, t->cur.y);
 	}
 }
@@ -471,7 +1577,14 @@ static void _sngTermDeleteChars(SngTerm *t, int n) {
 	if (src >= t->width) {
 		_sngTermClear(t, t->cur.x, t->cur.y, t->width-1, t->cur.y);
 	} else {
-		memmove(&t->lines[t->cur.y][dst], &t->lines[t->cur.y][src], size * sizeof(t->lines[0][0]));
+		SngTermCell *line = _sngTermLineOwn(t, t->cur.y);
+		if (line == NULL) {
+			return;
+		}
+		_sngTermLineFill(t, line, t->width);
+		memmove(&line[dst], &line[src], size * sizeof(line[0]));
+		_sngTermBitsMove(_sngTermLineRuns(t, line), dst+1, src+1, (int)size-1);
+		_sngTermRunsUpdate(t, line, dst, dst);
 		_sngTermClear(t, t->width-n, t->cur.y, t->width-1, t->cur.y);
 	}
 }
@@ -497,7 +1610,8 @@ static void _sngTermSetMode(SngTerm *t, b32 priv, b32 set, int *args, int argsLe
 					s32 mode = t->mode;
 					_sngTermModMode(t, set, SNG_TERM_MODE_REVERSE);
 					if (mode != t->mode) {
-						// TODO: redraw
+						// colors are resolved as they are drawn
+						_sngTermDirtyAll(t);
 					}
 				} break;
 				// DECOM - origin
@@ -505,7 +1619,7 @@ static void _sngTermSetMode(SngTerm *t, b32 priv, b32 set, int *args, int argsLe
 					if (set) {
 						t->cur.state |= _SNG_TERM_CURSOR_ORIGIN;
 					} else {
-						t->cur.state &= ~(_SNG_TERM_CURSOR_ORIGIN);
+						t->cur.state &= (u16)~(_SNG_TERM_CURSOR_ORIGIN);
 					}
 					_sngTermMoveAbsTo(t, 0, 0);
 				} break;
@@ -563,10 +1677,14 @@ static void _sngTermSetMode(SngTerm *t, b32 priv, b32 set, int *args, int argsLe
 				case 1047:
 				case 1049: {
 					b32 alt = ((t->mode & SNG_TERM_MODE_ALT_SCREEN) != 0);
+					if (set && !alt && !_sngTermAcquireAlt(t)) {
+						_SNG_TERM_EVENT(t, SNG_TERM_EVENT_NO_ALT_SCREEN, args[i]);
+						break;
+					}
 					if (alt) {
 						_sngTermClear(t, 0, 0, t->width-1, t->height-1);
 					}
-					if (!set || !alt) {
+					if (set != alt) {
 						_sngTermSwapScreen(t);
 					}
 					if (args[i] != 1049) {
@@ -580,6 +1698,14 @@ static void _sngTermSetMode(SngTerm *t, b32 priv, b32 set, int *args, int argsLe
 						_sngTermRestoreCursor(t);
 					}
 				} break;
+				// synchronized update; see sngTermFrameReady
+				case 2026: {
+					if (set) {
+						t->mode |= SNG_TERM_MODE_SYNC;
+					} else {
+						_sngTermSyncEnd(t);
+					}
+				} break;
 				// mouse highlight mode; can hang the terminal by design when
 				// implemented
 				case 1001: {
@@ -593,7 +1719,7 @@ static void _sngTermSetMode(SngTerm *t, b32 priv, b32 set, int *args, int argsLe
 				case 1015: {
 				} break;
 				default: {
-					fprintf(stderr, "unknown private set/reset mode %d\n", args[i]);
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_PRIVATE_MODE, args[i]);
 				} break;
 			}
 		}
@@ -609,7 +1735,6 @@ static void _sngTermSetMode(SngTerm *t, b32 priv, b32 set, int *args, int argsLe
 				// IRM - insert-replacement
 				case 4: {
 					_sngTermModMode(t, set, SNG_TERM_MODE_INSERT);
-					fprintf(stderr, "SNG_TERM_MODE_INSERT not implemented\n");
 				} break;
 				// SRM - send/receive
 				case 12: {
@@ -619,21 +1744,249 @@ static void _sngTermSetMode(SngTerm *t, b32 priv, b32 set, int *args, int argsLe
 				case 20: {
 					_sngTermModMode(t, set, SNG_TERM_MODE_CRLF);
 				} break;
-				case 34: {
-					fprintf(stderr, "right-to-left mode not implemented\n");
-				} break;
+				// right-to-left, right-to-left copy
+				case 34:
 				case 96: {
-					fprintf(stderr, "right-to-left copy mode not implemented\n");
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNSUPPORTED_MODE, args[i]);
 				} break;
 				default: {
-					fprintf(stderr, "unknown set/reset mode %d\n", args[i]);
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_MODE, args[i]);
 				} break;
 			}
 		}
 	}
 }
 
-static void _sngTermSetAttr(SngTerm *t, int *args, int argsLen) {
+static const u32 _sngTermPalette16[16] = {
+	0x000000, 0xcd0000, 0x00cd00, 0xcdcd00,
+	0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+	0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00,
+	0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff,
+};
+
+static const u8 _sngTermCubeLevels[6] = {0, 95, 135, 175, 215, 255};
+
+static u32 _sngTermPaletteRGB(u32 i) {
+	if (i < 16) {
+		return _sngTermPalette16[i];
+	}
+	if (i < 232) {
+		i -= 16;
+		return
+			((u32)_sngTermCubeLevels[i / 36] << 16) |
+			((u32)_sngTermCubeLevels[(i / 6) % 6] << 8) |
+			(u32)_sngTermCubeLevels[i % 6];
+	}
+	u32 grey = 8 + (i - 232) * 10;
+	return (grey << 16) | (grey << 8) | grey;
+}
+
+static u32 _sngTermCubeIndex(u32 v) {
+	if (v < 48) {
+		return 0;
+	}
+	if (v < 115) {
+		return 1;
+	}
+	return (v - 35) / 40;
+}
+
+// _sngTermNearestColor maps rgb to the nearest color in the 6x6x6 cube
+// of the 256 color palette.
+static u16 _sngTermNearestColor(u32 rgb) {
+	u32 r = _sngTermCubeIndex((rgb >> 16) & 0xff);
+	u32 g = _sngTermCubeIndex((rgb >> 8) & 0xff);
+	u32 b = _sngTermCubeIndex(rgb & 0xff);
+	return (u16)(16 + r * 36 + g * 6 + b);
+}
+
+// _sngTermSweepUse marks the rgb and marks table slots cell refers to.
+static void _sngTermSweepUse(const SngTermCell *cell, u32 *rgbUsed, u32 *marksUsed) {
+	u16 colors[2] = {cell->fg, cell->bg};
+	for (size_t i = 0; i < 2; i++) {
+		if ((colors[i] & SNG_TERM_COLOR_RGB_FLAG) && colors[i] < 0xff00) {
+			u32 slot = colors[i] & (SNG_TERM_RGB_TABLE_SIZE - 1);
+			rgbUsed[slot / 32] |= 1u << (slot % 32);
+		}
+	}
+	if (cell->marks != 0) {
+		u32 slot = (u32)(cell->marks - 1) & (SNG_TERM_MARKS_TABLE_SIZE - 1);
+		marksUsed[slot / 32] |= 1u << (slot % 32);
+	}
+}
+
+// _sngTermSweepTables empties the slots of t's rgb and marks tables that
+// no cell of either screen, nor the cursor, refers to. Cells refer to
+// slots by index, so the rest stay where they are. An entry whose probe
+// sequence passed through a freed slot may be added again elsewhere,
+// which costs a slot but is otherwise harmless.
+static void _sngTermSweepTables(SngTerm *t) {
+	u32 rgbUsed[(SNG_TERM_RGB_TABLE_SIZE + 31) / 32];
+	u32 marksUsed[(SNG_TERM_MARKS_TABLE_SIZE + 31) / 32];
+	memset(rgbUsed, 0, sizeof(rgbUsed));
+	memset(marksUsed, 0, sizeof(marksUsed));
+	_sngTermSweepUse(&t->cur.attr, rgbUsed, marksUsed);
+	_sngTermSweepUse(&t->cur_saved.attr, rgbUsed, marksUsed);
+	SngTermCell **screens[2] = {t->lines, t->altLines};
+	for (size_t s = 0; s < 2; s++) {
+		if (screens[s] == NULL) {
+			continue;
+		}
+		for (intptr_t y = 0; y < t->maxHeight; y++) {
+			const SngTermCell *line = screens[s][y];
+			const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+			_sngTermSweepUse(&info->erase, rgbUsed, marksUsed);
+			int eraseX = _sngTermMin(info->eraseX, t->maxWidth);
+			for (intptr_t x = 0; x < eraseX; x++) {
+				_sngTermSweepUse(&line[x], rgbUsed, marksUsed);
+			}
+		}
+	}
+	b32 freed = 0;
+	for (u32 i = 0; i < SNG_TERM_RGB_TABLE_SIZE; i++) {
+		if (t->rgb[i] != 0 && (rgbUsed[i / 32] & (1u << (i % 32))) == 0) {
+			t->rgb[i] = 0;
+			t->rgbLen--;
+			freed = 1;
+		}
+	}
+	for (u32 i = 0; i < SNG_TERM_MARKS_TABLE_SIZE; i++) {
+		if (t->markTable[i][0] != 0 && (marksUsed[i / 32] & (1u << (i % 32))) == 0) {
+			t->markTable[i][0] = 0;
+			t->markTable[i][1] = 0;
+			t->markTableLen--;
+			freed = 1;
+		}
+	}
+	if (freed) {
+		t->tableSeq++;
+	}
+}
+
+// _sngTermSweepDue reports whether a full table should be swept, where
+// wait counts the requests to turn away first.
+static b32 _sngTermSweepDue(u16 *wait) {
+	if (*wait > 0) {
+		(*wait)--;
+		return 0;
+	}
+	return 1;
+}
+
+// _sngTermSweepBackoff returns the wait after a sweep that freed little,
+// for a table of tableSize slots. A sweep reads every cell of both
+// screens, so the wait grows with them, to keep the cost at a few cells
+// per request however short the requests are.
+static u16 _sngTermSweepBackoff(const SngTerm *t, int tableSize) {
+	return (u16)_sngTermClamp(t->maxWidth * t->maxHeight / 16, tableSize/8, 0xffff);
+}
+
+// _sngTermRGBColor returns a cell color for the 24-bit color rgb, adding
+// it to t's table if needed. When the table is full, colors no longer on
+// either screen are swept out to make room.
+static u16 _sngTermRGBColor(SngTerm *t, u32 rgb) {
+	u32 key = rgb | 0x1000000;
+	u32 mask = SNG_TERM_RGB_TABLE_SIZE - 1;
+	u32 i = (rgb * 0x9e3779b1u) >> 20;
+	for (;;) {
+		i &= mask;
+		if (t->rgb[i] == key) {
+			return (u16)(SNG_TERM_COLOR_RGB_FLAG | i);
+		}
+		if (t->rgb[i] == 0) {
+			break;
+		}
+		i++;
+	}
+	// keep a quarter of the table empty so probes stay short
+	int full = SNG_TERM_RGB_TABLE_SIZE - SNG_TERM_RGB_TABLE_SIZE/4;
+	if (t->rgbLen >= full) {
+		if (!_sngTermSweepDue(&t->rgbSweepWait)) {
+			return _sngTermNearestColor(rgb);
+		}
+		_sngTermSweepTables(t);
+		if (t->rgbLen > full - SNG_TERM_RGB_TABLE_SIZE/8) {
+			t->rgbSweepWait = _sngTermSweepBackoff(t, SNG_TERM_RGB_TABLE_SIZE);
+		}
+		if (t->rgbLen >= full) {
+			return _sngTermNearestColor(rgb);
+		}
+		return _sngTermRGBColor(t, rgb);
+	}
+	t->rgb[i] = key;
+	t->rgbLen++;
+	t->tableSeq++;
+	return (u16)(SNG_TERM_COLOR_RGB_FLAG | i);
+}
+
+// _sngTermSubArgs returns how many colon separated sub-parameters
+// follow args[i].
+static intptr_t _sngTermSubArgs(u32 sub, int argsLen, intptr_t i) {
+	intptr_t n = 0;
+	while (i+n+1 < argsLen && (sub & (1u << (i+n+1))) != 0) {
+		n++;
+	}
+	return n;
+}
+
+// _sngTermParseColor parses the arguments of SGR 38 or 48 at args[*i],
+// and advances *i past them. Both the ';' form, and the ':' form with an
+// optional color space id (38:2::r:g:b) are accepted. Returns zero on
+// bad input.
+static b32 _sngTermParseColor(
+	SngTerm *t,
+	int *args, int argsLen, u32 sub,
+	intptr_t *i,
+	u16 *color
+) {
+	intptr_t subs = _sngTermSubArgs(sub, argsLen, *i);
+	if (subs > 0) {
+		int *a = &args[*i+1];
+		*i += subs;
+		if (a[0] == 5 && subs >= 2 && _sngTermBetween(a[1], 0, 255)) {
+			*color = (u16)a[1];
+			return 1;
+		}
+		if (a[0] == 2 && subs >= 4) {
+			int *rgb = (subs >= 5) ? &a[2] : &a[1];
+			if (
+				_sngTermBetween(rgb[0], 0, 255) &&
+				_sngTermBetween(rgb[1], 0, 255) &&
+				_sngTermBetween(rgb[2], 0, 255)
+			) {
+				*color = _sngTermRGBColor(t, ((u32)rgb[0] << 16) | ((u32)rgb[1] << 8) | (u32)rgb[2]);
+				return 1;
+			}
+		}
+		return 0;
+	}
+	if (*i+2 < argsLen && args[*i+1] == 5) {
+		*i += 2;
+		if (!_sngTermBetween(args[*i], 0, 255)) {
+			return 0;
+		}
+		*color = (u16)args[*i];
+		return 1;
+	}
+	if (*i+4 < argsLen && args[*i+1] == 2) {
+		int r = args[*i+2];
+		int g = args[*i+3];
+		int b = args[*i+4];
+		*i += 4;
+		if (
+			!_sngTermBetween(r, 0, 255) ||
+			!_sngTermBetween(g, 0, 255) ||
+			!_sngTermBetween(b, 0, 255)
+		) {
+			return 0;
+		}
+		*color = _sngTermRGBColor(t, ((u32)r << 16) | ((u32)g << 8) | (u32)b);
+		return 1;
+	}
+	return 0;
+}
+
+static void _sngTermSetAttr(SngTerm *t, int *args, int argsLen, u32 sub) {
 	int argsReset = 0;
 	if (argsLen == 0) {
 		args = &argsReset;
@@ -641,9 +1994,13 @@ static void _sngTermSetAttr(SngTerm *t, int *args, int argsLen) {
 	}
 	for (intptr_t i = 0; i < argsLen; i++) {
 		int a = args[i];
+		if (sub & (1u << i)) {
+			// sub-parameter of an attribute that does not take any
+			continue;
+		}
 		switch (a) {
 			case 0: {
-				t->cur.attr.attr &= ~(
+				t->cur.attr.attr &= (u16)~(
 					SNG_TERM_ATTR_REVERSE | 
 					SNG_TERM_ATTR_UNDERLINE | 
 					SNG_TERM_ATTR_BOLD | 
@@ -660,7 +2017,13 @@ static void _sngTermSetAttr(SngTerm *t, int *args, int argsLen) {
 				t->cur.attr.attr |= SNG_TERM_ATTR_ITALIC;
 			} break;
 			case 4: {
-				t->cur.attr.attr |= SNG_TERM_ATTR_UNDERLINE;
+				// 4:0 turns underline off; other styles (4:3 curly, etc.)
+				// are all plain underline here
+				if (_sngTermSubArgs(sub, argsLen, i) > 0 && args[i+1] == 0) {
+					t->cur.attr.attr &= (u16)~(SNG_TERM_ATTR_UNDERLINE);
+				} else {
+					t->cur.attr.attr |= SNG_TERM_ATTR_UNDERLINE;
+				}
 			} break;
 			case 5:
 			case 6: {
@@ -672,46 +2035,32 @@ static void _sngTermSetAttr(SngTerm *t, int *args, int argsLen) {
 			} break;
 			case 21:
 			case 22: {
-				t->cur.attr.attr &= ~(SNG_TERM_ATTR_BOLD);
+				t->cur.attr.attr &= (u16)~(SNG_TERM_ATTR_BOLD);
 			} break;
 			case 23: {
-				t->cur.attr.attr &= ~(SNG_TERM_ATTR_ITALIC);
+				t->cur.attr.attr &= (u16)~(SNG_TERM_ATTR_ITALIC);
 			} break;
 			case 24: {
-				t->cur.attr.attr &= ~(SNG_TERM_ATTR_UNDERLINE);
+				t->cur.attr.attr &= (u16)~(SNG_TERM_ATTR_UNDERLINE);
 			} break;
 			case 25:
 			case 26: {
-				t->cur.attr.attr &= ~(SNG_TERM_ATTR_BLINK);
+				t->cur.attr.attr &= (u16)~(SNG_TERM_ATTR_BLINK);
 			} break;
 			case 27: {
-				t->cur.attr.attr &= ~(SNG_TERM_ATTR_REVERSE);
+				t->cur.attr.attr &= (u16)~(SNG_TERM_ATTR_REVERSE);
 			} break;
 			case 38: {
-				if (i+2 < argsLen && args[i+1] == 5) {
-					i += 2;
-					if (_sngTermBetween(args[i], 0, 255)) {
-						t->cur.attr.fg = (u16)args[i];
-					} else {
-						fprintf(stderr, "sng_terminal: bad fgcolor %d\n", args[i]);
-					}
-				} else {
-					fprintf(stderr, "sng_terminal: gfx attr %d had unexpected args\n", a);
+				if (!_sngTermParseColor(t, args, argsLen, sub, &i, &t->cur.attr.fg)) {
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_BAD_SGR_COLOR, a);
 				}
 			} break;
 			case 39: {
 				t->cur.attr.fg = SNG_TERM_COLOR_DEFAULT_FG;
 			} break;
 			case 48: {
-				if (i+2 < argsLen && args[i+1] == 5) {
-					i += 2;
-					if (_sngTermBetween(args[i], 0, 255)) {
-						t->cur.attr.bg = (u16)args[i];
-					} else {
-						fprintf(stderr, "sng_terminal: bad bgcolor %d\n", args[i]);
-					}
-				} else {
-					fprintf(stderr, "sng_terminal: gfx attr %d had unexpected args\n", a);
+				if (!_sngTermParseColor(t, args, argsLen, sub, &i, &t->cur.attr.bg)) {
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_BAD_SGR_COLOR, a);
 				}
 			} break;
 			case 49: {
@@ -727,58 +2076,16 @@ static void _sngTermSetAttr(SngTerm *t, int *args, int argsLen) {
 				} else if (_sngTermBetween(args[i], 100, 107)) {
 					t->cur.attr.bg = (u16)(a - 100 + 8);
 				} else {
-					fprintf(stderr, "sng_terminal: gfx attr %d unknown \n", a);
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_SGR, a);
 				}
-				t->cur.attr.bg = SNG_TERM_COLOR_DEFAULT_BG;
 			} break;
 		}
 	}
 }
 
-static void _sngTermCSIParse(_SngTermCSI *c) {
-	SNG_ASSERT(c->bufLen > 0);
-	c->mode = c->buf[c->bufLen-1];
-	if (c->bufLen == 1) {
-		return;
-	}
-	char *s = &c->buf[0];
-	int sLen = c->bufLen;
-	c->argsLen = 0;
-	if (s[0] == '?') {
-		c->priv = 1;
-		s = &s[1];
-		sLen--;
-	}
-	sLen--;
-	s[sLen] = 0;
-	while (1) {
-		char *end;
-		int num = (int)strtol(s, &end, 10);
-		if (*end == ';') {
-			s = &end[1];
-			SNG_ASSERT(c->argsLen < 8);
-			if (c->argsLen < 8) {
-				c->args[c->argsLen] = num;
-				c->argsLen++;
-			}
-		} else if (*end == '\0') {
-			SNG_ASSERT(c->argsLen < 8);
-			if (c->argsLen < 8) {
-				c->args[c->argsLen] = num;
-				c->argsLen++;
-			}
-			break;
-		} else {
-			// TODO: inform about bad input
-			fprintf(stderr, "sadness\n");
-			break;
-		}
-	}
-}
-
-static int _sngTermCSIArg(_SngTermCSI *c, int i, int def) {
-	if (i >= c->argsLen || i < 0) {
-		return def;
+static int _sngTermCSIArg(_SngTermCSI *c, int i, int def) {
+	if (i >= c->argsLen || i < 0) {
+		return def;
 	}
 	return c->args[i];
 }
@@ -793,19 +2100,57 @@ static int _sngTermCSIMaxArg(_SngTermCSI *c, int i, int def) {
 }
 
 static void _sngTermCSIReset(_SngTermCSI *c) {
-	c->buf[0] = 0;
-	c->bufLen = 0;
 	c->argsLen = 0;
+	c->arg = 0;
+	c->sub = 0;
 	c->mode = 0;
 	c->priv = 0;
+	c->inter = 0;
+	c->bad = 0;
+	c->argOpen = 0;
+	c->argSub = 0;
+}
+
+// _sngTermCSIEndArg stores the parameter being accumulated. Parameters
+// past the end of args are dropped.
+static void _sngTermCSIEndArg(_SngTermCSI *c) {
+	if (c->argsLen < 16) {
+		if (c->argSub) {
+			c->sub |= 1u << c->argsLen;
+		}
+		c->args[c->argsLen] = c->arg;
+		c->argsLen++;
+	}
+	c->arg = 0;
+	c->argOpen = 0;
+	c->argSub = 0;
 }
 
-static b32 _sngTermCSIPut(_SngTermCSI *c, char b) {
-	c->buf[c->bufLen] = b;
-	c->bufLen++;
-	if (((u8)b >= 0x40 && (u8)b <= 0x7e) || c->bufLen >= 256) {
-		_sngTermCSIParse(c);
+// _sngTermCSIPut accumulates b into c, and returns non-zero once b is the
+// final character of the sequence.
+static b32 _sngTermCSIPut(_SngTermCSI *c, u32 b) {
+	if (b >= '0' && b <= '9') {
+		// saturate rather than overflow; no sane parameter is this large
+		if (c->arg < 100000000) {
+			c->arg = c->arg*10 + (int)(b - '0');
+		}
+		c->argOpen = 1;
+	} else if (b == ';' || b == ':') {
+		_sngTermCSIEndArg(c);
+		c->argOpen = 1;
+		c->argSub = (b == ':');
+	} else if (b >= 0x40 && b <= 0x7e) {
+		if (c->argOpen || c->argsLen > 0) {
+			_sngTermCSIEndArg(c);
+		}
+		c->mode = (char)b;
 		return 1;
+	} else if (b >= '<' && b <= '?' && !c->argOpen && c->argsLen == 0 && c->priv == 0) {
+		c->priv = (char)b;
+	} else if (b >= 0x20 && b <= 0x2f) {
+		c->inter = (char)b;
+	} else if (c->bad == 0) {
+		c->bad = (char)((b < 0x80) ? b : 0x7f);
 	}
 	return 0;
 }
@@ -875,8 +2220,83 @@ static b32 _sngTermHandleControlCode(SngTerm *t, u32 c) {
 	return 1;
 }
 
+// _sngTermReplyNum writes n in decimal to buf, and returns its length.
+static int _sngTermReplyNum(char *buf, int n) {
+	char digits[12];
+	int len = 0;
+	u32 u = n < 0 ? 0 : (u32)n;
+	do {
+		digits[len++] = (char)('0' + u % 10);
+		u /= 10;
+	} while (u > 0);
+	for (int i = 0; i < len; i++) {
+		buf[i] = digits[len-1-i];
+	}
+	return len;
+}
+
+// _sngTermReply appends prefix, a, ';', b, then suffix to the output.
+// Replies are formatted by hand, since a program can ask for them as
+// fast as it can write.
+static void _sngTermReply(SngTerm *t, const char *prefix, int a, int b, const char *suffix) {
+	char buf[48];
+	size_t n = strlen(prefix);
+	memcpy(buf, prefix, n);
+	n += (size_t)_sngTermReplyNum(&buf[n], a);
+	buf[n++] = ';';
+	n += (size_t)_sngTermReplyNum(&buf[n], b);
+	size_t suffixLen = strlen(suffix);
+	memcpy(&buf[n], suffix, suffixLen);
+	sngTermOutputPut(t, buf, n + suffixLen);
+}
+
+// _sngTermIdentify replies to DA and DECID as a VT102.
+static void _sngTermIdentify(SngTerm *t) {
+	sngTermOutputPut(t, "\033[?6c", 5);
+}
+
+// _sngTermPrivateModeState returns the DECRQM state of a private mode:
+// 1 if set, 2 if reset, or 0 if it is not one that can be asked about.
+static int _sngTermPrivateModeState(const SngTerm *t, int mode) {
+	s32 flag;
+	switch (mode) {
+		case 1:    flag = SNG_TERM_MODE_APP_CURSOR; break;
+		case 5:    flag = SNG_TERM_MODE_REVERSE; break;
+		case 7:    flag = SNG_TERM_MODE_WRAP; break;
+		case 25:   return (t->mode & SNG_TERM_MODE_HIDE) ? 2 : 1;
+		case 1004: flag = SNG_TERM_MODE_FOCUS; break;
+		case 1006: flag = SNG_TERM_MODE_MOUSE_SGR; break;
+		case 47:
+		case 1047:
+		case 1049: flag = SNG_TERM_MODE_ALT_SCREEN; break;
+		case 2026: flag = SNG_TERM_MODE_SYNC; break;
+		default:   return 0;
+	}
+	return (t->mode & flag) ? 1 : 2;
+}
+
 static void _sngTermHandleCSI(SngTerm *t) {
 	_SngTermCSI *c = &t->csi;
+	_SNG_TERM_STAT(t, csi[(c->mode - 0x40) & 63], 1);
+	if (c->priv == '?' && c->inter == '$' && c->mode == 'p') {
+		// DECRQM - request mode; applications ask about 2026 before
+		// relying on it
+		int mode = _sngTermCSIArg(c, 0, 0);
+		_sngTermReply(t, "\033[?", mode, _sngTermPrivateModeState(t, mode), "$y");
+		return;
+	}
+	if (c->priv == '>' && c->inter == 0 && c->mode == 'c') {
+		// secondary DA; a VT100 with no version or options
+		if (_sngTermCSIArg(c, 0, 0) == 0) {
+			sngTermOutputPut(t, "\033[>0;0;0c", 9);
+		}
+		return;
+	}
+	if (c->inter != 0 || (c->priv != 0 && c->priv != '?')) {
+		// none of these are supported yet (DECSCUSR, etc.)
+		_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_CSI, c->mode);
+		return;
+	}
 	switch (c->mode) {
 		// ICH - insert <n> blank chars
 		case '@': {
@@ -894,7 +2314,25 @@ static void _sngTermHandleCSI(SngTerm *t) {
 		// DA - device attributes
 		case 'c': {
 			if (_sngTermCSIArg(c, 0, 0) == 0) {
-				// TODO: write vt102 id
+				_sngTermIdentify(t);
+			}
+		} break;
+		// DSR - device status report
+		case 'n': {
+			switch (_sngTermCSIArg(c, 0, 0)) {
+				case 5: { // status; always fine
+					sngTermOutputPut(t, "\033[0n", 4);
+				} break;
+				case 6: { // CPR - cursor position report
+					int y = t->cur.y;
+					if (t->cur.state & _SNG_TERM_CURSOR_ORIGIN) {
+						y -= t->top;
+					}
+					_sngTermReply(t, c->priv ? "\033[?" : "\033[", y+1, t->cur.x+1, "R");
+				} break;
+				default: {
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_CSI, c->mode);
+				} break;
 			}
 		} break;
 		// CUF, HPR - cursor <n> forward
@@ -941,7 +2379,8 @@ static void _sngTermHandleCSI(SngTerm *t) {
 		} break;
 		// CHT - cursor forward tabulation <n> tab stops
 		case 'I': {
-			intptr_t n = _sngTermCSIArg(c, 0, 1);
+			// no more tab stops than columns
+			intptr_t n = _sngTermMin(_sngTermCSIArg(c, 0, 1), t->width);
 			for (intptr_t i = 0; i < n; i++) {
 				_sngTermPutTab(t, 1);
 			}
@@ -966,7 +2405,7 @@ static void _sngTermHandleCSI(SngTerm *t) {
 				} break;
 				// all
 				case 2: {
-					_sngTermClear(t, 0, 0, t->width - 1, t->height - 1);
+					_sngTermClearAll(t);
 				} break;
 				default: {
 					goto unexpected;
@@ -1007,7 +2446,7 @@ static void _sngTermHandleCSI(SngTerm *t) {
 		} break;
 		// RM - reset mode
 		case 'l': {
-			_sngTermSetMode(t, c->priv, 0, c->args, c->argsLen);
+			_sngTermSetMode(t, c->priv == '?', 0, c->args, c->argsLen);
 		} break;
 		// DL - delete <n> lines
 		case 'M': {
@@ -1023,7 +2462,7 @@ static void _sngTermHandleCSI(SngTerm *t) {
 		} break;
 		// CBT - cursor backward tabulation <n> tab stops
 		case 'Z': {
-			intptr_t n = _sngTermCSIArg(c, 0, 1);
+			intptr_t n = _sngTermMin(_sngTermCSIArg(c, 0, 1), t->width);
 			for (intptr_t i = 0; i < n; i++) {
 				_sngTermPutTab(t, 0);
 			}
@@ -1034,11 +2473,11 @@ static void _sngTermHandleCSI(SngTerm *t) {
 		} break;
 		// SM - set terminal mode
 		case 'h': {
-			_sngTermSetMode(t, c->priv, 1, c->args, c->argsLen);
+			_sngTermSetMode(t, c->priv == '?', 1, c->args, c->argsLen);
 		} break;
 		// SGR - terminal attribute (color)
 		case 'm': {
-			_sngTermSetAttr(t, c->args, c->argsLen);
+			_sngTermSetAttr(t, c->args, c->argsLen, c->sub);
 		} break;
 		// DECSTBM - set scrolling region
 		case 'r': {
@@ -1058,30 +2497,75 @@ static void _sngTermHandleCSI(SngTerm *t) {
 			_sngTermRestoreCursor(t);
 		} break;
 		default: {
-			// TODO: log to a user buffer.
-			fprintf(stderr, "unknown CSI sequence '%c'\n", c->mode);
+			_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_CSI, c->mode);
 		} break;
 	}
 	return;
 unexpected:
-	// TODO: log to a user buffer.
-	fprintf(stderr, "unexpected args for CSI sequence '%c'\n", c->mode);
+	_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNEXPECTED_CSI_ARGS, c->mode);
 }
 
 static void _sngTermSTRReset(_SngTermSTR *s) {
 	s->typeCodepoint = 0;
 	s->buf[0] = 0;
+	s->bufLen = 0;
 	s->argsLen = 0;
+	s->begun = 0;
 }
 
-static void _sngTermSTRPut(_SngTermSTR *s, char c) {
-	if (s->bufLen < 256-1) {
-		s->buf[s->bufLen] = c;
-		s->buf[s->bufLen+1] = '\0';
-		s->bufLen++;
+// _sngTermSTRPut appends len bytes of payload. Only the first 255 bytes
+// are kept for our own parsing; the user's SngTermStrFunc sees them all.
+static void _sngTermSTRPut(SngTerm *t, const char *data, size_t len) {
+	_SngTermSTR *s = &t->str;
+	size_t n = (size_t)(256-1 - s->bufLen);
+	if (n > len) {
+		n = len;
 	}
+	memcpy(&s->buf[s->bufLen], data, n);
+	s->bufLen += (int)n;
+	s->buf[s->bufLen] = '\0';
 	// Remain silent if STR sequence does not end so that it is apparent
 	// to user that something is wrong.
+	if (t->strFunc) {
+		int flags = s->begun ? 0 : SNG_TERM_STR_BEGIN;
+		s->begun = 1;
+		t->strFunc(t->strUser, t, s->typeCodepoint, data, len, flags);
+	}
+}
+
+// _sngTermSTREnd informs the user's SngTermStrFunc that the sequence
+// ended, where flags is SNG_TERM_STR_END or SNG_TERM_STR_ABORT.
+static void _sngTermSTREnd(SngTerm *t, int flags) {
+	_SngTermSTR *s = &t->str;
+	if (t->strFunc) {
+		if (!s->begun) {
+			flags |= SNG_TERM_STR_BEGIN;
+		}
+		t->strFunc(t->strUser, t, s->typeCodepoint, s->buf, 0, flags);
+	}
+}
+
+static int _sngTermUTF8Encode(u32 c, char *dest) {
+	if (c < 0x80) {
+		dest[0] = (char)c;
+		return 1;
+	}
+	if (c < 0x800) {
+		dest[0] = (char)(0xc0 | (c >> 6));
+		dest[1] = (char)(0x80 | (c & 0x3f));
+		return 2;
+	}
+	if (c < 0x10000) {
+		dest[0] = (char)(0xe0 | (c >> 12));
+		dest[1] = (char)(0x80 | ((c >> 6) & 0x3f));
+		dest[2] = (char)(0x80 | (c & 0x3f));
+		return 3;
+	}
+	dest[0] = (char)(0xf0 | ((c >> 18) & 0x07));
+	dest[1] = (char)(0x80 | ((c >> 12) & 0x3f));
+	dest[2] = (char)(0x80 | ((c >> 6) & 0x3f));
+	dest[3] = (char)(0x80 | (c & 0x3f));
+	return 4;
 }
 
 static void _sngTermSTRParse(_SngTermSTR *s) {
@@ -1126,11 +2610,15 @@ static const char *_sngTermSTRArgString(_SngTermSTR *s, int i, const char *def)
 }
 
 static void _sngTermHandleSTR(SngTerm *t) {
+	_SNG_TERM_TIMER_START(t);
 	_SngTermSTR *s = &t->str;
+	_SNG_TERM_STAT(t, strs, 1);
+	_sngTermSTREnd(t, SNG_TERM_STR_END);
 	_sngTermSTRParse(s);
 	switch (s->typeCodepoint) {
 		// OSC - operating system command
 		case ']': {
+			_SNG_TERM_STAT(t, osc, 1);
 			int cmd = _sngTermSTRArg(s, 0, 0);
 			switch (cmd) {
 				// title
@@ -1149,8 +2637,7 @@ static void _sngTermHandleSTR(SngTerm *t) {
 					// TODO(james4k): color reset
 				} break;
 				default: {
-					// TODO: log to a user buffer.
-					fprintf(stderr, "unknown OSC command '%d'\n", cmd);
+					_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_OSC, cmd);
 				} break;
 			}
 		} break;
@@ -1160,10 +2647,10 @@ static void _sngTermHandleSTR(SngTerm *t) {
 			snprintf(t->title, sizeof(t->title), "%s", _sngTermSTRArgString(s, 1, ""));
 		} break;
 		default: {
-			// TODO: log to a user buffer.
-			fprintf(stderr, "unknown STR sequence '0x%x'\n", s->typeCodepoint);
+			_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_STR, (int)s->typeCodepoint);
 		} break;
 	}
+	_SNG_TERM_TIMER_STOP(t, SNG_TERM_TIMER_STR);
 }
 
 static u32 _sngTermGfxCharTable[62] = {
@@ -1177,12 +2664,912 @@ static u32 _sngTermGfxCharTable[62] = {
 	L'│', L'≤', L'≥', L'π', L'≠', L'£', L'·',       // x - ~
 };
 
+// BEGIN GENERATED WIDTH TABLE
+// Unicode 14.0.0, from tools/sng_term_width.py
+static const u8 _sngTermWidthBlocks[4352] = {
+	0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d,
+	0x0e, 0x0f, 0x10, 0x11, 0x00, 0x00, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x00, 0x1a,
+	0x1b, 0x1c, 0x00, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x00, 0x00, 0x00, 0x22, 0x23, 0x24, 0x25, 0x26,
+	0x27, 0x26, 0x28, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x29, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x2a, 0x00, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26, 0x26, 0x32, 0x00, 0x33, 0x34, 0x35,
+	0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x00, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44,
+	0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x26, 0x50, 0x51, 0x52, 0x53,
+	0x00, 0x00, 0x00, 0x54, 0x55, 0x56, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x57,
+	0x00, 0x00, 0x00, 0x00, 0x58, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x00, 0x00, 0x59, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x00, 0x00, 0x5a, 0x5b, 0x26, 0x26, 0x5c, 0x5d,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x5e, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x5f,
+	0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x00, 0x00, 0x68, 0x26, 0x26, 0x26, 0x26, 0x69,
+	0x6a, 0x6b, 0x6c, 0x26, 0x26, 0x26, 0x26, 0x6d, 0x6e, 0x6f, 0x26, 0x26, 0x70, 0x71, 0x72, 0x26,
+	0x73, 0x74, 0x26, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x7e, 0x7f, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26, 0x26,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+};
+static const u8 _sngTermWidthBits[8256] = {
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x5a, 0x55,
+	0xaa, 0x55, 0x95, 0x59, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x15, 0x00, 0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x95, 0x56, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,
+	0x41, 0x10, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x6a, 0x55, 0xa9, 0xaa, 0xaa,
+	0x00, 0x50, 0x55, 0x55, 0x00, 0x00, 0x40, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x54, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x10, 0x00, 0x14, 0x04, 0x50, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x25, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x80, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x00, 0xa4, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x55, 0x95, 0x52,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x10, 0x00, 0x00, 0x01, 0x01, 0xa0, 0x55, 0x55, 0x55, 0x95,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x01, 0x9a, 0x55, 0x55, 0x95, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x95, 0xa0, 0xaa, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45, 0x54,
+	0x01, 0x00, 0x54, 0x51, 0x01, 0x00, 0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x51, 0x56, 0x55, 0x69, 0x69, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x99, 0x5a, 0xa5, 0x54,
+	0x01, 0x68, 0x69, 0x91, 0xaa, 0x6a, 0xaa, 0x65, 0x05, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x85,
+	0x42, 0x56, 0x95, 0x6a, 0x69, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x59, 0x96, 0xa5, 0x58,
+	0x81, 0x2a, 0x28, 0xa0, 0xa2, 0xaa, 0x56, 0x99, 0xaa, 0x5a, 0x55, 0x55, 0x50, 0x91, 0xaa, 0xaa,
+	0x42, 0x56, 0x55, 0x65, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x59, 0x56, 0xa5, 0x54,
+	0x01, 0x20, 0x64, 0xa1, 0xa9, 0xaa, 0xaa, 0xaa, 0x05, 0x5a, 0x55, 0x55, 0xa5, 0xaa, 0x06, 0x00,
+	0x52, 0x56, 0x55, 0x69, 0x69, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x59, 0x56, 0xa5, 0x14,
+	0x01, 0x68, 0x69, 0xa1, 0xaa, 0x42, 0xaa, 0x65, 0x05, 0x5a, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa,
+	0x4a, 0x56, 0x95, 0x5a, 0x59, 0xa5, 0x96, 0x59, 0x6a, 0xa9, 0x95, 0x5a, 0x55, 0x55, 0xa5, 0x5a,
+	0x94, 0x5a, 0x59, 0xa1, 0xa9, 0x6a, 0xaa, 0xaa, 0xaa, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa,
+	0x54, 0x54, 0x55, 0x59, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x55, 0x55, 0xa5, 0x04,
+	0x54, 0x09, 0x08, 0xa0, 0xaa, 0x82, 0x95, 0xa6, 0x05, 0x5a, 0x55, 0x55, 0xaa, 0x6a, 0x55, 0x55,
+	0x51, 0x55, 0x55, 0x59, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x55, 0x56, 0xa5, 0x14,
+	0x55, 0x49, 0x59, 0xa0, 0xaa, 0x96, 0xaa, 0x96, 0x05, 0x5a, 0x55, 0x55, 0x96, 0xaa, 0xaa, 0xaa,
+	0x50, 0x55, 0x55, 0x59, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x54,
+	0x01, 0x58, 0x59, 0x51, 0xaa, 0x55, 0x55, 0x55, 0x05, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x52, 0x56, 0x55, 0x55, 0x55, 0x95, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0xa6,
+	0x55, 0x95, 0x8a, 0x6a, 0x05, 0x88, 0x55, 0x55, 0xaa, 0x5a, 0x55, 0x55, 0x5a, 0xa9, 0xaa, 0xaa,
+	0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x51, 0x00, 0x80, 0x6a,
+	0x55, 0x15, 0x00, 0x40, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x96, 0x59, 0x95, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x66, 0x55, 0x55, 0x51, 0x00, 0x00, 0xa4,
+	0x55, 0x99, 0x00, 0xa0, 0x55, 0x55, 0xa5, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x11, 0x51, 0x55,
+	0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0x02, 0x00, 0x00, 0x40,
+	0x00, 0x04, 0x55, 0x01, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58,
+	0x55, 0x45, 0x55, 0x59, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x01, 0x04, 0x00, 0x41, 0x41,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x05, 0x54, 0x55, 0x55, 0x55, 0x01, 0x54, 0x55, 0x55,
+	0x45, 0x41, 0x55, 0x51, 0x55, 0x55, 0x55, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x65, 0xaa, 0xa6, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x59, 0xa5, 0x55, 0x95, 0x59, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x59, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0xa5, 0x55, 0x95,
+	0x59, 0xa5, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x59, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x02, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0xa5,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x05, 0xa4, 0xaa, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x05, 0x95, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x05, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x59, 0x09, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x10, 0x00, 0x50,
+	0x55, 0x45, 0x01, 0x00, 0x00, 0x55, 0x55, 0xa1, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0xa5, 0xaa,
+	0x55, 0x55, 0x15, 0x00, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa,
+	0x55, 0x41, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x91, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x40, 0x15, 0x54, 0xaa, 0x45, 0x55, 0x01, 0xaa,
+	0xa9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0xa9, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x95, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x14, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x45, 0x00, 0x80, 0x44, 0x01, 0x00, 0x54, 0x15, 0x00, 0x00, 0x28,
+	0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0xa5, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x80, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x04, 0x40, 0x54,
+	0x45, 0x55, 0x55, 0xa9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x55, 0x55, 0x95,
+	0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x50, 0x10, 0x50, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x45, 0x50, 0x11, 0x50, 0xaa, 0xaa, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00, 0x05, 0x6a, 0x55,
+	0x55, 0x55, 0xa5, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xa9, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x56,
+	0x55, 0x55, 0xaa, 0xaa, 0x40, 0x00, 0x00, 0x00, 0x04, 0x00, 0x54, 0x51, 0x55, 0x54, 0x90, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0xa5, 0x55, 0xa5, 0x55, 0x55, 0x66, 0x66, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x55,
+	0x55, 0x59, 0x55, 0x55, 0x55, 0x5a, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x5a, 0x59, 0x55, 0x95,
+	0x55, 0x55, 0x15, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x40, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x08, 0x00, 0x00, 0xa5, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0xa9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0xa9, 0xaa, 0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa8, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0x55, 0x55, 0x69, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0x56, 0x96, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x69,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+	0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x59, 0x55, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x69,
+	0x55, 0x5a, 0x55, 0x65, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0xa5, 0x59, 0x65, 0x59,
+	0x55, 0x59, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x66, 0x95, 0x9a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x95,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x56, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x5a, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x50, 0xaa, 0x56, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0xaa, 0xa6, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x6a, 0xa9, 0xaa, 0xaa, 0x2a,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0x55, 0x95, 0x55, 0x95, 0x55, 0x95, 0x55, 0x95,
+	0x55, 0x95, 0x55, 0x95, 0x55, 0x95, 0x55, 0x95, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x0a, 0xa0, 0xaa, 0xaa, 0xaa, 0x6a,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x82, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x40, 0x00, 0x00, 0x50,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x95, 0xaa, 0x65, 0x56, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55, 0x55, 0x55,
+	0x45, 0x45, 0x15, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x41, 0x55, 0xa8, 0x55, 0x55, 0xa5, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0xa0, 0xaa, 0x5a, 0x55, 0x55, 0xa5, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x50, 0x55, 0x55, 0x15,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x50, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x15, 0x00, 0x00, 0x50, 0xaa, 0xaa, 0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x05, 0x50, 0x50,
+	0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0xa5, 0x5a, 0x55, 0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x01, 0x40, 0x41, 0x81, 0xaa, 0xaa,
+	0x15, 0x55, 0x55, 0xa4, 0x55, 0x55, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x54,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x04, 0x14, 0x54, 0x05,
+	0x91, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x50, 0x55, 0x85, 0xaa, 0xaa,
+	0x56, 0x95, 0x56, 0x95, 0x56, 0x95, 0xaa, 0xaa, 0x55, 0x95, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x51, 0x54, 0xa1, 0x55, 0x55, 0xa5, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x55, 0x95, 0xaa, 0xaa, 0x6a, 0x55, 0xaa, 0x46, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x99,
+	0x65, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x95, 0xaa, 0xaa, 0xaa, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xaa, 0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x00, 0x00, 0x00, 0x00, 0xaa, 0xaa, 0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x59, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x29,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+	0x5a, 0x55, 0x5a, 0x55, 0x5a, 0x55, 0x5a, 0xa9, 0xaa, 0xaa, 0x55, 0x95, 0xaa, 0xaa, 0x02, 0xa5,
+	0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55, 0x95, 0x65,
+	0x55, 0x55, 0x55, 0xa5, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa,
+	0x95, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x6a, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0xa9, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa1,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa, 0xaa, 0xaa, 0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0x56, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x95, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x80, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0xaa, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0x6a, 0x55, 0x55, 0x95, 0x55,
+	0x55, 0x55, 0x95, 0x55, 0x95, 0x65, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x65, 0x55, 0x65, 0xa9,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x95, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0xa5, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0xa9, 0x69,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0x6a, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x95, 0xa5, 0x6a, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x6a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x6a,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x01, 0x82, 0xaa, 0x00, 0x55, 0x56, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x80, 0x2a,
+	0x55, 0x55, 0xa9, 0xaa, 0x55, 0x55, 0xa9, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x81, 0x6a, 0x55, 0x55, 0x95, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x56, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0x56, 0xa9, 0xaa, 0xaa, 0x56, 0x55, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0x5a, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0xaa, 0xaa, 0x55, 0x55, 0xa5, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x25, 0xa4, 0xa5, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x05, 0x00, 0x00, 0x54, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x05, 0x50, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa,
+	0x51, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00,
+	0x00, 0x40, 0x55, 0xa5, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x14, 0xa4, 0xaa, 0x2a,
+	0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x40, 0x41, 0x51,
+	0x85, 0xaa, 0xaa, 0xa2, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa, 0x55, 0x55, 0xa5, 0xaa,
+	0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x01, 0x00, 0x58, 0x55, 0x55,
+	0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x95, 0xaa, 0xaa,
+	0x50, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x00, 0x40,
+	0x55, 0x55, 0x01, 0x14, 0x55, 0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x50, 0x04, 0x55, 0x85,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x95, 0x59, 0x65, 0x55, 0x55, 0x55, 0x65, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x15, 0x00, 0x80, 0xaa, 0x55, 0x55, 0xa5, 0xaa,
+	0x50, 0x56, 0x55, 0x69, 0x69, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x59, 0x56, 0x25, 0x54,
+	0x54, 0x69, 0x69, 0xa5, 0xa9, 0x6a, 0xaa, 0x56, 0x55, 0x0a, 0x00, 0xa8, 0x00, 0xa8, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00,
+	0x05, 0x44, 0x55, 0x55, 0x55, 0x55, 0x55, 0x46, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x44, 0x15,
+	0x04, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0xa0, 0x55, 0x10,
+	0x54, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa0, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x40, 0x11,
+	0x54, 0xa9, 0xaa, 0xaa, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x51, 0x00, 0x10, 0xa5, 0xaa,
+	0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x02, 0x05, 0x10, 0x00, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x00, 0x41, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0x6a,
+	0x55, 0x95, 0xa6, 0x55, 0x55, 0x96, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0x29, 0x44,
+	0x15, 0x95, 0xaa, 0xaa, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x0a, 0x55, 0x54, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x01, 0x00, 0x40, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x00, 0x14, 0x40,
+	0x55, 0x15, 0xaa, 0xaa, 0x01, 0x40, 0x01, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x05, 0x00, 0x00, 0x40, 0x50, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa,
+	0x55, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x80, 0x00, 0x10,
+	0x55, 0xa5, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x04, 0x81, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x95, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x01, 0x80, 0x8a, 0x20,
+	0x00, 0x10, 0xaa, 0xaa, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x65, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x95, 0x60, 0x11, 0xa9, 0xaa, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x15, 0x54, 0xa9, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa9, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0x6a,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0xa9, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x00, 0x00, 0xa8, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0xa5, 0x5a, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95,
+	0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x00, 0xa4, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x40, 0x55, 0x55,
+	0x55, 0xa5, 0xaa, 0xaa, 0x55, 0x55, 0x65, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x56,
+	0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x95, 0x2a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xaa, 0x2a, 0x40, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa8, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0x55, 0x55, 0x55, 0xa9,
+	0x55, 0x55, 0xa9, 0xaa, 0x55, 0x55, 0xa5, 0x41, 0x00, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x80, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x15, 0x50, 0x55, 0x15, 0x00, 0x00, 0x00,
+	0x40, 0x01, 0x00, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x05, 0x50, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x05, 0xa4, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x59, 0x9a, 0x96, 0x56, 0x59, 0x55, 0x55, 0x65, 0x56,
+	0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x65, 0x95, 0x56, 0x55, 0x59, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x65, 0x95,
+	0x55, 0x99, 0x5a, 0x55, 0x59, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x15, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x55, 0x51, 0x55, 0x55,
+	0x55, 0x54, 0x55, 0xaa, 0xaa, 0xaa, 0x2a, 0x00, 0x02, 0x00, 0x00, 0x00, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x28, 0x00, 0x20, 0x08, 0x80, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0x00, 0x40, 0x55, 0xa5,
+	0x55, 0x55, 0xa5, 0x5a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x85, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x00, 0x55, 0x55, 0xa5, 0x6a,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x95, 0x55, 0x96, 0x55, 0x55, 0x55, 0x95,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x69, 0x55, 0x55, 0x00, 0x80, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x00, 0x40, 0xaa, 0x55, 0x55, 0xa5, 0x5a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x56, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x96, 0x69, 0x56, 0x55, 0x95, 0x55, 0x66, 0xaa,
+	0x9a, 0x6a, 0x66, 0x56, 0x96, 0x69, 0x66, 0x66, 0x96, 0x69, 0x95, 0x55, 0x95, 0x55, 0x56, 0x99,
+	0x55, 0x55, 0x65, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x56, 0x56, 0x65, 0x55, 0x55, 0x55, 0x55, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa5, 0xaa, 0xaa, 0xaa,
+	0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x95, 0x56, 0x55, 0x55, 0x55,
+	0x56, 0x55, 0x55, 0x95, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x65, 0xa9, 0xaa, 0x6a, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x56, 0x55, 0x55, 0xa9, 0xaa, 0x9a, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xa6,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0x6a, 0x95, 0xaa, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0x56, 0x56, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a,
+	0xa6, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x96,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x5a,
+	0x55, 0x55, 0x95, 0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x65, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x69, 0x55, 0x55, 0x55, 0x56, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x95, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0x5a, 0x55, 0x56, 0x6a, 0xa9, 0xaa, 0xaa, 0x55, 0x55, 0x95, 0xaa, 0x55, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0xa5, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5, 0xa5, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x6a, 0xaa,
+	0xaa, 0x9a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0x55, 0xa5, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x95, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x95, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x55, 0x55, 0xa5, 0xaa,
+	0xa2, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xaa, 0xaa, 0xaa, 0xaa,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+	0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xa5,
+};
+// END GENERATED WIDTH TABLE
+
+int sngTermCharWidth(u32 codepoint) {
+	if (codepoint >= 0x110000) {
+		return 1;
+	}
+	// two bits per codepoint, in blocks of 256 codepoints
+	u32 block = _sngTermWidthBlocks[codepoint >> 8];
+	u32 bits = _sngTermWidthBits[block*64 + ((codepoint & 0xff) >> 2)];
+	return (int)((bits >> ((codepoint & 3) * 2)) & 3);
+}
+
+// _sngTermSplitWide blanks the other half of a double width character,
+// if line[x] is part of one and is about to be overwritten.
+static void _sngTermSplitWide(SngTerm *t, SngTermCell *line, int x) {
+	if ((line[x].attr & SNG_TERM_ATTR_WIDE) != 0) {
+		if (x+1 < t->width && x+1 < _sngTermLineInfo(line)->eraseX) {
+			line[x+1].codepoint = ' ';
+			line[x+1].attr &= (u16)~SNG_TERM_ATTR_WIDE_SPACER;
+		}
+	} else if ((line[x].attr & SNG_TERM_ATTR_WIDE_SPACER) != 0 && x > 0) {
+		line[x-1].codepoint = ' ';
+		line[x-1].attr &= (u16)~SNG_TERM_ATTR_WIDE;
+		line[x-1].marks = 0;
+	}
+}
+
+// _sngTermMarks returns the index+1 of the combining marks m0 and m1 in
+// t's table, adding them if needed, or zero if the table is full even
+// after sweeping out marks no longer on either screen.
+static u16 _sngTermMarks(SngTerm *t, u32 m0, u32 m1) {
+	u32 mask = SNG_TERM_MARKS_TABLE_SIZE - 1;
+	u32 i = (m0 * 0x9e3779b1u ^ m1 * 0x85ebca6bu) >> 17;
+	for (;;) {
+		i &= mask;
+		if (t->markTable[i][0] == m0 && t->markTable[i][1] == m1) {
+			return (u16)(i + 1);
+		}
+		if (t->markTable[i][0] == 0) {
+			break;
+		}
+		i++;
+	}
+	// keep a quarter of the table empty so probes stay short
+	int full = SNG_TERM_MARKS_TABLE_SIZE - SNG_TERM_MARKS_TABLE_SIZE/4;
+	if (t->markTableLen >= full) {
+		if (!_sngTermSweepDue(&t->marksSweepWait)) {
+			return 0;
+		}
+		_sngTermSweepTables(t);
+		if (t->markTableLen > full - SNG_TERM_MARKS_TABLE_SIZE/8) {
+			t->marksSweepWait = _sngTermSweepBackoff(t, SNG_TERM_MARKS_TABLE_SIZE);
+		}
+		if (t->markTableLen >= full) {
+			return 0;
+		}
+		return _sngTermMarks(t, m0, m1);
+	}
+	t->markTable[i][0] = m0;
+	t->markTable[i][1] = m1;
+	t->markTableLen++;
+	t->tableSeq++;
+	return (u16)(i + 1);
+}
+
+// _sngTermPutMark attaches a combining mark to the character before the
+// cursor.
+static void _sngTermPutMark(SngTerm *t, u32 mark) {
+	int x = t->cur.x;
+	if ((t->cur.state & _SNG_TERM_CURSOR_WRAP_NEXT) == 0) {
+		x--;
+	}
+	if (x < 0) {
+		return;
+	}
+	SngTermCell *line = _sngTermLineOwn(t, t->cur.y);
+	if (line == NULL) {
+		return;
+	}
+	_sngTermLineFill(t, line, x+1);
+	if ((line[x].attr & SNG_TERM_ATTR_WIDE_SPACER) != 0 && x > 0) {
+		x--;
+	}
+	u32 marks[2] = {mark, 0};
+	if (line[x].marks != 0) {
+		// masked, as a loaded cell may hold any index
+		u32 *prev = t->markTable[(line[x].marks - 1) & (SNG_TERM_MARKS_TABLE_SIZE - 1)];
+		if (prev[1] != 0) {
+			return;
+		}
+		if (prev[0] != 0) {
+			marks[0] = prev[0];
+			marks[1] = mark;
+		}
+	}
+	u16 index = _sngTermMarks(t, marks[0], marks[1]);
+	if (index == 0) {
+		return;
+	}
+	line[x].marks = index;
+	t->changed |= SNG_TERM_CHANGED_SCREEN;
+	t->dirtyLines[t->cur.y] = 1;
+}
+
+
 static void _sngTermSetChar(
 	SngTerm *t,
 	u32 c,
-	SngTermCell *cell,
+	const SngTermCell *cell,
 	int x, int y
 ) {
+	_SNG_TERM_TIMER_START(t);
 	if (
 		(cell->attr & SNG_TERM_ATTR_GFX) != 0 &&
 		(c >= 0x41 && c <= 0x7e) &&
@@ -1190,16 +3577,130 @@ static void _sngTermSetChar(
 	) {
 		c = _sngTermGfxCharTable[c-0x41];
 	}
+	SngTermCell *line = _sngTermLineOwn(t, y);
+	if (line == NULL) {
+		_SNG_TERM_TIMER_STOP(t, SNG_TERM_TIMER_CHARS);
+		return;
+	}
+	_SngTermLineInfo *info = _sngTermLineInfo(line);
+	if (x >= info->eraseX) {
+		// x itself is written below, and holds no wide character to split
+		_sngTermLineFill(t, line, x);
+		info->eraseX = x+1;
+	} else {
+		_sngTermSplitWide(t, line, x);
+	}
 	t->changed |= SNG_TERM_CHANGED_SCREEN;
 	t->dirtyLines[y] = 1;
-	t->lines[y][x] = *cell;
-	t->lines[y][x].codepoint = c;
-	if ((cell->attr & SNG_TERM_ATTR_BOLD) && cell->fg < 8) {
-		t->lines[y][x].fg = cell->fg + 8;
+	line[x] = *cell;
+	line[x].codepoint = c;
+	_sngTermRunsCell(t, line, x);
+	_SNG_TERM_TIMER_STOP(t, SNG_TERM_TIMER_CHARS);
+}
+
+// _sngTermSetWideChar puts a double width character at x and its spacer
+// at x+1, unless x is the last column.
+static void _sngTermSetWideChar(SngTerm *t, u32 c, const SngTermCell *cell, int x, int y) {
+	_sngTermSetChar(t, c, cell, x, y);
+	SngTermCell *line = t->lines[y];
+	if (_sngTermLineShared(t, line)) {
+		// out of rows
+		return;
+	}
+	line[x].attr |= SNG_TERM_ATTR_WIDE;
+	if (x+1 >= t->width) {
+		return;
+	}
+	_SngTermLineInfo *info = _sngTermLineInfo(line);
+	if (x+1 >= info->eraseX) {
+		info->eraseX = x+2;
+	} else if ((line[x+1].attr & SNG_TERM_ATTR_WIDE) != 0) {
+		_sngTermSplitWide(t, line, x+1);
+	}
+	line[x+1] = *cell;
+	line[x+1].codepoint = 0;
+	line[x+1].attr |= SNG_TERM_ATTR_WIDE_SPACER;
+	_sngTermRunsCell(t, line, x+1);
+}
+
+// _sngTermWrapNext moves to the next line if the last character put was
+// in the last column, and autowrap is on.
+static void _sngTermWrapNext(SngTerm *t) {
+	if (
+		(t->mode & SNG_TERM_MODE_WRAP) != 0 &&
+		(t->cur.state & _SNG_TERM_CURSOR_WRAP_NEXT) != 0
+	) {
+		SngTermCell *line = _sngTermLineOwn(t, t->cur.y);
+		if (line != NULL) {
+			_sngTermLineFill(t, line, t->cur.x+1);
+			line[t->cur.x].attr |= SNG_TERM_ATTR_WRAP;
+		}
+		
+		b32 first_column = 1;
+		_sngTermNewLine(t, first_column);
 	}
-	if (cell->attr & SNG_TERM_ATTR_REVERSE) {
-		t->lines[y][x].fg = cell->bg;
-		t->lines[y][x].bg = cell->fg;
+}
+
+// _sngTermPutRun puts a run of printable ASCII characters, as
+// _sngTermStateParse would one at a time, but a line at a time. In insert
+// mode, the rest of the line is moved once per line rather than once per
+// character.
+static void _sngTermPutRun(SngTerm *t, const u8 *s, size_t n) {
+	while (n > 0) {
+		if ((t->mode & SNG_TERM_MODE_WRAP) == 0 && n > (size_t)(t->width - t->cur.x)) {
+			// Without autowrap, the excess all lands on the last column,
+			// which the slow path handles well enough.
+			while (n > 0) {
+				_sngTermStateParse(t, *s++);
+				n--;
+			}
+			return;
+		}
+		_sngTermWrapNext(t);
+		int x = t->cur.x;
+		int k = (int)(n < (size_t)(t->width - x) ? n : (size_t)(t->width - x));
+		if ((t->mode & SNG_TERM_MODE_INSERT) != 0 && x+1 < t->width) {
+			_sngTermInsertBlanks(t, k);
+		}
+		_SNG_TERM_STAT(t, chars, k);
+		_SNG_TERM_TIMER_START(t);
+		SngTermCell *line = _sngTermLineOwn(t, t->cur.y);
+		if (line != NULL) {
+			// Only the cells before x need filling, as the rest are
+			// written below, and only old cells can hold wide characters.
+			_SngTermLineInfo *info = _sngTermLineInfo(line);
+			_sngTermLineFill(t, line, x);
+			if (x < info->eraseX) {
+				_sngTermSplitWide(t, line, x);
+			}
+			if (x+k-1 < info->eraseX) {
+				_sngTermSplitWide(t, line, x+k-1);
+			} else {
+				info->eraseX = x+k;
+			}
+			SngTermCell cell = t->cur.attr;
+			b32 gfx = (cell.attr & SNG_TERM_ATTR_GFX) != 0;
+			for (int i = 0; i < k; i++) {
+				u32 c = s[i];
+				if (gfx && c >= 0x41 && _sngTermGfxCharTable[c-0x41] != 0) {
+					c = _sngTermGfxCharTable[c-0x41];
+				}
+				line[x+i] = cell;
+				line[x+i].codepoint = c;
+			}
+			_sngTermRunsSpan(t, line, x, x+k);
+			t->changed |= SNG_TERM_CHANGED_SCREEN;
+			t->dirtyLines[t->cur.y] = 1;
+		}
+		_SNG_TERM_TIMER_STOP(t, SNG_TERM_TIMER_CHARS);
+		if (x+k < t->width) {
+			_sngTermMoveTo(t, x+k, t->cur.y);
+		} else {
+			_sngTermMoveTo(t, t->width-1, t->cur.y);
+			t->cur.state |= _SNG_TERM_CURSOR_WRAP_NEXT;
+		}
+		s += k;
+		n -= (size_t)k;
 	}
 }
 
@@ -1212,29 +3713,51 @@ static void _sngTermStateParse(SngTerm *t, u32 codepoint) {
 	}
 
 	// TODO: update selection; see st.c:2450
-	
-	if (
-		(t->mode & SNG_TERM_MODE_WRAP) != 0 &&
-		(t->cur.state & _SNG_TERM_CURSOR_WRAP_NEXT) != 0
-	) {
-		t->lines[t->cur.y][t->cur.x].attr |= SNG_TERM_ATTR_WRAP;
-		
-		b32 first_column = 1;
-		_sngTermNewLine(t, first_column);
+
+	_SNG_TERM_STAT(t, chars, 1);
+	// Everything below U+0300 is one cell wide, which saves the lookup
+	// for Latin text.
+	int width = 1;
+	if (codepoint >= 0x300) {
+		width = sngTermCharWidth(codepoint);
 	}
+	if (width == 0) {
+		_sngTermPutMark(t, codepoint);
+		return;
+	}
+	
+	_sngTermWrapNext(t);
 
 	if (
 		(t->mode & SNG_TERM_MODE_INSERT) != 0 &&
-		t->cur.x+1 < t->width
+		t->cur.x+width < t->width
 	) {
-		// TODO: move stuff; see st.c:2458
-		// TODO: log to user buffer
-		fprintf(stderr, "insert mode not implemented\n");
+		_sngTermInsertBlanks(t, width);
 	}
 
-	_sngTermSetChar(t, codepoint, &t->cur.attr, t->cur.x, t->cur.y);
-	if (t->cur.x+1 < t->width) {
-		_sngTermMoveTo(t, t->cur.x+1, t->cur.y);
+	if (width == 2) {
+		if (t->cur.x+2 > t->width && t->width >= 2) {
+			// does not fit on this line
+			if (t->mode & SNG_TERM_MODE_WRAP) {
+				// pad the last column with a spacer that has no wide
+				// character before it, so reflow knows to drop it
+				_sngTermSetChar(t, 0, &t->cur.attr, t->cur.x, t->cur.y);
+				SngTermCell *line = t->lines[t->cur.y];
+				if (!_sngTermLineShared(t, line)) {
+					line[t->cur.x].attr |= SNG_TERM_ATTR_WIDE_SPACER;
+				}
+				t->cur.state |= _SNG_TERM_CURSOR_WRAP_NEXT;
+				_sngTermWrapNext(t);
+			} else {
+				_sngTermMoveTo(t, t->width-2, t->cur.y);
+			}
+		}
+		_sngTermSetWideChar(t, codepoint, &t->cur.attr, t->cur.x, t->cur.y);
+	} else {
+		_sngTermSetChar(t, codepoint, &t->cur.attr, t->cur.x, t->cur.y);
+	}
+	if (t->cur.x+width < t->width) {
+		_sngTermMoveTo(t, t->cur.x+width, t->cur.y);
 	} else {
 		t->cur.state |= _SNG_TERM_CURSOR_WRAP_NEXT;
 	}
@@ -1244,6 +3767,9 @@ static void _sngTermStateParseEsc(SngTerm *t, u32 c) {
 	if (_sngTermHandleControlCode(t, c)) {
 		return;
 	}
+	if (c >= 0x20 && c < 0x80) {
+		_SNG_TERM_STAT(t, esc[c - 0x20], 1);
+	}
 	_SngTermState next = _sngTermStateParse;
 	switch (c) {
 		case '[': {
@@ -1290,7 +3816,7 @@ static void _sngTermStateParseEsc(SngTerm *t, u32 c) {
 			}
 		} break;
 		case 'Z': { // DECID - identify terminal
-			// TODO:
+			_sngTermIdentify(t);
 		} break;
 		case 'c': { // RIS - reset to initial state
 			_sngTermReset(t);
@@ -1311,8 +3837,7 @@ static void _sngTermStateParseEsc(SngTerm *t, u32 c) {
 			// TODO: need to do anything here?
 		} break;
 		default: {
-			// TODO: remove printf
-			printf("unknown escape sequence '%c'\n", (s8)c);
+			_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_ESC, (int)c);
 		} break;
 	}
 	t->state = next;
@@ -1327,7 +3852,7 @@ static void _sngTermStateParseEscAltCharset(SngTerm *t, u32 c) {
 			t->cur.attr.attr |= SNG_TERM_ATTR_GFX;
 		} break;
 		case 'B': { // USASCII
-			t->cur.attr.attr &= ~SNG_TERM_ATTR_GFX;
+			t->cur.attr.attr &= (u16)~SNG_TERM_ATTR_GFX;
 		} break;
 		case 'A':   // UK (ignored)
 		case '<':   // multinational (ignored)
@@ -1336,8 +3861,7 @@ static void _sngTermStateParseEscAltCharset(SngTerm *t, u32 c) {
 		case 'K': { // German (ignored)
 		} break;
 		default: {
-			// TODO: remove printf
-			printf("unknown alt. charset '%c' (%x0\n", (u8)c, c);
+			_SNG_TERM_EVENT(t, SNG_TERM_EVENT_UNKNOWN_CHARSET, (int)c);
 		} break;
 	}
 	t->state = _sngTermStateParse;
@@ -1347,9 +3871,14 @@ static void _sngTermStateParseEscCSI(SngTerm *t, u32 c) {
 	if (_sngTermHandleControlCode(t, c)) {
 		return;
 	}
-	if (_sngTermCSIPut(&t->csi, (char)c)) {
+	if (_sngTermCSIPut(&t->csi, c)) {
 		t->state = _sngTermStateParse;
+		if (t->csi.bad) {
+			_SNG_TERM_EVENT(t, SNG_TERM_EVENT_BAD_CSI, t->csi.bad);
+		}
+		_SNG_TERM_TIMER_START(t);
 		_sngTermHandleCSI(t);
+		_SNG_TERM_TIMER_STOP(t, SNG_TERM_TIMER_CSI);
 	}
 }
 
@@ -1363,77 +3892,121 @@ static void _sngTermStateParseEscSTR(SngTerm *t, u32 c) {
 			_sngTermHandleSTR(t);
 		} break;
 		default: {
-			_sngTermSTRPut(&t->str, (char)c);
+			char utf8[4];
+			_sngTermSTRPut(t, utf8, (size_t)_sngTermUTF8Encode(c, utf8));
 		} break;
 	}
 }
 
 static void _sngTermStateParseEscSTREnd(SngTerm *t, u32 c) {
+	if (c == '\\') {
+		t->state = _sngTermStateParse;
+		_sngTermHandleSTR(t);
+		return;
+	}
+	_sngTermSTREnd(t, SNG_TERM_STR_ABORT);
 	if (_sngTermHandleControlCode(t, c)) {
 		return;
 	}
 	t->state = _sngTermStateParse;
-	if (c == '\\') {
-		_sngTermHandleSTR(t);
-	}
 }
 
 static void _sngTermStateParseEscTest(SngTerm *t, u32 c) {
 	if (_sngTermHandleControlCode(t, c)) {
 		return;
 	}
-	// DEC screen alignment test
+	// DEC screen alignment test. Each line is cleared to 'E' rather than
+	// written, so it costs as little as clearing the screen.
 	if (c == '8') {
-		for (int y = 0; y < t->height; y++) {
-			for (int x = 0; x < t->width; x++) {
-				_sngTermSetChar(t, 'E', &t->cur.attr, x, y);
+		SngTermCell fill = t->cur.attr;
+		fill.codepoint = 'E';
+		if ((fill.attr & SNG_TERM_ATTR_GFX) && _sngTermGfxCharTable['E'-0x41] != 0) {
+			fill.codepoint = _sngTermGfxCharTable['E'-0x41];
+		}
+		t->changed |= SNG_TERM_CHANGED_SCREEN;
+		for (intptr_t y = 0; y < t->height; y++) {
+			t->dirtyLines[y] = 1;
+			SngTermCell *line = _sngTermLineOwn(t, y);
+			if (line != NULL) {
+				_sngTermLineInfo(line)->eraseX = 0;
+				_sngTermLineInfo(line)->erase = fill;
 			}
 		}
 	}
 	t->state = _sngTermStateParse;
 }
 
-#define _SNG_TERM_PTR_ALIGN (sizeof(void *) - 1)
-
-#define _SNG_TERM_SIZEOF_W(w) \
-	(((size_t)w + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
-
-#define _SNG_TERM_SIZEOF_H(h) \
-	(((size_t)h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
-
-#define _SNG_TERM_SIZEOF_TERM \
-	((sizeof(SngTerm) + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
-
-#define _SNG_TERM_SIZEOF_LINES(w, h) \
-	((sizeof(SngTermCell *)*h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+size_t sngTermAllocSize(int maxWidth, int maxHeight) {
+	return sngTermAllocSizeMax(maxWidth, maxHeight);
+}
 
-#define _SNG_TERM_SIZEOF_LINES_DATA(w, h) \
-	((sizeof(SngTermCell)*w*h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+size_t sngTermAllocSizeMin(int maxWidth, int maxHeight) {
+	size_t w = _SNG_TERM_SIZEOF_W(maxWidth);
+	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
+	size_t term = _SNG_TERM_SIZEOF_TERM;
+	size_t lines = _SNG_TERM_SIZEOF_LINES(w, h) + _SNG_TERM_SIZEOF_LINES_DATA(w, h);
+	size_t dirtyLines = _SNG_TERM_SIZEOF_DIRTYLINES(h);
+	size_t tabs = _SNG_TERM_SIZEOF_TABS(w);
+	return term + lines + dirtyLines + tabs;
+}
 
-#define _SNG_TERM_SIZEOF_DIRTYLINES(h) \
-	((sizeof(b8)*h + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+size_t sngTermAllocSizeMax(int maxWidth, int maxHeight) {
+	return sngTermAllocSizeMin(maxWidth, maxHeight) + sngTermAltAllocSize(maxWidth, maxHeight);
+}
 
-#define _SNG_TERM_SIZEOF_TABS(w) \
-	((sizeof(b8)*w + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+size_t sngTermAltAllocSize(int maxWidth, int maxHeight) {
+	size_t w = _SNG_TERM_SIZEOF_W(maxWidth);
+	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
+	return _SNG_TERM_SIZEOF_LINES(w, h) + _SNG_TERM_SIZEOF_LINES_DATA(w, h);
+}
 
-size_t sngTermAllocSize(int maxWidth, int maxHeight) {
+size_t sngTermAllocSizePooled(int maxWidth, int maxHeight) {
 	size_t w = _SNG_TERM_SIZEOF_W(maxWidth);
 	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
 	size_t term = _SNG_TERM_SIZEOF_TERM;
-	size_t lines = _SNG_TERM_SIZEOF_LINES(w, h) + _SNG_TERM_SIZEOF_LINES_DATA(w, h);
-	size_t altLines = _SNG_TERM_SIZEOF_LINES(w, h) + _SNG_TERM_SIZEOF_LINES_DATA(w, h);
+	size_t lines = _SNG_TERM_SIZEOF_LINES(w, h);
+	size_t altLines = _SNG_TERM_SIZEOF_LINES(w, h);
 	size_t dirtyLines = _SNG_TERM_SIZEOF_DIRTYLINES(h);
 	size_t tabs = _SNG_TERM_SIZEOF_TABS(w);
 	return term + lines + altLines + dirtyLines + tabs;
 }
 
+static void _sngTermInitLines(SngTermCell **lines, void *data, size_t w, size_t h) {
+	for (size_t y = 0; y < h; y++) {
+		u8 *line = (u8 *)data + y * _SNG_TERM_SIZEOF_LINE(w);
+		lines[y] = (SngTermCell *)(void *)(line + sizeof(_SngTermLineInfo));
+	}
+}
+
+static void _sngTermInitState(SngTerm *t, int maxWidth, int maxHeight) {
+	t->maxWidth = maxWidth;
+	t->maxHeight = maxHeight;
+	t->top = 0;
+	t->bottom = maxHeight;
+	t->cur = _sngTermDefaultCursor();
+	t->state = _sngTermStateParse;
+}
+
+// _sngTermRotateLines rotates the first len lines up by n, so lines that
+// slide off the top come back at the bottom rather than being lost.
+static void _sngTermRotateLines(SngTermCell **lines, int n, int len) {
+	int ranges[3][2] = {{0, n}, {n, len}, {0, len}};
+	for (size_t r = 0; r < 3; r++) {
+		for (int i = ranges[r][0], j = ranges[r][1]-1; i < j; i++, j--) {
+			SngTermCell *tmp = lines[i];
+			lines[i] = lines[j];
+			lines[j] = tmp;
+		}
+	}
+}
+
 SngTerm *sngTermInit(
 	void *memory, size_t memorySize,
 	int maxWidth, int maxHeight,
 	SngTerm *seedTerm
 ) {
-	size_t expectedSize = sngTermAllocSize(maxWidth, maxHeight);
-	if (memorySize < expectedSize) {
+	size_t minSize = sngTermAllocSizeMin(maxWidth, maxHeight);
+	if (memorySize < minSize) {
 		return 0;
 	}
 	if (seedTerm != NULL) {
@@ -1448,51 +4021,326 @@ SngTerm *sngTermInit(
 	void *extraMem = (u8 *)t + _SNG_TERM_SIZEOF_TERM;
 	t->lines = (SngTermCell **)extraMem;
 	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_LINES(w, h);
-	for (size_t y = 0; y < h; y++) {
-		SngTermCell *cell = (SngTermCell *)extraMem;
-		t->lines[y] = &cell[y * w];
-	}
-	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_LINES_DATA(w, h);
-	t->altLines = (SngTermCell **)extraMem;
-	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_LINES(w, h);
-	for (size_t y = 0; y < h; y++) {
-		SngTermCell *cell = (SngTermCell *)extraMem;
-		t->altLines[y] = &cell[y * w];
-	}
+	_sngTermInitLines(t->lines, extraMem, w, h);
 	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_LINES_DATA(w, h);
 	t->dirtyLines = (b8 *)extraMem;
 	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_DIRTYLINES(h);
 	t->tabs = (b8 *)extraMem;
-	//extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_DIRTYLINES(w);
-	t->maxWidth = maxWidth;
-	t->maxHeight = maxHeight;
-	t->top = 0;
-	t->bottom = maxHeight;
-	t->cur = _sngTermDefaultCursor();
-	t->state = _sngTermStateParse;
+	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_TABS(w);
+	// The alternate screen comes last, so it is simply left out when
+	// memorySize only fits sngTermAllocSizeMin.
+	if (memorySize >= minSize + sngTermAltAllocSize(maxWidth, maxHeight)) {
+		t->altLines = (SngTermCell **)extraMem;
+		extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_LINES(w, h);
+		_sngTermInitLines(t->altLines, extraMem, w, h);
+	}
+	_sngTermInitState(t, maxWidth, maxHeight);
 	return t;
 }
 
-b32 sngTermSetSize(SngTerm *t, int width, int height) {
-	if (t->width == width && t->height == height) {
-		return 1;
-	}
-	if (width < 1 || height < 1) {
+SngTerm *sngTermInitPooled(
+	void *memory, size_t memorySize,
+	int maxWidth, int maxHeight,
+	SngTermRowPool *pool, int rowQuota
+) {
+	if (memorySize < sngTermAllocSizePooled(maxWidth, maxHeight) || maxWidth > pool->width) {
 		return 0;
 	}
-	if (width > t->maxWidth || height > t->maxHeight) {
-		return 0;
+	SngTerm *t = (SngTerm *)memory;
+	memset(memory, 0, memorySize);
+	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
+	void *extraMem = (u8 *)t + _SNG_TERM_SIZEOF_TERM;
+	// Only line pointers; the lines themselves come from the pool.
+	t->lines = (SngTermCell **)extraMem;
+	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_LINES(maxWidth, h);
+	t->altLines = (SngTermCell **)extraMem;
+	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_LINES(maxWidth, h);
+	t->dirtyLines = (b8 *)extraMem;
+	extraMem = (u8 *)extraMem + _SNG_TERM_SIZEOF_DIRTYLINES(h);
+	t->tabs = (b8 *)extraMem;
+	for (size_t y = 0; y < h; y++) {
+		t->lines[y] = pool->blank;
+		t->altLines[y] = pool->blank;
 	}
-	int slide = t->cur.y - height + 1;
-	if (slide > 0) {
-		memmove(t->lines, &t->lines[slide], sizeof(t->lines[0])*(u32)height);
-		memmove(t->altLines, &t->altLines[slide], sizeof(t->altLines[0])*(u32)height);
+	t->pool = pool;
+	t->rowQuota = rowQuota;
+	_sngTermInitState(t, maxWidth, maxHeight);
+	return t;
+}
+
+// _sngTermLineErase makes line y blank from column x on, keeping the cells
+// before it. The caller keeps their run boundaries up to date.
+static void _sngTermLineErase(SngTerm *t, intptr_t y, int x, const SngTermCell *blank) {
+	if (
+		t->pool != NULL && x == 0 &&
+		_sngTermCellEqual(&_sngTermLineInfo(t->pool->blank)->erase, blank)
+	) {
+		_sngTermLineDisown(t, y);
+		return;
 	}
-	int min_width = _sngTermMin(t->width, width);
-	int min_height = _sngTermMin(t->height, height);
-	t->changed |= SNG_TERM_CHANGED_SCREEN;
-	t->width = width;
-	t->height = height;
+	SngTermCell *line = _sngTermLineOwn(t, y);
+	if (line == NULL) {
+		return;
+	}
+	_SngTermLineInfo *info = _sngTermLineInfo(line);
+	info->eraseX = x;
+	info->erase = *blank;
+}
+
+// _sngTermReflowRows wraps l to the terminal's width, starting at row,
+// and returns the row after it. If emit is set, rows from first onward
+// are put on screen. cursor is an offset within l, or -1, and its row and
+// column are stored in cx and cy. runs are the run boundaries of cells.
+static int _sngTermReflowRows(
+	SngTerm *t,
+	const _SngTermReflowLine *l, const SngTermCell *cells, const u32 *runs,
+	int row, int first, b32 emit,
+	int cursor, int *cx, int *cy
+) {
+	int width = t->width;
+	const SngTermCell *c = &cells[l->start];
+	int i = 0;
+	b32 more;
+	do {
+		int end = _sngTermMin(i + width, l->len);
+		if (end < i) {
+			end = i;
+		}
+		if (end < l->len && end-1 > i && (c[end].attr & SNG_TERM_ATTR_WIDE_SPACER)) {
+			// move the wide character to the next row, rather than split it
+			end--;
+		}
+		more = end < l->len;
+		if (cursor >= i && (cursor < end || (!more && cursor < i + width))) {
+			*cx = cursor - i;
+			*cy = row;
+		} else if (!more && cursor >= i + width) {
+			// the cursor is past the text, on a row of its own
+			more = 1;
+		}
+		intptr_t y = row - first;
+		if (emit && y >= 0 && y < t->height) {
+			SngTermCell *line = end > i ? _sngTermLineOwn(t, y) : NULL;
+			SngTermCell blank = _sngTermDefaultCursor().attr;
+			blank.codepoint = ' ';
+			if (line != NULL) {
+				memcpy(line, &c[i], (size_t)(end - i) * sizeof(line[0]));
+				if (end - i > 1) {
+					_sngTermBitsCopy(_sngTermLineRuns(t, line), 1, runs, l->start + i + 1, end - i - 1);
+				}
+				if (more) {
+					for (int x = end - i; x < width; x++) {
+						line[x] = blank;
+					}
+					if (end - i == width-1 && (c[end].attr & SNG_TERM_ATTR_WIDE)) {
+						// padding, as _sngTermStateParse leaves it
+						line[width-1].codepoint = 0;
+						line[width-1].attr |= SNG_TERM_ATTR_WIDE_SPACER;
+					}
+					line[width-1].attr |= SNG_TERM_ATTR_WRAP;
+				}
+			}
+			if (more) {
+				_sngTermLineErase(t, y, width, &blank);
+			} else {
+				_sngTermLineErase(t, y, end - i, &l->erase);
+			}
+			if (line != NULL) {
+				_sngTermRunsUpdate(t, line, end - i, width);
+			}
+			t->dirtyLines[y] = 1;
+		}
+		row++;
+		i = end > i ? end : i + width;
+	} while (more);
+	return row;
+}
+
+// _sngTermReflow rewraps the lines of the screen from oldWidth to
+// t->width, keeping cur on the same character.
+static void _sngTermReflow(
+	SngTerm *t, SngTermCursor *cur,
+	int oldWidth, int oldHeight,
+	void *scratch
+) {
+	_SngTermReflowLine *lines = (_SngTermReflowLine *)scratch;
+	SngTermCell *cells = (SngTermCell *)(void *)&lines[t->maxHeight];
+	u32 *runs = (u32 *)(void *)&cells[t->maxWidth * t->maxHeight];
+	int linesLen = 0;
+	int cellsLen = 0;
+	int cursorLine = -1;
+	int cursor = 0;
+	b32 wrapNext = (cur->state & _SNG_TERM_CURSOR_WRAP_NEXT) != 0;
+
+	// Gather lines, joining rows that wrapped into the next.
+	b32 continued = 0;
+	for (intptr_t y = 0; y < oldHeight; y++) {
+		const SngTermCell *row = t->lines[y];
+		const _SngTermLineInfo *info = _sngTermLineInfoConst(row);
+		if (!continued) {
+			lines[linesLen].start = cellsLen;
+			lines[linesLen].len = 0;
+			linesLen++;
+		}
+		_SngTermReflowLine *l = &lines[linesLen-1];
+		int len = _sngTermMin(info->eraseX, oldWidth);
+		continued = len == oldWidth && (row[oldWidth-1].attr & SNG_TERM_ATTR_WRAP) != 0;
+		if (
+			continued &&
+			(row[len-1].attr & SNG_TERM_ATTR_WIDE_SPACER) != 0 &&
+			(len < 2 || (row[len-2].attr & SNG_TERM_ATTR_WIDE) == 0)
+		) {
+			// padding left by a wide character that did not fit
+			len--;
+		}
+		if (!continued) {
+			while (len > 0 && row[len-1].codepoint == ' ' && _sngTermCellEqual(&row[len-1], &info->erase)) {
+				len--;
+			}
+			l->erase = info->erase;
+		}
+		if (y == cur->y) {
+			cursorLine = linesLen-1;
+			cursor = l->len + cur->x;
+		}
+		memcpy(&cells[cellsLen], row, (size_t)len * sizeof(cells[0]));
+		for (int x = 0; x < len; x++) {
+			cells[cellsLen+x].attr &= (u16)~SNG_TERM_ATTR_WRAP;
+		}
+		// Boundaries within the row come with it, and the one where it
+		// joins the row before is compared.
+		if (len > 1) {
+			_sngTermBitsCopy(runs, cellsLen+1, _sngTermLineRunsConst(t, row), 1, len-1);
+		}
+		_sngTermRunsCompare(runs, cells, cellsLen, _sngTermMin(cellsLen, cellsLen + len - 1));
+		cellsLen += len;
+		l->len += len;
+	}
+
+	// Count rows, to keep the cursor and the text above it on screen.
+	int rows = 0;
+	int used = 0;
+	int cx = 0;
+	int cy = 0;
+	for (int i = 0; i < linesLen; i++) {
+		int c = i == cursorLine ? cursor : -1;
+		rows = _sngTermReflowRows(t, &lines[i], cells, runs, rows, 0, 0, c, &cx, &cy);
+		if (lines[i].len > 0 || i == cursorLine) {
+			used = rows;
+		}
+	}
+	int first = _sngTermMax(0, _sngTermMin(used - t->height, cy));
+
+	rows = 0;
+	for (int i = 0; i < linesLen; i++) {
+		int c = i == cursorLine ? cursor : -1;
+		rows = _sngTermReflowRows(t, &lines[i], cells, runs, rows, first, 1, c, &cx, &cy);
+	}
+	SngTermCell blank = _sngTermDefaultCursor().attr;
+	blank.codepoint = ' ';
+	for (intptr_t y = _sngTermMax(0, rows - first); y < t->height; y++) {
+		_sngTermLineErase(t, y, 0, &blank);
+	}
+
+	cur->state &= (u16)~_SNG_TERM_CURSOR_WRAP_NEXT;
+	cur->x = cx;
+	cur->y = cy - first;
+	if (wrapNext) {
+		// the cursor was just past the last column, on its last character
+		if (cur->x+1 < t->width) {
+			cur->x++;
+		} else {
+			cur->state |= _SNG_TERM_CURSOR_WRAP_NEXT;
+		}
+	}
+	_sngTermDirtyAll(t);
+}
+
+// _sngTermClearResized clears what a resize uncovered on the screen.
+static void _sngTermClearResized(SngTerm *t, int minWidth, int minHeight) {
+	if (minWidth < t->width && minHeight > 0) {
+		_sngTermClear(t, minWidth, 0, t->width-1, t->height-1);
+	}
+	if (minHeight < t->height) {
+		_sngTermClear(t, 0, minHeight, t->width-1, t->height-1);
+	}
+}
+
+size_t sngTermReflowScratchSize(int maxWidth, int maxHeight) {
+	size_t lines = sizeof(_SngTermReflowLine) * (size_t)maxHeight;
+	size_t cells = sizeof(SngTermCell) * (size_t)maxWidth * (size_t)maxHeight;
+	size_t runs = _SNG_TERM_SIZEOF_RUNS((size_t)maxWidth * (size_t)maxHeight);
+	return lines + cells + runs;
+}
+
+b32 sngTermSetSizeReflow(SngTerm *t, int width, int height, void *scratch, size_t scratchSize) {
+	if (width == t->width || t->width == 0) {
+		return sngTermSetSize(t, width, height) || (t->width == width && t->height == height);
+	}
+	if (width < 1 || height < 1) {
+		return 0;
+	}
+	if (width > t->maxWidth || height > t->maxHeight) {
+		return 0;
+	}
+	if (scratchSize < sngTermReflowScratchSize(t->maxWidth, t->maxHeight)) {
+		return 0;
+	}
+	int oldWidth = t->width;
+	int oldHeight = t->height;
+	b32 alt = (t->mode & SNG_TERM_MODE_ALT_SCREEN) != 0;
+	t->changed |= SNG_TERM_CHANGED_SCREEN;
+	t->width = width;
+	t->height = height;
+	_sngTermSetScroll(t, 0, height-1);
+	if (alt) {
+		// Reflow the hidden main screen, where the cursor to keep is the
+		// one saved on the switch, then resize the alternate screen.
+		_sngTermSwapScreen(t);
+		_sngTermReflow(t, &t->cur_saved, oldWidth, oldHeight, scratch);
+		_sngTermSwapScreen(t);
+		int slide = t->cur.y - height + 1;
+		if (slide > 0) {
+			_sngTermRotateLines(t->lines, slide, t->maxHeight);
+		}
+		_sngTermClearResized(t, _sngTermMin(oldWidth, width), _sngTermMin(oldHeight, height));
+	} else {
+		_sngTermReflow(t, &t->cur, oldWidth, oldHeight, scratch);
+		if (t->altLines != NULL) {
+			_sngTermSwapScreen(t);
+			_sngTermClearResized(t, _sngTermMin(oldWidth, width), _sngTermMin(oldHeight, height));
+			_sngTermSwapScreen(t);
+		}
+	}
+	// _sngTermMoveTo clears WRAP_NEXT, which reflow may have set
+	u16 wrapNext = t->cur.state & _SNG_TERM_CURSOR_WRAP_NEXT;
+	_sngTermMoveTo(t, t->cur.x, t->cur.y);
+	t->cur.state |= wrapNext;
+	return 1;
+}
+
+b32 sngTermSetSize(SngTerm *t, int width, int height) {
+	if (t->width == width && t->height == height) {
+		return 1;
+	}
+	if (width < 1 || height < 1) {
+		return 0;
+	}
+	if (width > t->maxWidth || height > t->maxHeight) {
+		return 0;
+	}
+	int slide = t->cur.y - height + 1;
+	if (slide > 0) {
+		_sngTermRotateLines(t->lines, slide, t->maxHeight);
+		if (t->altLines != NULL) {
+			_sngTermRotateLines(t->altLines, slide, t->maxHeight);
+		}
+	}
+	int min_width = _sngTermMin(t->width, width);
+	int min_height = _sngTermMin(t->height, height);
+	t->changed |= SNG_TERM_CHANGED_SCREEN;
+	t->width = width;
+	t->height = height;
 	_sngTermSetScroll(t, 0, height-1);
 	_sngTermMoveTo(t, t->cur.x, t->cur.y);
 	for (size_t i = 0; i < 2; i++) {
@@ -1502,6 +4350,9 @@ b32 sngTermSetSize(SngTerm *t, int width, int height) {
 		if (width > 0 && min_height < height) {
 			_sngTermClear(t, 0, min_height, width-1, height-1);
 		}
+		if (t->altLines == NULL) {
+			break;
+		}
 		_sngTermSwapScreen(t);
 	}
 	// TODO: should we really return 1 in this case?
@@ -1513,6 +4364,1342 @@ b32 sngTermSetSize(SngTerm *t, int width, int height) {
 
 void sngTermUpdate(SngTerm *t, u32 codepoint) {
 	t->state(t, codepoint);
+	_sngTermSyncHold(t);
+}
+
+SngTermCell sngTermCell(const SngTerm *t, int x, int y) {
+	const SngTermCell *line = t->lines[y];
+	const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+	if (x >= info->eraseX) {
+		return info->erase;
+	}
+	return line[x];
+}
+
+const SngTermCell *sngTermLine(SngTerm *t, int y) {
+	SngTermCell *line = t->lines[y];
+	if (!_sngTermLineShared(t, line)) {
+		// the shared blank line has its cells written out already
+		_sngTermLineFill(t, line, t->width);
+	}
+	return line;
+}
+
+int sngTermLineBlank(const SngTerm *t, int y, SngTermCell *blank) {
+	const _SngTermLineInfo *info = _sngTermLineInfoConst(t->lines[y]);
+	*blank = info->erase;
+	return _sngTermMin(info->eraseX, t->width);
+}
+
+void sngTermWrite(SngTerm *t, const void *data, size_t len) {
+	const u8 *p = (const u8 *)data;
+	const u8 *end = p + len;
+	_SNG_TERM_STAT(t, bytes, len);
+	while (p < end) {
+		if (t->state == _sngTermStateParseEscSTR && t->utf8Len == 0) {
+			// Hand the payload over as is, up to the next BEL or ESC. Those
+			// never occur within a UTF-8 sequence, so no decoding needed.
+			const u8 *q = p;
+			while (q < end && *q != '\a' && *q != '\033') {
+				q++;
+			}
+			if (q > p) {
+				_sngTermSTRPut(t, (const char *)p, (size_t)(q - p));
+				p = q;
+				continue;
+			}
+		}
+		if (t->state == _sngTermStateParse && t->utf8Len == 0) {
+			const u8 *q = p;
+			while (q < end && *q >= 0x20 && *q < 0x7f) {
+				q++;
+			}
+			if (q > p) {
+				_sngTermPutRun(t, p, (size_t)(q - p));
+				p = q;
+				continue;
+			}
+		}
+		u32 b = *p++;
+		if (t->utf8Len > 0) {
+			if ((b & 0xc0) == 0x80) {
+				t->utf8 = (t->utf8 << 6) | (b & 0x3f);
+				t->utf8Len--;
+				if (t->utf8Len == 0) {
+					t->state(t, t->utf8);
+				}
+				continue;
+			}
+			// truncated sequence; b starts something new
+			t->utf8Len = 0;
+			t->state(t, 0xfffd);
+		}
+		if (b < 0x80) {
+			t->state(t, b);
+		} else if ((b & 0xe0) == 0xc0) {
+			t->utf8 = b & 0x1f;
+			t->utf8Len = 1;
+		} else if ((b & 0xf0) == 0xe0) {
+			t->utf8 = b & 0x0f;
+			t->utf8Len = 2;
+		} else if ((b & 0xf8) == 0xf0) {
+			t->utf8 = b & 0x07;
+			t->utf8Len = 3;
+		} else {
+			t->state(t, 0xfffd);
+		}
+	}
+	_sngTermSyncHold(t);
+}
+
+void sngTermSetAltAlloc(SngTerm *t, SngTermAllocFunc func, void *user, u32 idleMs) {
+	t->altFunc = func;
+	t->altUser = user;
+	t->altIdleMs = idleMs;
+}
+
+b32 sngTermReleaseIdle(SngTerm *t, u64 nowMs) {
+	if (t->altMem == NULL || (t->mode & SNG_TERM_MODE_ALT_SCREEN)) {
+		return 0;
+	}
+	if (!t->altIdleTimed) {
+		t->altIdleTimed = 1;
+		t->altIdleSince = nowMs;
+	}
+	if (nowMs - t->altIdleSince < t->altIdleMs) {
+		return 0;
+	}
+	sngTermReleaseAlt(t);
+	return 1;
+}
+
+void sngTermReleaseAlt(SngTerm *t) {
+	if (t->altMem == NULL) {
+		return;
+	}
+	if (t->mode & SNG_TERM_MODE_ALT_SCREEN) {
+		_sngTermSwapScreen(t);
+	}
+	t->altFunc(t->altUser, t->altMem, 0);
+	t->altMem = NULL;
+	t->altLines = NULL;
+}
+
+b32 sngTermFrameReady(SngTerm *t, u64 nowMs) {
+	if (t->mode & SNG_TERM_MODE_SYNC) {
+		if (!t->syncTimed) {
+			t->syncTimed = 1;
+			t->syncSince = nowMs;
+		}
+		if (nowMs - t->syncSince >= SNG_TERM_SYNC_TIMEOUT) {
+			_SNG_TERM_EVENT(t, SNG_TERM_EVENT_SYNC_TIMEOUT, (int)(nowMs - t->syncSince));
+			_sngTermSyncEnd(t);
+		}
+	}
+	b32 ready = (t->changed & ~SNG_TERM_CHANGED_OUTPUT) != 0;
+#ifdef SNG_TERM_STATS
+	if (ready) {
+		u64 rows = 0;
+		for (intptr_t y = 0; y < t->height; y++) {
+			rows += t->dirtyLines[y];
+		}
+		t->stats.frames++;
+		t->stats.frameRows += rows;
+		t->stats.frameRowsMax = rows > t->stats.frameRowsMax ? rows : t->stats.frameRowsMax;
+	}
+#endif
+	return ready;
+}
+
+void sngTermRelease(SngTerm *t) {
+	sngTermReleaseAlt(t);
+	if (t->pool == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < 2; i++) {
+		for (intptr_t y = 0; y < t->maxHeight; y++) {
+			_sngTermLineDisown(t, y);
+		}
+		_sngTermSwapScreen(t);
+	}
+}
+
+int sngTermRowsHeld(const SngTerm *t) {
+	return t->rowsHeld;
+}
+
+#define _SNG_TERM_SIZEOF_POOL_ROW(w) \
+	((_SNG_TERM_SIZEOF_LINE(w) + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+size_t sngTermRowPoolSize(int maxWidth, int rows) {
+	// one more for the shared blank line
+	return _SNG_TERM_SIZEOF_POOL_ROW((size_t)maxWidth) * ((size_t)rows + 1);
+}
+
+b32 sngTermRowPoolInit(SngTermRowPool *pool, void *memory, size_t memorySize, int maxWidth) {
+	pool->free = NULL;
+	pool->rowSize = _SNG_TERM_SIZEOF_POOL_ROW((size_t)maxWidth);
+	pool->width = maxWidth;
+	pool->rowsFree = 0;
+	pool->blank = NULL;
+	size_t n = memorySize / pool->rowSize;
+	if (n < 2) {
+		return 0;
+	}
+	SngTermCell blank = _sngTermDefaultCursor().attr;
+	blank.codepoint = ' ';
+	pool->blank = (SngTermCell *)(void *)((u8 *)memory + sizeof(_SngTermLineInfo));
+	_sngTermLineInfo(pool->blank)->eraseX = 0;
+	_sngTermLineInfo(pool->blank)->erase = blank;
+	_sngTermLineInfo(pool->blank)->seq = 0;
+	for (intptr_t x = 0; x < maxWidth; x++) {
+		pool->blank[x] = blank;
+	}
+	for (size_t i = n-1; i > 0; i--) {
+		void **row = (void **)(void *)((u8 *)memory + i * pool->rowSize);
+		*row = pool->free;
+		pool->free = row;
+		pool->rowsFree++;
+	}
+	return 1;
+}
+
+void sngTermAltPoolInit(
+	SngTermAltPool *pool,
+	void *memory, size_t memorySize,
+	int maxWidth, int maxHeight
+) {
+	pool->free = NULL;
+	pool->blockSize = sngTermAltAllocSize(maxWidth, maxHeight);
+	pool->blocksFree = 0;
+	size_t n = memorySize / pool->blockSize;
+	for (size_t i = n; i > 0; i--) {
+		void **block = (void **)(void *)((u8 *)memory + (i-1) * pool->blockSize);
+		*block = pool->free;
+		pool->free = block;
+		pool->blocksFree++;
+	}
+}
+
+void *sngTermAltPoolAlloc(void *user, void *ptr, size_t size) {
+	SngTermAltPool *pool = (SngTermAltPool *)user;
+	if (size == 0) {
+		if (ptr != NULL) {
+			SNG_TERM_POOL_LOCK(pool);
+			*(void **)ptr = pool->free;
+			pool->free = ptr;
+			pool->blocksFree++;
+			SNG_TERM_POOL_UNLOCK(pool);
+		}
+		return NULL;
+	}
+	if (size > pool->blockSize) {
+		return NULL;
+	}
+	SNG_TERM_POOL_LOCK(pool);
+	void **block = (void **)pool->free;
+	if (block != NULL) {
+		pool->free = *block;
+		pool->blocksFree--;
+	}
+	SNG_TERM_POOL_UNLOCK(pool);
+	return block;
+}
+
+size_t sngTermOutputPeek(const SngTerm *t, const char **data) {
+	u32 head = t->outputHead & (SNG_TERM_OUTPUT_SIZE - 1);
+	u32 len = t->outputTail - t->outputHead;
+	*data = &t->output[head];
+	if (len > SNG_TERM_OUTPUT_SIZE - head) {
+		len = SNG_TERM_OUTPUT_SIZE - head;
+	}
+	return len;
+}
+
+void sngTermOutputConsume(SngTerm *t, size_t n) {
+	u32 len = t->outputTail - t->outputHead;
+	if (n > len) {
+		n = len;
+	}
+	t->outputHead += (u32)n;
+}
+
+b32 sngTermOutputPut(SngTerm *t, const char *data, size_t len) {
+	u32 used = t->outputTail - t->outputHead;
+	if (len > SNG_TERM_OUTPUT_SIZE - used) {
+		_SNG_TERM_EVENT(t, SNG_TERM_EVENT_OUTPUT_FULL, (int)len);
+		return 0;
+	}
+	for (size_t i = 0; i < len; i++) {
+		t->output[(t->outputTail + i) & (SNG_TERM_OUTPUT_SIZE - 1)] = data[i];
+	}
+	t->outputTail += (u32)len;
+	t->changed |= SNG_TERM_CHANGED_OUTPUT;
+	return 1;
+}
+
+void sngTermSetStrFunc(SngTerm *t, SngTermStrFunc func, void *user) {
+	t->strFunc = func;
+	t->strUser = user;
+}
+
+// _sngTermBase64Value returns the 6 bit value of c plus one, or zero if
+// c is outside the base64 alphabet.
+static u32 _sngTermBase64Value(u8 c) {
+	if (c >= 'A' && c <= 'Z') {
+		return (u32)(c - 'A') + 1;
+	}
+	if (c >= 'a' && c <= 'z') {
+		return (u32)(c - 'a') + 27;
+	}
+	if (c >= '0' && c <= '9') {
+		return (u32)(c - '0') + 53;
+	}
+	if (c == '+') {
+		return 63;
+	}
+	if (c == '/') {
+		return 64;
+	}
+	return 0;
+}
+
+size_t sngTermBase64Decode(SngTermBase64 *b, const char *src, size_t len, u8 *dest) {
+	u32 bits = b->bits;
+	int bitsLen = b->bitsLen;
+	u8 *d = dest;
+	for (size_t i = 0; i < len; i++) {
+		u32 v = _sngTermBase64Value((u8)src[i]);
+		if (v == 0) {
+			continue;
+		}
+		bits = (bits << 6) | (v - 1);
+		bitsLen += 6;
+		if (bitsLen >= 8) {
+			bitsLen -= 8;
+			*d++ = (u8)(bits >> bitsLen);
+		}
+	}
+	b->bits = bits & ((1u << bitsLen) - 1);
+	b->bitsLen = bitsLen;
+	return (size_t)(d - dest);
+}
+
+#ifdef SNG_TERM_DIAGNOSTICS
+
+void sngTermSetEventFunc(SngTerm *t, SngTermEventFunc func, void *user) {
+	t->eventFunc = func;
+	t->eventUser = user;
+}
+
+u32 sngTermEventCount(const SngTerm *t, int event) {
+	if (event < 0 || event >= SNG_TERM_EVENT_COUNT) {
+		return 0;
+	}
+	return t->events[event];
+}
+
+const char *sngTermEventName(int event) {
+	switch (event) {
+		case SNG_TERM_EVENT_UNKNOWN_ESC: return "unknown escape sequence";
+		case SNG_TERM_EVENT_UNKNOWN_CHARSET: return "unknown charset";
+		case SNG_TERM_EVENT_UNKNOWN_CSI: return "unknown CSI sequence";
+		case SNG_TERM_EVENT_UNEXPECTED_CSI_ARGS: return "unexpected CSI args";
+		case SNG_TERM_EVENT_BAD_CSI: return "malformed CSI sequence";
+		case SNG_TERM_EVENT_UNKNOWN_MODE: return "unknown mode";
+		case SNG_TERM_EVENT_UNKNOWN_PRIVATE_MODE: return "unknown private mode";
+		case SNG_TERM_EVENT_UNSUPPORTED_MODE: return "unsupported mode";
+		case SNG_TERM_EVENT_UNKNOWN_SGR: return "unknown SGR attribute";
+		case SNG_TERM_EVENT_BAD_SGR_COLOR: return "malformed SGR color";
+		case SNG_TERM_EVENT_UNKNOWN_OSC: return "unknown OSC command";
+		case SNG_TERM_EVENT_UNKNOWN_STR: return "unknown STR sequence";
+		case SNG_TERM_EVENT_NO_ALT_SCREEN: return "alternate screen unavailable";
+		case SNG_TERM_EVENT_NO_ROW: return "row quota or pool exhausted";
+		case SNG_TERM_EVENT_OUTPUT_FULL: return "output buffer full";
+		case SNG_TERM_EVENT_SYNC_TIMEOUT: return "synchronized update timed out";
+	}
+	return "unknown event";
+}
+
+#endif // SNG_TERM_DIAGNOSTICS
+
+#ifdef SNG_TERM_STATS
+
+void sngTermGetStats(const SngTerm *t, SngTermStats *stats) {
+	*stats = t->stats;
+}
+
+void sngTermResetStats(SngTerm *t) {
+	memset(&t->stats, 0, sizeof(t->stats));
+}
+
+#ifdef SNG_TERM_STATS_CYCLES
+const char *sngTermTimerName(int timer) {
+	switch (timer) {
+		case SNG_TERM_TIMER_CHARS: return "characters";
+		case SNG_TERM_TIMER_CSI: return "CSI sequences";
+		case SNG_TERM_TIMER_STR: return "string sequences";
+		case SNG_TERM_TIMER_SCROLL: return "scrolling";
+	}
+	return "unknown timer";
+}
+#endif
+
+#endif // SNG_TERM_STATS
+
+int sngTermLineRun(const SngTerm *t, int y, int x, SngTermRun *run, char *text, size_t textSize) {
+	if (y < 0 || y >= t->height || x < 0 || x >= t->width) {
+		return 0;
+	}
+	const SngTermCell *line = t->lines[y];
+	const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+	int eraseX = _sngTermMin(info->eraseX, t->width);
+	const SngTermCell *first = x < eraseX ? &line[x] : &info->erase;
+	int end = t->width;
+	if (x < eraseX) {
+		end = _sngTermRunsNext(_sngTermLineRunsConst(t, line), x+1, eraseX);
+		if (end == eraseX && _sngTermSameStyle(first, &info->erase)) {
+			end = t->width;
+		}
+	}
+	run->x = x;
+	u32 screen = (t->mode & SNG_TERM_MODE_REVERSE) ? SNG_TERM_ATTR_REVERSE : 0;
+	_sngTermResolveColors(first, screen, &run->fg, &run->bg);
+	run->attr = first->attr & (u16)~_SNG_TERM_ATTR_NOT_STYLE;
+	run->textLen = 0;
+	if (text != NULL) {
+		for (int i = x; i < end; i++) {
+			const SngTermCell *cell = i < eraseX ? &line[i] : &info->erase;
+			if (cell->codepoint < 0x80 && cell->codepoint != 0 && cell->marks == 0) {
+				if (run->textLen < textSize) {
+					text[run->textLen++] = (char)cell->codepoint;
+					continue;
+				}
+				if (i > x) {
+					end = i;
+					break;
+				}
+				continue;
+			}
+			if (cell->attr & SNG_TERM_ATTR_WIDE_SPACER) {
+				continue;
+			}
+			char buf[SNG_TERM_RUN_TEXT_MIN];
+			int n = _sngTermUTF8Encode(cell->codepoint != 0 ? cell->codepoint : ' ', buf);
+			u32 marks[2];
+			int marksLen = sngTermCellMarks(t, cell, marks);
+			for (int m = 0; m < marksLen; m++) {
+				n += _sngTermUTF8Encode(marks[m], &buf[n]);
+			}
+			if (run->textLen + (size_t)n > textSize) {
+				if (i > x) {
+					end = i;
+					break;
+				}
+				n = 0;
+			}
+			memcpy(&text[run->textLen], buf, (size_t)n);
+			run->textLen += (size_t)n;
+		}
+	}
+	run->width = end - x;
+	return end;
+}
+
+// _sngTermCopyASCII copies codepoints from cells to dest for as long as
+// they are ASCII without combining marks, up to n, and returns how many
+// were copied.
+static int _sngTermCopyASCII(const SngTermCell *cells, int n, char *dest) {
+	int i = 0;
+#ifdef __SSE2__
+	// 8 cells per step, in 6 loads. Each cell is 3 words: the codepoint,
+	// the colors, then attr and marks.
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ones = _mm_set1_epi32(-1);
+	const __m128i ascii = _mm_set1_epi32(0x7f);
+	const __m128i marksMask = _mm_set1_epi32((int)0xffff0000);
+	for (; i + 8 <= n; i += 8) {
+		const __m128 *p = (const __m128 *)(const void *)&cells[i];
+		__m128i cps[2];
+		__m128i bad = zero;
+		for (int j = 0; j < 2; j++) {
+			__m128 a = _mm_loadu_ps((const float *)(const void *)&p[3*j+0]);
+			__m128 b = _mm_loadu_ps((const float *)(const void *)&p[3*j+1]);
+			__m128 c = _mm_loadu_ps((const float *)(const void *)&p[3*j+2]);
+			__m128 cp01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 2, 3, 0));
+			__m128 cp23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+			__m128 am01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+			__m128 am23 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+			cps[j] = _mm_castps_si128(_mm_shuffle_ps(cp01, cp23, _MM_SHUFFLE(2, 0, 1, 0)));
+			__m128i am = _mm_castps_si128(_mm_shuffle_ps(am01, am23, _MM_SHUFFLE(2, 0, 2, 0)));
+			__m128i noMarks = _mm_cmpeq_epi32(_mm_and_si128(am, marksMask), zero);
+			bad = _mm_or_si128(bad, _mm_cmpeq_epi32(cps[j], zero));
+			bad = _mm_or_si128(bad, _mm_cmpgt_epi32(cps[j], ascii));
+			bad = _mm_or_si128(bad, _mm_xor_si128(noMarks, ones));
+		}
+		if (_mm_movemask_epi8(bad) != 0) {
+			break;
+		}
+		__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(cps[0], cps[1]), zero);
+		_mm_storel_epi64((__m128i *)(void *)&dest[i], bytes);
+	}
+#endif
+	for (; i < n; i++) {
+		u32 c = cells[i].codepoint;
+		if (c == 0 || c >= 0x80 || cells[i].marks != 0) {
+			break;
+		}
+		dest[i] = (char)c;
+	}
+	return i;
+}
+
+// _SngTermTextWriter collects the output of sngTermCopyText. Once
+// something does not fit, written stops while len goes on.
+typedef struct {
+	char *buf;
+	size_t cap;     // bytes that may be written, before the '\0'
+	size_t written;
+	size_t len;     // length of the whole text
+} _SngTermTextWriter;
+
+static void _sngTermTextPut(_SngTermTextWriter *w, const char *s, size_t n) {
+	if (w->written == w->len && w->len + n <= w->cap) {
+		memcpy(&w->buf[w->len], s, n);
+		w->written += n;
+	}
+	w->len += n;
+}
+
+// _sngTermTextCells puts cells x0 through x1-1 of line, where cells from
+// eraseX on are erase.
+static void _sngTermTextCells(
+	const SngTerm *t, _SngTermTextWriter *w,
+	const SngTermCell *line, int x0, int x1
+) {
+	const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+	int eraseX = _sngTermMin(info->eraseX, t->width);
+	for (int x = x0; x < x1;) {
+		const SngTermCell *cell = x < eraseX ? &line[x] : &info->erase;
+		if (x < eraseX && w->written == w->len) {
+			int n = _sngTermMin(x1, eraseX) - x;
+			if ((size_t)n > w->cap - w->written) {
+				n = (int)(w->cap - w->written);
+			}
+			n = _sngTermCopyASCII(cell, n, &w->buf[w->written]);
+			w->written += (size_t)n;
+			w->len += (size_t)n;
+			x += n;
+			if (n > 0) {
+				continue;
+			}
+		}
+		x++;
+		if (cell->attr & SNG_TERM_ATTR_WIDE_SPACER) {
+			continue;
+		}
+		char buf[SNG_TERM_RUN_TEXT_MIN];
+		int n = _sngTermUTF8Encode(cell->codepoint != 0 ? cell->codepoint : ' ', buf);
+		u32 marks[2];
+		int marksLen = sngTermCellMarks(t, cell, marks);
+		for (int m = 0; m < marksLen; m++) {
+			n += _sngTermUTF8Encode(marks[m], &buf[n]);
+		}
+		_sngTermTextPut(w, buf, (size_t)n);
+	}
+}
+
+size_t sngTermCopyText(const SngTerm *t, int x0, int y0, int x1, int y1, char *buf, size_t len) {
+	if (y0 > y1 || (y0 == y1 && x0 > x1)) {
+		int tmp = x0;
+		x0 = x1;
+		x1 = tmp;
+		tmp = y0;
+		y0 = y1;
+		y1 = tmp;
+	}
+	_SngTermTextWriter w = {};
+	w.buf = buf;
+	w.cap = len > 0 ? len-1 : 0;
+	if (t->width > 0 && t->height > 0) {
+		x0 = _sngTermClamp(x0, 0, t->width-1);
+		x1 = _sngTermClamp(x1, 0, t->width-1);
+		y0 = _sngTermClamp(y0, 0, t->height-1);
+		y1 = _sngTermClamp(y1, 0, t->height-1);
+		for (int y = y0; y <= y1; y++) {
+			const SngTermCell *line = t->lines[y];
+			const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+			int eraseX = _sngTermMin(info->eraseX, t->width);
+			int start = y == y0 ? x0 : 0;
+			int end = y == y1 ? x1+1 : t->width;
+			b32 wrapped =
+				y < y1 && end == t->width && eraseX == t->width &&
+				(line[t->width-1].attr & SNG_TERM_ATTR_WRAP) != 0;
+			if (!wrapped) {
+				// Cells from eraseX on are all the erase cell, usually blank.
+				const SngTermCell *erase = &info->erase;
+				if ((erase->codepoint == ' ' || erase->codepoint == 0) && erase->marks == 0) {
+					end = _sngTermMax(start, _sngTermMin(end, eraseX));
+				}
+				while (
+					end > start && end <= eraseX &&
+					(line[end-1].codepoint == ' ' || (line[end-1].attr & SNG_TERM_ATTR_WIDE_SPACER)) &&
+					line[end-1].marks == 0
+				) {
+					end--;
+				}
+			}
+			_sngTermTextCells(t, &w, line, start, end);
+			if (!wrapped && y < y1) {
+				_sngTermTextPut(&w, "\n", 1);
+			}
+		}
+	}
+	if (len > 0) {
+		buf[w.written] = 0;
+	}
+	return w.len;
+}
+
+struct SngTermSearch {
+	const SngTerm *term; // terminal rowSeq was taken from, if any
+	u32 *rowSeq;         // _SngTermLineInfo.seq of each row searched
+	u32 *lastSeq;        // rowSeq of the search before
+	char *text;          // a row as ASCII, while it is all ASCII
+	u32 *cps;            // a row as codepoints, otherwise
+	int *xs;             // column of each of cps
+	int maxWidth, maxHeight;
+	int seqLen; // rows in rowSeq
+	int patternLen;
+	b32 patternASCII;
+	u8 _pad[4];
+	char ascii[SNG_TERM_SEARCH_MAX]; // pattern, if patternASCII
+	u32 pattern[SNG_TERM_SEARCH_MAX];
+};
+
+#define _SNG_TERM_SIZEOF_SEARCH \
+	((sizeof(SngTermSearch) + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+size_t sngTermSearchSize(int maxWidth, int maxHeight) {
+	size_t w = _SNG_TERM_SIZEOF_W(maxWidth);
+	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
+	return _SNG_TERM_SIZEOF_SEARCH + 2*sizeof(u32)*h + w + sizeof(u32)*w + sizeof(int)*w;
+}
+
+SngTermSearch *sngTermSearchInit(
+	void *memory, size_t memorySize,
+	int maxWidth, int maxHeight,
+	const char *pattern, size_t len
+) {
+	if (memorySize < sngTermSearchSize(maxWidth, maxHeight)) {
+		return NULL;
+	}
+	memset(memory, 0, memorySize);
+	size_t w = _SNG_TERM_SIZEOF_W(maxWidth);
+	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
+	u8 *p = (u8 *)memory;
+	SngTermSearch *s = (SngTermSearch *)memory;
+	p += _SNG_TERM_SIZEOF_SEARCH;
+	s->rowSeq = (u32 *)(void *)p;
+	p += sizeof(u32)*h;
+	s->lastSeq = (u32 *)(void *)p;
+	p += sizeof(u32)*h;
+	s->cps = (u32 *)(void *)p;
+	p += sizeof(u32)*w;
+	s->xs = (int *)(void *)p;
+	p += sizeof(int)*w;
+	s->text = (char *)p;
+	s->maxWidth = maxWidth;
+	s->maxHeight = maxHeight;
+	s->patternASCII = 1;
+	// decoded as sngTermWrite does, bad sequences becoming U+FFFD
+	const u8 *b = (const u8 *)pattern;
+	const u8 *end = b + len;
+	while (b < end) {
+		u32 c = *b++;
+		int more = 0;
+		if ((c & 0xe0) == 0xc0) {
+			c &= 0x1f;
+			more = 1;
+		} else if ((c & 0xf0) == 0xe0) {
+			c &= 0x0f;
+			more = 2;
+		} else if ((c & 0xf8) == 0xf0) {
+			c &= 0x07;
+			more = 3;
+		} else if (c >= 0x80) {
+			c = 0xfffd;
+		}
+		for (; more > 0; more--) {
+			if (b == end || (*b & 0xc0) != 0x80) {
+				c = 0xfffd;
+				break;
+			}
+			c = (c << 6) | (*b++ & 0x3f);
+		}
+		if (s->patternLen == SNG_TERM_SEARCH_MAX) {
+			return NULL;
+		}
+		if (c >= 0x80) {
+			s->patternASCII = 0;
+		}
+		s->ascii[s->patternLen] = (char)c;
+		s->pattern[s->patternLen++] = c;
+	}
+	if (s->patternLen == 0) {
+		return NULL;
+	}
+	return s;
+}
+
+// _sngTermFindASCII returns the index of the first copy of p, m bytes
+// long, in text from index i on, or -1 if there is none.
+static int _sngTermFindASCII(const char *text, int n, int i, const char *p, int m) {
+#ifdef __SSE2__
+	// Test 16 places at once for the first and last byte of p, then check
+	// the few that have both.
+	const __m128i first = _mm_set1_epi8(p[0]);
+	const __m128i last = _mm_set1_epi8(p[m-1]);
+	for (; i + m-1 + 16 <= n; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(const void *)&text[i]);
+		__m128i b = _mm_loadu_si128((const __m128i *)(const void *)&text[i + m-1]);
+		int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+		for (int j = i; mask != 0; j++, mask >>= 1) {
+			if ((mask & 1) && memcmp(&text[j], p, (size_t)m) == 0) {
+				return j;
+			}
+		}
+	}
+#endif
+	for (; i + m <= n; i++) {
+		const char *q = (const char *)memchr(&text[i], p[0], (size_t)(n - m + 1 - i));
+		if (q == NULL) {
+			break;
+		}
+		i = (int)(q - text);
+		if (memcmp(q, p, (size_t)m) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// _sngTermSearchRow finds the pattern of s on line y, storing matches
+// from index count on, and returns the new count.
+static int _sngTermSearchRow(
+	SngTermSearch *s, const SngTerm *t, int y,
+	SngTermMatch *matches, int matchesLen, int count
+) {
+	const SngTermCell *line = t->lines[y];
+	const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+	int width = _sngTermMin(t->width, s->maxWidth);
+	int eraseX = _sngTermMin(info->eraseX, width);
+	int m = s->patternLen;
+	u32 erase = info->erase.codepoint != 0 ? info->erase.codepoint : ' ';
+	int n = _sngTermCopyASCII(line, eraseX, s->text);
+	if (n == eraseX && erase < 0x80 && info->erase.marks == 0) {
+		if (!s->patternASCII) {
+			return count;
+		}
+		memset(&s->text[eraseX], (int)erase, (size_t)(width - eraseX));
+		for (int i = 0; (i = _sngTermFindASCII(s->text, width, i, s->ascii, m)) >= 0; i += m) {
+			if (count < matchesLen) {
+				matches[count].x = i;
+				matches[count].y = y;
+			}
+			count++;
+		}
+		return count;
+	}
+	// Not all ASCII, so compare codepoints.
+	n = 0;
+	for (int x = 0; x < width; x++) {
+		const SngTermCell *cell = x < eraseX ? &line[x] : &info->erase;
+		if (cell->attr & SNG_TERM_ATTR_WIDE_SPACER) {
+			continue;
+		}
+		s->cps[n] = cell->codepoint != 0 ? cell->codepoint : ' ';
+		s->xs[n++] = x;
+	}
+	for (int i = 0; i + m <= n;) {
+		int j = 0;
+		while (j < m && s->cps[i+j] == s->pattern[j]) {
+			j++;
+		}
+		if (j < m) {
+			i++;
+			continue;
+		}
+		if (count < matchesLen) {
+			matches[count].x = s->xs[i];
+			matches[count].y = y;
+		}
+		count++;
+		i += m;
+	}
+	return count;
+}
+
+int sngTermSearch(
+	SngTermSearch *s, const SngTerm *t, int flags,
+	SngTermMatch *matches, int matchesLen
+) {
+	b32 changedOnly = (flags & SNG_TERM_SEARCH_CHANGED) && s->term == t;
+	u32 *last = s->rowSeq;
+	s->rowSeq = s->lastSeq;
+	s->lastSeq = last;
+	int lastHeight = s->term == t ? s->seqLen : 0;
+	s->term = t;
+	s->seqLen = _sngTermMin(t->height, s->maxHeight);
+	int count = 0;
+	// Rows that only moved keep their seq, so look for each where the
+	// row before it was found; after a scroll, that is the same offset.
+	int shift = 0;
+	for (int y = 0; y < s->seqLen; y++) {
+		u32 seq = _sngTermLineInfoConst(t->lines[y])->seq;
+		s->rowSeq[y] = seq;
+		if (changedOnly) {
+			int i = y + shift;
+			if (i < 0 || i >= lastHeight || last[i] != seq) {
+				i = 0;
+				while (i < lastHeight && last[i] != seq) {
+					i++;
+				}
+			}
+			if (i < lastHeight) {
+				shift = i - y;
+				continue;
+			}
+		}
+		count = _sngTermSearchRow(s, t, y, matches, matchesLen, count);
+	}
+	return count;
+}
+
+// _sngTermMarksLookup looks up the marks of cell in a markTable.
+static int _sngTermMarksLookup(const u32 (*markTable)[2], const SngTermCell *cell, u32 *marks) {
+	if (cell->marks == 0) {
+		return 0;
+	}
+	const u32 *m = markTable[(cell->marks - 1) & (SNG_TERM_MARKS_TABLE_SIZE - 1)];
+	marks[0] = m[0];
+	if (m[1] == 0) {
+		return 1;
+	}
+	marks[1] = m[1];
+	return 2;
+}
+
+// _sngTermColorRGB looks up color in the palette or an rgb table.
+static b32 _sngTermColorRGB(const u32 *rgbTable, u16 color, u32 *rgb) {
+	if (color < 256) {
+		*rgb = _sngTermPaletteRGB(color);
+		return 1;
+	}
+	if (color == SNG_TERM_COLOR_DEFAULT_FG || color == SNG_TERM_COLOR_DEFAULT_BG) {
+		return 0;
+	}
+	*rgb = rgbTable[color & (SNG_TERM_RGB_TABLE_SIZE - 1)] & 0xffffff;
+	return 1;
+}
+
+int sngTermCellMarks(const SngTerm *t, const SngTermCell *cell, u32 *marks) {
+	return _sngTermMarksLookup(t->markTable, cell, marks);
+}
+
+void sngTermResolveColors(const SngTermCell *cells, int len, s32 mode, u16 *fg, u16 *bg) {
+	u32 screen = (mode & SNG_TERM_MODE_REVERSE) ? SNG_TERM_ATTR_REVERSE : 0;
+	for (intptr_t i = 0; i < len; i++) {
+		_sngTermResolveColors(&cells[i], screen, &fg[i], &bg[i]);
+	}
+}
+
+b32 sngTermColorRGB(const SngTerm *t, u16 color, u32 *rgb) {
+	return _sngTermColorRGB(t->rgb, color, rgb);
+}
+
+struct SngTermSnapshot {
+	SngTermCell *cells; // row y starts at cells[y*stride]
+	u32 *seq;           // _SngTermLineInfo.seq of each row copied
+	b8 *dirty;          // rows that differ from the snapshot acquired before
+	SngTermCursor cur;
+	int width, height;
+	int stride;
+	s32 mode;
+	// rgb and markTable are copied when tableSeq differs from the
+	// terminal's.
+	u32 tableSeq;
+	u8 _pad[4];
+	char title[256];
+	u32 rgb[SNG_TERM_RGB_TABLE_SIZE];
+	u32 markTable[SNG_TERM_MARKS_TABLE_SIZE][2];
+};
+
+// _SNG_TERM_SNAPSHOT_FRESH is set in SngTermSnapshots.middle when it holds
+// a snapshot that has not been acquired.
+#define _SNG_TERM_SNAPSHOT_FRESH 4
+
+// SngTermSnapshots is a triple buffer. The publishing thread owns back,
+// the rendering thread owns front, and they trade their snapshot for the
+// one in middle with an atomic exchange.
+struct SngTermSnapshots {
+	SngTermSnapshot snaps[3];
+	u32 middle; // index in snaps, or'd with _SNG_TERM_SNAPSHOT_FRESH
+	int back;
+	int front;
+	// acquiredWidth, acquiredHeight and acquiredSeq are the snapshot
+	// acquired before, for the rendering thread to find dirty rows.
+	int acquiredWidth, acquiredHeight;
+	u8 _pad[4];
+	u32 *acquiredSeq;
+};
+
+#define _SNG_TERM_SIZEOF_SNAPSHOTS \
+	((sizeof(SngTermSnapshots) + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+#define _SNG_TERM_SIZEOF_SNAPSHOT_CELLS(w, h) \
+	((sizeof(SngTermCell)*(w)*(h) + _SNG_TERM_PTR_ALIGN) & ~_SNG_TERM_PTR_ALIGN)
+
+size_t sngTermSnapshotsSize(int maxWidth, int maxHeight) {
+	size_t w = (size_t)maxWidth;
+	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
+	size_t snap = _SNG_TERM_SIZEOF_SNAPSHOT_CELLS(w, h) + sizeof(u32)*h + h;
+	return _SNG_TERM_SIZEOF_SNAPSHOTS + 3*snap + sizeof(u32)*h;
+}
+
+SngTermSnapshots *sngTermSnapshotsInit(void *memory, size_t memorySize, int maxWidth, int maxHeight) {
+	if (memorySize < sngTermSnapshotsSize(maxWidth, maxHeight)) {
+		return NULL;
+	}
+	memset(memory, 0, memorySize);
+	size_t w = (size_t)maxWidth;
+	size_t h = _SNG_TERM_SIZEOF_H(maxHeight);
+	SngTermSnapshots *s = (SngTermSnapshots *)memory;
+	u8 *p = (u8 *)memory + _SNG_TERM_SIZEOF_SNAPSHOTS;
+	for (int i = 0; i < 3; i++) {
+		SngTermSnapshot *snap = &s->snaps[i];
+		snap->cells = (SngTermCell *)(void *)p;
+		p += _SNG_TERM_SIZEOF_SNAPSHOT_CELLS(w, h);
+		snap->seq = (u32 *)(void *)p;
+		p += sizeof(u32)*h;
+		snap->dirty = (b8 *)p;
+		p += h;
+		snap->stride = maxWidth;
+	}
+	s->acquiredSeq = (u32 *)(void *)p;
+	s->back = 0;
+	s->middle = 1;
+	s->front = 2;
+	return s;
+}
+
+void sngTermPublish(SngTermSnapshots *s, const SngTerm *t) {
+	SngTermSnapshot *snap = &s->snaps[s->back];
+	b32 resized = snap->width != t->width || snap->height != t->height;
+	snap->width = t->width;
+	snap->height = t->height;
+	for (int y = 0; y < t->height; y++) {
+		const SngTermCell *line = t->lines[y];
+		const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+		if (!resized && snap->seq[y] == info->seq) {
+			continue;
+		}
+		snap->seq[y] = info->seq;
+		SngTermCell *dest = &snap->cells[(size_t)y * (size_t)snap->stride];
+		int eraseX = _sngTermMin(info->eraseX, t->width);
+		memcpy(dest, line, sizeof(SngTermCell)*(size_t)eraseX);
+		for (int x = eraseX; x < t->width; x++) {
+			dest[x] = info->erase;
+		}
+	}
+	snap->cur = t->cur;
+	snap->mode = t->mode;
+	memcpy(snap->title, t->title, sizeof(snap->title));
+	if (snap->tableSeq != t->tableSeq) {
+		snap->tableSeq = t->tableSeq;
+		memcpy(snap->rgb, t->rgb, sizeof(snap->rgb));
+		memcpy(snap->markTable, t->markTable, sizeof(snap->markTable));
+	}
+	// Release the snapshot to the renderer, and take whichever was
+	// waiting, or the one it just let go of.
+	u32 old = __atomic_exchange_n(
+		&s->middle, (u32)s->back | _SNG_TERM_SNAPSHOT_FRESH, __ATOMIC_ACQ_REL
+	);
+	s->back = (int)(old & 3);
+}
+
+const SngTermSnapshot *sngTermSnapshotAcquire(SngTermSnapshots *s) {
+	if (!(__atomic_load_n(&s->middle, __ATOMIC_RELAXED) & _SNG_TERM_SNAPSHOT_FRESH)) {
+		return NULL;
+	}
+	u32 old = __atomic_exchange_n(&s->middle, (u32)s->front, __ATOMIC_ACQ_REL);
+	s->front = (int)(old & 3);
+	SngTermSnapshot *snap = &s->snaps[s->front];
+	b32 resized = snap->width != s->acquiredWidth || snap->height != s->acquiredHeight;
+	s->acquiredWidth = snap->width;
+	s->acquiredHeight = snap->height;
+	for (int y = 0; y < snap->height; y++) {
+		snap->dirty[y] = resized || snap->seq[y] != s->acquiredSeq[y];
+		s->acquiredSeq[y] = snap->seq[y];
+	}
+	return snap;
+}
+
+const SngTermCell *sngTermSnapshotLine(const SngTermSnapshot *snap, int y) {
+	return &snap->cells[(size_t)y * (size_t)snap->stride];
+}
+
+int sngTermSnapshotCellMarks(const SngTermSnapshot *snap, const SngTermCell *cell, u32 *marks) {
+	return _sngTermMarksLookup(snap->markTable, cell, marks);
+}
+
+b32 sngTermSnapshotColorRGB(const SngTermSnapshot *snap, u16 color, u32 *rgb) {
+	return _sngTermColorRGB(snap->rgb, color, rgb);
+}
+
+// _SNG_TERM_SAVE_MAGIC is "SNGT" in the first bytes of sngTermSave's
+// output on little endian machines, and _SNG_TERM_SAVE_VERSION changes
+// whenever the layout does.
+#define _SNG_TERM_SAVE_MAGIC 0x54474e53
+#define _SNG_TERM_SAVE_VERSION 2
+
+// _sngTermStates lists the parser states, so a save can name one by its
+// index.
+static const _SngTermState _sngTermStates[] = {
+	_sngTermStateParse,
+	_sngTermStateParseEsc,
+	_sngTermStateParseEscAltCharset,
+	_sngTermStateParseEscCSI,
+	_sngTermStateParseEscSTR,
+	_sngTermStateParseEscSTREnd,
+	_sngTermStateParseEscTest,
+};
+
+// _SngTermSaveHeader begins the output of sngTermSave. It is followed by
+// the title, width bytes of tabs, the rgb and mark tables, the CSI or STR
+// state of the parser, then each screen, visible first: height rows of a
+// _SngTermSaveRow, its cells before eraseX, and their run bits.
+typedef struct {
+	u32 magic;
+	u32 version;
+	int width, height;
+	int top, bottom;
+	s32 mode;
+	s32 syncChanged;
+	SngTermCursor cur;
+	SngTermCursor curSaved;
+	int rgbLen;
+	int markTableLen;
+	u32 state; // index in _sngTermStates
+	u32 utf8;
+	int utf8Len;
+	int screens; // 2 if the alternate screen was saved too
+} _SngTermSaveHeader;
+
+typedef struct {
+	int eraseX;
+	SngTermCell erase;
+} _SngTermSaveRow;
+
+#define _SNG_TERM_SIZEOF_SAVE_FIXED(w) \
+	(sizeof(_SngTermSaveHeader) + sizeof(((SngTerm *)0)->title) + (size_t)(w) + \
+	sizeof(((SngTerm *)0)->rgb) + sizeof(((SngTerm *)0)->markTable) + \
+	sizeof(_SngTermSTR))
+
+size_t sngTermSaveSize(int maxWidth, int maxHeight) {
+	size_t row =
+		sizeof(_SngTermSaveRow) + sizeof(SngTermCell)*(size_t)maxWidth +
+		_SNG_TERM_SIZEOF_RUNS(maxWidth);
+	return _SNG_TERM_SIZEOF_SAVE_FIXED(maxWidth) + 2*row*(size_t)maxHeight;
+}
+
+static void _sngTermSaveLines(const SngTerm *t, _SngTermTextWriter *w, SngTermCell **lines) {
+	for (int y = 0; y < t->height; y++) {
+		const SngTermCell *line = lines[y];
+		const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+		_SngTermSaveRow row;
+		row.eraseX = _sngTermMin(info->eraseX, t->width);
+		row.erase = info->erase;
+		_sngTermTextPut(w, (const char *)&row, sizeof(row));
+		_sngTermTextPut(w, (const char *)line, sizeof(SngTermCell)*(size_t)row.eraseX);
+		// Bits from eraseX on are stale, and saved as zero, so that equal
+		// states save equal bytes.
+		const u32 *runs = _sngTermLineRunsConst(t, line);
+		size_t words = (size_t)row.eraseX / 32;
+		_sngTermTextPut(w, (const char *)runs, sizeof(u32)*words);
+		if (row.eraseX % 32 != 0) {
+			u32 last = runs[words] & ((1u << (row.eraseX % 32)) - 1);
+			_sngTermTextPut(w, (const char *)&last, sizeof(last));
+		}
+	}
+}
+
+size_t sngTermSave(const SngTerm *t, void *buf, size_t len) {
+	_SngTermTextWriter w = {};
+	w.buf = (char *)buf;
+	w.cap = len;
+	_SngTermSaveHeader h;
+	memset(&h, 0, sizeof(h));
+	h.magic = _SNG_TERM_SAVE_MAGIC;
+	h.version = _SNG_TERM_SAVE_VERSION;
+	h.width = t->width;
+	h.height = t->height;
+	h.top = t->top;
+	h.bottom = t->bottom;
+	h.mode = t->mode;
+	h.syncChanged = t->syncChanged;
+	h.cur = t->cur;
+	h.curSaved = t->cur_saved;
+	h.rgbLen = t->rgbLen;
+	h.markTableLen = t->markTableLen;
+	for (u32 i = 0; i < sizeof(_sngTermStates) / sizeof(_sngTermStates[0]); i++) {
+		if (_sngTermStates[i] == t->state) {
+			h.state = i;
+		}
+	}
+	h.utf8 = t->utf8;
+	h.utf8Len = t->utf8Len;
+	h.screens = t->altLines != NULL ? 2 : 1;
+	_sngTermTextPut(&w, (const char *)&h, sizeof(h));
+	_sngTermTextPut(&w, t->title, sizeof(t->title));
+	_sngTermTextPut(&w, (const char *)t->tabs, (size_t)t->width);
+	_sngTermTextPut(&w, (const char *)t->rgb, sizeof(t->rgb));
+	_sngTermTextPut(&w, (const char *)t->markTable, sizeof(t->markTable));
+	// The parser's union is saved whole, as its larger member. STR
+	// arguments point into the terminal, and are only set while a sequence
+	// is handled, so they are left out.
+	_SngTermSTR str = t->str;
+	memset(str.args, 0, sizeof(str.args));
+	_sngTermTextPut(&w, (const char *)&str, sizeof(str));
+	_sngTermSaveLines(t, &w, t->lines);
+	if (t->altLines != NULL) {
+		_sngTermSaveLines(t, &w, t->altLines);
+	}
+	return w.len;
+}
+
+// _sngTermLoadLines restores height rows of a screen from p into t->lines,
+// or only checks them when apply is zero. Returns the end of the rows, or
+// NULL if they run past end or do not fit.
+static const u8 *_sngTermLoadLines(SngTerm *t, const u8 *p, const u8 *end, int width, int height, b32 apply) {
+	for (intptr_t y = 0; y < height; y++) {
+		_SngTermSaveRow row;
+		if ((size_t)(end - p) < sizeof(row)) {
+			return NULL;
+		}
+		memcpy(&row, p, sizeof(row));
+		p += sizeof(row);
+		if (row.eraseX < 0 || row.eraseX > width) {
+			return NULL;
+		}
+		size_t cellsSize = sizeof(SngTermCell)*(size_t)row.eraseX;
+		size_t runsSize = _SNG_TERM_SIZEOF_RUNS(row.eraseX);
+		if ((size_t)(end - p) < cellsSize + runsSize) {
+			return NULL;
+		}
+		const u8 *cells = p;
+		p += cellsSize + runsSize;
+		if (!apply) {
+			continue;
+		}
+		if (
+			row.eraseX == 0 && t->pool != NULL &&
+			_sngTermCellEqual(&_sngTermLineInfo(t->pool->blank)->erase, &row.erase)
+		) {
+			_sngTermLineDisown(t, y);
+			continue;
+		}
+		SngTermCell *line = _sngTermLineOwn(t, y);
+		if (line == NULL) {
+			continue;
+		}
+		_SngTermLineInfo *info = _sngTermLineInfo(line);
+		info->eraseX = row.eraseX;
+		info->erase = row.erase;
+		memcpy(line, cells, cellsSize);
+		memcpy(_sngTermLineRuns(t, line), cells + cellsSize, runsSize);
+	}
+	return p;
+}
+
+// _sngTermLoadTablesValid reports whether the rgb and mark tables of a
+// save hold rgbLen and markTableLen entries, in the form the terminal
+// writes them. An insert probes until it finds an empty slot, so a table
+// fuller than its length says could leave it probing forever.
+static b32 _sngTermLoadTablesValid(
+	const u32 *rgb, const u32 (*markTable)[2], int rgbLen, int markTableLen
+) {
+	if (
+		rgbLen > SNG_TERM_RGB_TABLE_SIZE - SNG_TERM_RGB_TABLE_SIZE/4 ||
+		markTableLen > SNG_TERM_MARKS_TABLE_SIZE - SNG_TERM_MARKS_TABLE_SIZE/4
+	) {
+		return 0;
+	}
+	int n = 0;
+	for (intptr_t i = 0; i < SNG_TERM_RGB_TABLE_SIZE; i++) {
+		if (rgb[i] != 0 && (rgb[i] & 0xff000000) != 0x1000000) {
+			return 0;
+		}
+		n += rgb[i] != 0;
+	}
+	if (n != rgbLen) {
+		return 0;
+	}
+	n = 0;
+	for (intptr_t i = 0; i < SNG_TERM_MARKS_TABLE_SIZE; i++) {
+		if (markTable[i][0] == 0 && markTable[i][1] != 0) {
+			return 0;
+		}
+		n += markTable[i][0] != 0;
+	}
+	return n == markTableLen;
+}
+
+// _sngTermLoadParserValid reports whether the parser union of a save is
+// sane for the state it is restored in. The other states reset the union
+// before using it.
+static b32 _sngTermLoadParserValid(_SngTermState state, const _SngTermSTR *str, const _SngTermCSI *csi) {
+	if (state == _sngTermStateParseEscCSI) {
+		return _sngTermBetween(csi->argsLen, 0, 16);
+	}
+	if (state != _sngTermStateParseEscSTR && state != _sngTermStateParseEscSTREnd) {
+		return 1;
+	}
+	switch (str->typeCodepoint) {
+		case 'P':
+		case '_':
+		case '^':
+		case ']':
+		case 'k': break;
+		default: return 0;
+	}
+	// Arguments are only split out while a sequence is handled.
+	return
+		_sngTermBetween(str->bufLen, 0, (int)sizeof(str->buf) - 1) &&
+		str->buf[str->bufLen] == 0 &&
+		str->argsLen == 0;
+}
+
+// _sngTermBlankLines blanks height rows of t->lines, as a terminal that
+// never used them would have them.
+static void _sngTermBlankLines(SngTerm *t, int height) {
+	SngTermCell blank = _sngTermDefaultCursor().attr;
+	blank.codepoint = ' ';
+	for (intptr_t y = 0; y < height; y++) {
+		if (t->pool != NULL) {
+			_sngTermLineDisown(t, y);
+			continue;
+		}
+		SngTermCell *line = _sngTermLineOwn(t, y);
+		_sngTermLineInfo(line)->eraseX = 0;
+		_sngTermLineInfo(line)->erase = blank;
+	}
+}
+
+static void _sngTermSwapLines(SngTerm *t) {
+	SngTermCell **tmp = t->lines;
+	t->lines = t->altLines;
+	t->altLines = tmp;
+}
+
+b32 sngTermLoad(SngTerm *t, const void *data, size_t len) {
+	_SngTermSaveHeader h;
+	if (len < sizeof(h)) {
+		return 0;
+	}
+	memcpy(&h, data, sizeof(h));
+	if (
+		h.magic != _SNG_TERM_SAVE_MAGIC || h.version != _SNG_TERM_SAVE_VERSION ||
+		!_sngTermBetween(h.width, 1, t->maxWidth) ||
+		!_sngTermBetween(h.height, 1, t->maxHeight) ||
+		!_sngTermBetween(h.top, 0, h.height-1) ||
+		!_sngTermBetween(h.bottom, h.top, h.height-1) ||
+		!_sngTermBetween(h.cur.x, 0, h.width-1) ||
+		!_sngTermBetween(h.cur.y, 0, h.height-1) ||
+		!_sngTermBetween(h.curSaved.x, 0, h.width-1) ||
+		!_sngTermBetween(h.curSaved.y, 0, h.height-1) ||
+		!_sngTermBetween(h.rgbLen, 0, SNG_TERM_RGB_TABLE_SIZE) ||
+		!_sngTermBetween(h.markTableLen, 0, SNG_TERM_MARKS_TABLE_SIZE) ||
+		h.state >= sizeof(_sngTermStates) / sizeof(_sngTermStates[0]) ||
+		!_sngTermBetween(h.utf8Len, 0, 3) ||
+		!_sngTermBetween(h.screens, 1, 2)
+	) {
+		return 0;
+	}
+	const u8 *p = (const u8 *)data;
+	const u8 *end = p + len;
+	if (len < _SNG_TERM_SIZEOF_SAVE_FIXED(h.width)) {
+		return 0;
+	}
+	// The fixed part is copied out to be checked before t is touched.
+	const u8 *title = p + sizeof(h);
+	const u8 *tables = title + sizeof(t->title) + h.width;
+	u32 rgb[SNG_TERM_RGB_TABLE_SIZE];
+	u32 markTable[SNG_TERM_MARKS_TABLE_SIZE][2];
+	memcpy(rgb, tables, sizeof(rgb));
+	memcpy(markTable, tables + sizeof(rgb), sizeof(markTable));
+	union {
+		_SngTermCSI csi;
+		_SngTermSTR str;
+	} parser;
+	memcpy(&parser.str, tables + sizeof(rgb) + sizeof(markTable), sizeof(parser.str));
+	if (
+		title[sizeof(t->title) - 1] != 0 ||
+		!_sngTermLoadTablesValid(rgb, markTable, h.rgbLen, h.markTableLen) ||
+		!_sngTermLoadParserValid(_sngTermStates[h.state], &parser.str, &parser.csi)
+	) {
+		return 0;
+	}
+	const u8 *screens = p + _SNG_TERM_SIZEOF_SAVE_FIXED(h.width);
+	const u8 *other = _sngTermLoadLines(t, screens, end, h.width, h.height, 0);
+	if (other == NULL || (h.screens == 2 && _sngTermLoadLines(t, other, end, h.width, h.height, 0) == NULL)) {
+		return 0;
+	}
+	if ((h.mode & SNG_TERM_MODE_ALT_SCREEN) && !_sngTermAcquireAlt(t)) {
+		return 0;
+	}
+
+	if ((t->mode ^ h.mode) & SNG_TERM_MODE_ALT_SCREEN) {
+		_sngTermSwapLines(t);
+	}
+	_sngTermLoadLines(t, screens, end, h.width, h.height, 1);
+	if (t->altLines != NULL) {
+		_sngTermSwapLines(t);
+		if (h.screens == 2) {
+			_sngTermLoadLines(t, other, end, h.width, h.height, 1);
+		} else {
+			_sngTermBlankLines(t, h.height);
+		}
+		_sngTermSwapLines(t);
+	}
+
+	memcpy(t->title, title, sizeof(t->title));
+	memcpy(t->tabs, title + sizeof(t->title), (size_t)h.width);
+	memcpy(t->rgb, rgb, sizeof(t->rgb));
+	memcpy(t->markTable, markTable, sizeof(t->markTable));
+	t->str = parser.str;
+	t->width = h.width;
+	t->height = h.height;
+	t->top = h.top;
+	t->bottom = h.bottom;
+	t->mode = h.mode;
+	t->syncChanged = h.syncChanged;
+	t->syncTimed = 0;
+	t->altIdleTimed = 0;
+	t->cur = h.cur;
+	t->cur_saved = h.curSaved;
+	t->rgbLen = h.rgbLen;
+	t->markTableLen = h.markTableLen;
+	t->tableSeq++;
+	t->rgbSweepWait = 0;
+	t->marksSweepWait = 0;
+	t->state = _sngTermStates[h.state];
+	t->utf8 = h.utf8;
+	t->utf8Len = h.utf8Len;
+	t->changed |= SNG_TERM_CHANGED_TITLE;
+	_sngTermDirtyAll(t);
+	_sngTermSyncHold(t);
+	return 1;
 }
 
 #endif // SNG_TERMINAL_IMPLEMENTATION
@@ -0,0 +1,377 @@
+// sng_termrec.h v0.0.0
+//
+// OVERVIEW
+//
+// sng_termrec records the output of a terminal session, with the time it
+// arrived, and plays it back into a SngTerm. It can seek to any point of
+// a long recording without parsing everything before it.
+//
+// A recording is a sequence of records: output as it was read, resizes,
+// and keyframes, which hold the whole state of the terminal as saved by
+// sngTermSave. A keyframe is written whenever keyframeBytes of output
+// have been recorded since the last, so seeking loads the last keyframe
+// before the time sought and parses at most keyframeBytes of output.
+// Keyframes link back to the one before, and the recording ends with the
+// offset of the last one, so finding a keyframe never reads the output.
+//
+// USAGE
+//
+// In a .c or .cpp file, define SNG_TERMREC_IMPLEMENTATION before including
+// the header. Include sng_terminal.h before it, and implement it in the
+// same program.
+//
+// To record, pass everything read from the application through
+// sngTermRecWrite, and resizes through sngTermRecResize, in place of
+// sngTermWrite and sngTermSetSize. Records go out through a
+// SngTermRecWriteFunc, usually to a file.
+//
+// To play, map or read the recording into memory, and initialize a
+// SngTermPlayer over it. sngTermPlayerSeek puts a terminal in the state
+// it had at a given time, and sngTermPlayerPlay moves it forward from
+// there, as a clock ticks during playback. Replies the terminal would
+// write back to the application are discarded.
+//
+// Times are in milliseconds, from any monotonic clock. Recordings are in
+// the byte order of the machine that made them, and keyframes in the
+// layout of its build of sng_terminal; see sngTermSave.
+//
+// DEPENDENCIES
+//
+// sng_terminal.h
+// C standard library - stdint.h string.h
+//
+// LICENSE
+//
+// This software is in the public domain. Where that dedication is not
+// recognized, you are granted a perpetual, irrevocable license to copy,
+// distribute, and modify this file as you see fit.
+//
+// No warranty. Use at your own risk.
+
+#ifndef SNG_TERMREC_H
+#define SNG_TERMREC_H
+
+#ifndef SNG_TERMINAL_H
+#error "sng_terminal.h must be included before sng_termrec.h"
+#endif
+
+#ifndef SNG_TERMREC_API
+#define SNG_TERMREC_API
+#endif
+
+// SNG_TERMREC_MAGIC is the first 8 bytes of a recording.
+#define SNG_TERMREC_MAGIC "SNGTREC1"
+
+// SNG_TERMREC_NONE is an offset that refers to no record.
+#define SNG_TERMREC_NONE ((u64)-1)
+
+// SNG_TERMREC_* are the types of records.
+enum {
+	SNG_TERMREC_OUTPUT   = 1, // bytes written to the terminal
+	SNG_TERMREC_RESIZE   = 2, // s32 width, s32 height
+	SNG_TERMREC_KEYFRAME = 3, // u64 offset of the keyframe before, then sngTermSave's
+	SNG_TERMREC_END      = 4, // u64 offset of the last keyframe
+};
+
+// SngTermRecHeader precedes each record, and is followed by len bytes of
+// it.
+typedef struct {
+	u32 type;
+	u32 len;
+	u64 timeMs;
+} SngTermRecHeader;
+
+// SngTermRecWriteFunc writes len bytes of a recording to wherever it is
+// kept. It returns zero on error, after which the recorder writes no
+// more.
+typedef b32 (*SngTermRecWriteFunc)(void *user, const void *data, size_t len);
+
+// SngTermRecorder records the output written to one terminal.
+typedef struct {
+	SngTerm *t;
+	SngTermRecWriteFunc write;
+	void *user;
+	u8 *scratch; // for sngTermSave
+	size_t scratchSize;
+	u64 keyframeBytes;
+	u64 offset;        // bytes written
+	u64 lastKeyframe;  // offset of the last keyframe, or SNG_TERMREC_NONE
+	u64 sinceKeyframe; // output bytes recorded since the last keyframe
+	b32 failed;        // write has returned zero
+	u8 _pad[4];
+} SngTermRecorder;
+
+// SngTermPlayer plays a recording held in memory.
+typedef struct {
+	const u8 *data;
+	size_t len;          // of the whole records in data
+	u64 lastKeyframe;    // offset of the last keyframe, or SNG_TERMREC_NONE
+	u64 startMs, endMs;  // times of the first and last records
+	size_t pos;          // offset of the next record to play
+	u64 timeMs;          // time played up to
+} SngTermPlayer;
+
+// sngTermRecScratchSize returns the scratch memory size a recorder needs
+// for a terminal of up to maxWidth by maxHeight.
+SNG_TERMREC_API size_t sngTermRecScratchSize(int maxWidth, int maxHeight);
+
+// sngTermRecInit starts recording t, writing the magic and a first
+// keyframe of its current state. scratch should be sized by
+// sngTermRecScratchSize. Returns zero if a write failed.
+SNG_TERMREC_API b32 sngTermRecInit(
+	SngTermRecorder *r, SngTerm *t,
+	void *scratch, size_t scratchSize, u64 keyframeBytes,
+	SngTermRecWriteFunc write, void *user,
+	u64 nowMs
+);
+
+// sngTermRecWrite writes len bytes of data to the terminal with
+// sngTermWrite, and records them. Returns zero if a write failed.
+SNG_TERMREC_API b32 sngTermRecWrite(SngTermRecorder *r, const void *data, size_t len, u64 nowMs);
+
+// sngTermRecResize resizes the terminal with sngTermSetSize, and records
+// it. Returns zero if a write failed.
+SNG_TERMREC_API b32 sngTermRecResize(SngTermRecorder *r, int width, int height, u64 nowMs);
+
+// sngTermRecFinish ends the recording with the offset of its last
+// keyframe. A recording that was never finished, such as one cut short
+// by a crash, can still be played, but every seek first reads through the
+// headers of its records. Returns zero if a write failed.
+SNG_TERMREC_API b32 sngTermRecFinish(SngTermRecorder *r, u64 nowMs);
+
+// sngTermPlayerInit initializes p to play the recording of len bytes at
+// data, which must stay in place while p is used. A record cut short at
+// the end is ignored. Returns zero if data is not a recording, or has no
+// keyframe.
+SNG_TERMREC_API b32 sngTermPlayerInit(SngTermPlayer *p, const void *data, size_t len);
+
+// sngTermPlayerSeek puts t in the state the recorded terminal had at
+// timeMs, or at the start of the recording if timeMs is before it. It
+// loads the last keyframe at or before timeMs, unless playing on from
+// where p is gets there sooner. t must hold the recorded terminal's
+// sizes, and be the terminal p last played into, if any. Returns zero if
+// a keyframe could not be loaded into t.
+SNG_TERMREC_API b32 sngTermPlayerSeek(SngTermPlayer *p, SngTerm *t, u64 timeMs);
+
+// sngTermPlayerPlay writes the records after the last one played, up to
+// and including those at timeMs, to t. Returns zero once the recording
+// has ended.
+SNG_TERMREC_API b32 sngTermPlayerPlay(SngTermPlayer *p, SngTerm *t, u64 timeMs);
+
+#endif // SNG_TERMREC_H
+
+#ifdef SNG_TERMREC_IMPLEMENTATION
+
+#include <string.h> // memcpy, memcmp
+
+static void _sngTermRecPut(SngTermRecorder *r, const void *data, size_t len) {
+	if (r->failed) {
+		return;
+	}
+	if (!r->write(r->user, data, len)) {
+		r->failed = 1;
+		return;
+	}
+	r->offset += len;
+}
+
+static void _sngTermRecPutHeader(SngTermRecorder *r, u32 type, size_t len, u64 nowMs) {
+	SngTermRecHeader h;
+	h.type = type;
+	h.len = (u32)len;
+	h.timeMs = nowMs;
+	_sngTermRecPut(r, &h, sizeof(h));
+}
+
+// _sngTermRecKeyframe records the terminal's state, unless it does not
+// fit the scratch memory, in which case the next write tries again.
+static void _sngTermRecKeyframe(SngTermRecorder *r, u64 nowMs) {
+	size_t len = sngTermSave(r->t, r->scratch, r->scratchSize);
+	if (len > r->scratchSize) {
+		return;
+	}
+	u64 offset = r->offset;
+	_sngTermRecPutHeader(r, SNG_TERMREC_KEYFRAME, sizeof(u64) + len, nowMs);
+	_sngTermRecPut(r, &r->lastKeyframe, sizeof(u64));
+	_sngTermRecPut(r, r->scratch, len);
+	r->lastKeyframe = offset;
+	r->sinceKeyframe = 0;
+}
+
+SNG_TERMREC_API size_t sngTermRecScratchSize(int maxWidth, int maxHeight) {
+	return sngTermSaveSize(maxWidth, maxHeight);
+}
+
+SNG_TERMREC_API b32 sngTermRecInit(
+	SngTermRecorder *r, SngTerm *t,
+	void *scratch, size_t scratchSize, u64 keyframeBytes,
+	SngTermRecWriteFunc write, void *user,
+	u64 nowMs
+) {
+	memset(r, 0, sizeof(*r));
+	r->t = t;
+	r->write = write;
+	r->user = user;
+	r->scratch = (u8 *)scratch;
+	r->scratchSize = scratchSize;
+	r->keyframeBytes = keyframeBytes;
+	r->lastKeyframe = SNG_TERMREC_NONE;
+	_sngTermRecPut(r, SNG_TERMREC_MAGIC, 8);
+	_sngTermRecKeyframe(r, nowMs);
+	return !r->failed;
+}
+
+SNG_TERMREC_API b32 sngTermRecWrite(SngTermRecorder *r, const void *data, size_t len, u64 nowMs) {
+	const u8 *p = (const u8 *)data;
+	// Records are kept under 4GB, and to around keyframeBytes, so seeking
+	// never parses much more than that.
+	while (len > 0) {
+		size_t n = len < 0x7fffffff ? len : 0x7fffffff;
+		if (r->sinceKeyframe < r->keyframeBytes && n > r->keyframeBytes - r->sinceKeyframe) {
+			n = (size_t)(r->keyframeBytes - r->sinceKeyframe);
+		}
+		sngTermWrite(r->t, p, n);
+		_sngTermRecPutHeader(r, SNG_TERMREC_OUTPUT, n, nowMs);
+		_sngTermRecPut(r, p, n);
+		p += n;
+		len -= n;
+		r->sinceKeyframe += n;
+		if (r->sinceKeyframe >= r->keyframeBytes) {
+			_sngTermRecKeyframe(r, nowMs);
+		}
+	}
+	return !r->failed;
+}
+
+SNG_TERMREC_API b32 sngTermRecResize(SngTermRecorder *r, int width, int height, u64 nowMs) {
+	sngTermSetSize(r->t, width, height);
+	s32 size[2] = {width, height};
+	_sngTermRecPutHeader(r, SNG_TERMREC_RESIZE, sizeof(size), nowMs);
+	_sngTermRecPut(r, size, sizeof(size));
+	return !r->failed;
+}
+
+SNG_TERMREC_API b32 sngTermRecFinish(SngTermRecorder *r, u64 nowMs) {
+	_sngTermRecPutHeader(r, SNG_TERMREC_END, sizeof(u64), nowMs);
+	_sngTermRecPut(r, &r->lastKeyframe, sizeof(u64));
+	return !r->failed;
+}
+
+// _sngTermPlayerHeader reads the header of the record at pos. Returns
+// zero if there is no whole record there.
+static b32 _sngTermPlayerHeader(const u8 *data, size_t len, u64 pos, SngTermRecHeader *h) {
+	if (pos > len || len - pos < sizeof(*h)) {
+		return 0;
+	}
+	memcpy(h, &data[pos], sizeof(*h));
+	return h->len <= len - pos - sizeof(*h);
+}
+
+SNG_TERMREC_API b32 sngTermPlayerInit(SngTermPlayer *p, const void *data, size_t len) {
+	memset(p, 0, sizeof(*p));
+	p->data = (const u8 *)data;
+	if (len < 8 || memcmp(data, SNG_TERMREC_MAGIC, 8) != 0) {
+		return 0;
+	}
+	SngTermRecHeader h;
+	u64 last;
+	if (!_sngTermPlayerHeader(p->data, len, 8, &h)) {
+		return 0;
+	}
+	p->startMs = h.timeMs;
+	p->pos = 8;
+	p->timeMs = h.timeMs;
+	size_t endLen = sizeof(h) + sizeof(u64);
+	if (
+		len >= 8 + endLen &&
+		_sngTermPlayerHeader(p->data, len, len - endLen, &h) &&
+		h.type == SNG_TERMREC_END && h.len == sizeof(u64)
+	) {
+		memcpy(&last, &p->data[len - sizeof(u64)], sizeof(u64));
+		p->len = len - endLen;
+		p->lastKeyframe = last;
+		p->endMs = h.timeMs;
+	} else {
+		// Unfinished; find the last keyframe, and the last whole record.
+		u64 pos = 8;
+		p->lastKeyframe = SNG_TERMREC_NONE;
+		while (_sngTermPlayerHeader(p->data, len, pos, &h) && h.type != SNG_TERMREC_END) {
+			if (h.type == SNG_TERMREC_KEYFRAME) {
+				p->lastKeyframe = pos;
+			}
+			p->endMs = h.timeMs;
+			pos += sizeof(h) + h.len;
+		}
+		p->len = (size_t)pos;
+	}
+	return
+		p->lastKeyframe != SNG_TERMREC_NONE &&
+		_sngTermPlayerHeader(p->data, p->len, p->lastKeyframe, &h) &&
+		h.type == SNG_TERMREC_KEYFRAME;
+}
+
+SNG_TERMREC_API b32 sngTermPlayerSeek(SngTermPlayer *p, SngTerm *t, u64 timeMs) {
+	// Walk back from the last keyframe to the last one at or before
+	// timeMs, or the first.
+	u64 pos = p->lastKeyframe;
+	SngTermRecHeader h;
+	u64 prev;
+	for (;;) {
+		if (
+			!_sngTermPlayerHeader(p->data, p->len, pos, &h) ||
+			h.type != SNG_TERMREC_KEYFRAME || h.len < sizeof(u64)
+		) {
+			return 0;
+		}
+		memcpy(&prev, &p->data[pos + sizeof(h)], sizeof(u64));
+		if (h.timeMs <= timeMs || prev == SNG_TERMREC_NONE || prev >= pos) {
+			break;
+		}
+		pos = prev;
+	}
+	if (p->pos <= pos || timeMs < p->timeMs) {
+		const u8 *save = &p->data[pos + sizeof(h) + sizeof(u64)];
+		if (!sngTermLoad(t, save, h.len - sizeof(u64))) {
+			return 0;
+		}
+		p->pos = (size_t)pos + sizeof(h) + h.len;
+		p->timeMs = h.timeMs;
+	}
+	sngTermPlayerPlay(p, t, timeMs);
+	return 1;
+}
+
+SNG_TERMREC_API b32 sngTermPlayerPlay(SngTermPlayer *p, SngTerm *t, u64 timeMs) {
+	SngTermRecHeader h;
+	while (_sngTermPlayerHeader(p->data, p->len, p->pos, &h) && h.timeMs <= timeMs) {
+		const u8 *payload = &p->data[p->pos + sizeof(h)];
+		switch (h.type) {
+			case SNG_TERMREC_OUTPUT: {
+				sngTermWrite(t, payload, h.len);
+				const char *out;
+				size_t n;
+				while ((n = sngTermOutputPeek(t, &out)) > 0) {
+					sngTermOutputConsume(t, n);
+				}
+			} break;
+			case SNG_TERMREC_RESIZE: {
+				s32 size[2];
+				if (h.len == sizeof(size)) {
+					memcpy(size, payload, sizeof(size));
+					sngTermSetSize(t, size[0], size[1]);
+				}
+			} break;
+			default: {
+				// Keyframes are only loaded by seeking.
+			} break;
+		}
+		p->pos += sizeof(h) + h.len;
+		p->timeMs = h.timeMs;
+	}
+	if (timeMs > p->timeMs) {
+		p->timeMs = timeMs;
+	}
+	return p->pos < p->len;
+}
+
+#endif // SNG_TERMREC_IMPLEMENTATION
@@ -0,0 +1,30 @@
+#!/usr/bin/env bash
+
+set -e
+if [ ! -f bench.bash ]; then
+	echo 'bench.bash must be run from bad/test' 1>&2
+	exit 1
+fi
+
+mkdir -p bin
+
+FLAGS="-O2 -DNDEBUG -I.. -Werror -Wall -Wpadded -Winline -Wconversion -Wcast-align"
+
+if [ "$1" == "-v" ]; then
+	set -x
+fi
+
+cc -o bin/rand_bench $FLAGS rand_test.c -lm
+./bin/rand_bench bench
+
+cc -o bin/terminal_bench $FLAGS terminal_bench.cpp
+./bin/terminal_bench
+
+cc -o bin/ring_bench $FLAGS ring_test.c -pthread
+./bin/ring_bench bench
+
+cc -o bin/pane_bench $FLAGS pane_bench.c
+./bin/pane_bench -n 100 -s 2
+
+cc -o bin/termrec_bench $FLAGS termrec_test.c
+./bin/termrec_bench bench
@@ -4,6 +4,12 @@
 #define SNG_TERMINAL_IMPLEMENTATION
 #include "sng_terminal.h"
 
+#define SNG_RING_IMPLEMENTATION
+#include "sng_ring.h"
+
+#define SNG_TERMREC_IMPLEMENTATION
+#include "sng_termrec.h"
+
 int main(int argc, char **argv) {
 	// suppress -Wunused-parameter
 	(void)argc;
@@ -0,0 +1,498 @@
+#define SNG_RAND_IMPLEMENTATION
+#include "sng_rand.h"
+
+#define SNG_TERMINAL_IMPLEMENTATION
+#include "sng_terminal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#endif
+
+// fuzz_test feeds sng_terminal hostile and random input. After each
+// input it checks that the terminal is still consistent, and it treats
+// any input that costs more than BUDGET cycles per byte to parse as a
+// bug, so that one pane's output cannot starve the others on a host.
+//
+//   fuzz_test            run the hostile patterns, then random inputs;
+//                        exits non-zero on failure
+//   fuzz_test -v         the same, printing the cost of each pattern
+//   fuzz_test FILE...    run each file as one input, to reproduce what a
+//                        fuzzer found
+//
+// Built with -DSNG_FUZZ_LIBFUZZER it is a libFuzzer target instead, which
+// checks consistency but not cost:
+//
+//   clang -g -O1 -fsanitize=fuzzer,address -DSNG_FUZZ_LIBFUZZER -I.. fuzz_test.c
+//
+// Costs are only meaningful with optimization; run.bash builds this with
+// -O2.
+
+// BUDGET is the most cycles per byte any input may take to parse, on a
+// WIDTH by HEIGHT terminal. Where there is no cycle counter, cycles are
+// taken to be a third of a nanosecond.
+#define BUDGET 400
+#define WIDTH 200
+#define HEIGHT 60
+
+// MEASURE_BYTES is how much of a pattern is parsed to measure its cost.
+#define MEASURE_BYTES (1 << 18)
+
+static int failures = 0;
+
+#define FAIL(...) do { \
+	fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+	fprintf(stderr, __VA_ARGS__); \
+	fprintf(stderr, "\n"); \
+	failures++; \
+} while (0)
+
+static u64 cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((u64)ts.tv_sec * 1000000000 + (u64)ts.tv_nsec) * 3;
+#endif
+}
+
+static b32 validState(_SngTermState state) {
+	return
+		state == _sngTermStateParse ||
+		state == _sngTermStateParseEsc ||
+		state == _sngTermStateParseEscAltCharset ||
+		state == _sngTermStateParseEscCSI ||
+		state == _sngTermStateParseEscSTR ||
+		state == _sngTermStateParseEscSTREnd ||
+		state == _sngTermStateParseEscTest;
+}
+
+// checkLine returns what is wrong with line y of t, or NULL.
+static const char *checkLine(const SngTerm *t, const SngTermCell *line) {
+	const _SngTermLineInfo *info = _sngTermLineInfoConst(line);
+	if (info->eraseX < 0) {
+		return "negative eraseX";
+	}
+	int eraseX = _sngTermMin(info->eraseX, t->width);
+	const u32 *runs = _sngTermLineRunsConst(t, line);
+	for (int x = 0; x < eraseX; x++) {
+		const SngTermCell *cell = &line[x];
+		if (cell->marks > SNG_TERM_MARKS_TABLE_SIZE) {
+			return "cell marks out of the table";
+		}
+		if ((cell->fg & SNG_TERM_COLOR_RGB_FLAG) && cell->fg < 0xff00 && (cell->fg & 0x7fff) >= SNG_TERM_RGB_TABLE_SIZE) {
+			return "cell color out of the table";
+		}
+		if ((cell->attr & SNG_TERM_ATTR_WIDE_SPACER) && (x == 0 || !(line[x-1].attr & SNG_TERM_ATTR_WIDE))) {
+			return "spacer without a wide character";
+		}
+		if ((cell->attr & SNG_TERM_ATTR_WIDE) && x+1 < eraseX && !(line[x+1].attr & SNG_TERM_ATTR_WIDE_SPACER)) {
+			return "wide character without a spacer";
+		}
+		if (x > 0) {
+			b32 bit = (runs[x >> 5] >> (x & 31)) & 1;
+			if (bit != (_sngTermStyleKey(&line[x-1]) != _sngTermStyleKey(cell))) {
+				return "run boundary out of date";
+			}
+		}
+	}
+	return NULL;
+}
+
+// checkTerm returns what is wrong with t, or NULL.
+static const char *checkTerm(const SngTerm *t) {
+	if (!_sngTermBetween(t->width, 1, t->maxWidth) || !_sngTermBetween(t->height, 1, t->maxHeight)) {
+		return "size out of range";
+	}
+	if (!_sngTermBetween(t->cur.x, 0, t->width-1) || !_sngTermBetween(t->cur.y, 0, t->height-1)) {
+		return "cursor off screen";
+	}
+	if (!_sngTermBetween(t->top, 0, t->bottom) || !_sngTermBetween(t->bottom, t->top, t->height-1)) {
+		return "scroll region out of range";
+	}
+	if (!validState(t->state) || !_sngTermBetween(t->utf8Len, 0, 3)) {
+		return "parser state";
+	}
+	if (!_sngTermBetween(t->rgbLen, 0, SNG_TERM_RGB_TABLE_SIZE) || !_sngTermBetween(t->markTableLen, 0, SNG_TERM_MARKS_TABLE_SIZE)) {
+		return "table length out of range";
+	}
+	if (!_sngTermLoadTablesValid(t->rgb, (const u32 (*)[2])t->markTable, t->rgbLen, t->markTableLen)) {
+		return "tables do not match their lengths";
+	}
+	if (t->outputTail - t->outputHead > SNG_TERM_OUTPUT_SIZE) {
+		return "output overfilled";
+	}
+	if (t->pool != NULL && (t->rowsHeld < 0 || t->rowsHeld > t->rowQuota)) {
+		return "rows held past the quota";
+	}
+	for (int y = 0; y < t->height; y++) {
+		const char *err = checkLine(t, t->lines[y]);
+		if (err == NULL && t->altLines != NULL) {
+			err = checkLine(t, t->altLines[y]);
+		}
+		if (err != NULL) {
+			return err;
+		}
+	}
+	return NULL;
+}
+
+static SngTerm *newTerm(void) {
+	size_t memSize = sngTermAllocSize(WIDTH, HEIGHT);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, WIDTH, HEIGHT, NULL);
+	sngTermSetSize(t, WIDTH, HEIGHT);
+	return t;
+}
+
+static void drain(SngTerm *t) {
+	const char *data;
+	size_t n;
+	while ((n = sngTermOutputPeek(t, &data)) > 0) {
+		sngTermOutputConsume(t, n);
+	}
+}
+
+// writeInput writes data to t in chunks of up to chunk bytes, draining
+// replies as a host would, and returns the cycles taken.
+static u64 writeInput(SngTerm *t, const u8 *data, size_t len, size_t chunk) {
+	u64 start = cycles();
+	for (size_t i = 0; i < len; i += chunk) {
+		sngTermWrite(t, &data[i], len - i < chunk ? len - i : chunk);
+		drain(t);
+		sngTermFrameReady(t, 0);
+	}
+	return cycles() - start;
+}
+
+// Pattern is hostile input, repeated for as long as it is measured.
+typedef struct {
+	const char *name;
+	const char *setup; // written once first
+	const char *repeat;
+} Pattern;
+
+// fullColors fills the main screen with text in 400 truecolors, more than
+// the table holds, and leaves it for the alternate screen. buildSetups
+// writes it.
+static char fullColors[24 << 10];
+// fullMarks does the same with 240 combinations of combining marks.
+static char fullMarks[16 << 10];
+
+static const Pattern patterns[] = {
+	{"plain text", "", "the quick brown fox jumps over the lazy dog "},
+	{"newlines", "", "line\r\n"},
+	{"DECALN", "", "\033#8"},
+	{"insert 1000 lines", "\033[H", "\033[1000L"},
+	{"delete 1000 lines", "\033[H", "\033[1000M"},
+	{"insert a line", "\033[H", "\033[L"},
+	{"reverse index", "\033[H", "\033M"},
+	{"scroll down", "", "\033[T"},
+	{"scroll up 999", "", "\033[999S"},
+	{"clear screen", "", "\033[2J"},
+	{"clear above", "\033[60;200H", "\033[1J"},
+	{"erase 2^30 chars", "", "\033[999999999X"},
+	{"insert 2^30 chars", "", "\033[999999999@"},
+	{"delete a char", "\033[H", "\033[P"},
+	{"insert a char", "\033[H", "\033[@"},
+	{"insert mode text", "\033[4h\033[H", "x"},
+	{"forward 2^30 tabs", "", "\033[999999999I\r"},
+	{"backward 2^30 tabs", "", "\033[999999999Z\033[200G"},
+	{"tabs", "", "\t\t\t\t\r"},
+	{"cursor reports", "", "\033[6n"},
+	{"mode reports", "", "\033[?1049$p"},
+	{"alt screen", "", "\033[?1049h\033[?1049l"},
+	{"sync updates", "", "\033[?2026h\033[?2026l"},
+	{"scroll regions", "", "\033[5;50r\033[r"},
+	{"titles", "", "\033]0;a title long enough to be worth copying, and then some more\a"},
+	{"long OSC", "\033]52;c;", "QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVo="},
+	{"many parameters", "", "\033[1;2;3;4;5;6;7;8;9;10;11;12;13;14;15;16;17;18;19;20;21;22;23;24m"},
+	{"truecolor", "", "\033[38;2;1;2;3mx\033[38;2;4;5;6my"},
+	{"combining marks", "", "e\xcc\x81\xcc\x82\xcc\x83\xcc\x84"},
+	{"wide at the edge", "\033[?7h", "\xe4\xb8\xad"},
+	{"invalid UTF-8", "", "\xff\xfe\xc0"},
+	{"save and restore", "", "\0337\0338"},
+	{"reset", "", "\033c"},
+	{"truecolor reset", "", "\033[38;2;1;2;3mx\033c"},
+	{"truecolor under alt", fullColors, "\033[2J\033[38;2;1;2;3mx"},
+	{"marks under alt", fullMarks, "\033[2Je\xcd\xaf\xcd\xae"},
+};
+
+// buildRepeat fills buf with setup, then repeat as many times as fit.
+static size_t buildRepeat(const Pattern *p, u8 *buf, size_t size) {
+	size_t len = strlen(p->setup);
+	memcpy(buf, p->setup, len);
+	size_t n = strlen(p->repeat);
+	while (len + n <= size) {
+		memcpy(&buf[len], p->repeat, n);
+		len += n;
+	}
+	return len;
+}
+
+// buildSetups writes the setups too long to spell out in patterns.
+static void buildSetups(void) {
+	size_t len = (size_t)snprintf(fullColors, sizeof(fullColors), "\033[?7h");
+	for (int i = 0; i < WIDTH*HEIGHT; i++) {
+		if (i % 30 == 0) {
+			len += (size_t)snprintf(
+				&fullColors[len], sizeof(fullColors) - len, "\033[38;2;%d;%d;7m", (i/30) & 0xff, (i/30) >> 8
+			);
+		}
+		fullColors[len++] = 'x';
+	}
+	snprintf(&fullColors[len], sizeof(fullColors) - len, "\033[m\033[?1049h");
+
+	len = (size_t)snprintf(fullMarks, sizeof(fullMarks), "\033[?7h");
+	for (int i = 0; i < WIDTH*HEIGHT; i++) {
+		fullMarks[len++] = 'e';
+		if (i % 50 == 0) {
+			// U+0300 to U+036F, two bytes each
+			int m0 = 0x300 + (i/50) % 0x70;
+			int m1 = 0x300 + (i/50) / 0x70;
+			fullMarks[len++] = (char)(0xc0 | (m0 >> 6));
+			fullMarks[len++] = (char)(0x80 | (m0 & 0x3f));
+			fullMarks[len++] = (char)(0xc0 | (m1 >> 6));
+			fullMarks[len++] = (char)(0x80 | (m1 & 0x3f));
+		}
+	}
+	snprintf(&fullMarks[len], sizeof(fullMarks) - len, "\033[?1049h");
+}
+
+static void testPatterns(b32 verbose) {
+	buildSetups();
+	u8 *buf = (u8 *)malloc(MEASURE_BYTES);
+	for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+		const Pattern *p = &patterns[i];
+		size_t len = buildRepeat(p, buf, MEASURE_BYTES);
+		// The cheapest of a few runs, as the machine may be busy. The first
+		// is short, so a pattern far over the budget fails fast.
+		u64 best = (u64)-1;
+		for (int run = 0; run < 4; run++) {
+			SngTerm *t = newTerm();
+			size_t n = run == 0 ? 4096 : len;
+			u64 c = writeInput(t, buf, n, 4096);
+			c = c * (len / n);
+			best = c < best ? c : best;
+			const char *err = checkTerm(t);
+			if (err != NULL) {
+				FAIL("%s: %s", p->name, err);
+			}
+			free(t);
+			if (run == 0 && c / len > 8*BUDGET) {
+				break;
+			}
+			if (run == 0) {
+				best = (u64)-1;
+			}
+		}
+		double perByte = (double)best / (double)len;
+		if (verbose) {
+			printf("%-24s %8.1f cycles/byte\n", p->name, perByte);
+			fflush(stdout);
+		}
+		if (perByte > BUDGET) {
+			FAIL("%s: %.1f cycles/byte, over the budget of %d", p->name, perByte, BUDGET);
+		}
+	}
+	free(buf);
+}
+
+// randomInput fills buf with a random mix of text and sequences, with
+// parameters chosen to be extreme.
+static size_t randomInput(SngRand *r, u8 *buf, size_t size) {
+	static const char *finals = "@ABCDEFGHIJKLMPSTXZ`abcdefghlmnqrsu";
+	static const char *texts[] = {
+		"abc", " ", "\r", "\n", "\t", "\b", "\033#8", "\0337", "\0338", "\033M",
+		"\033D", "\033E", "\033c", "\033(0", "\033(B", "\xe4\xb8\xad", "\xcc\x81",
+		"\xff", "\033]0;title\a", "\033]2;x\033\\", "\033P", "\033", "\a",
+	};
+	static const int params[] = {0, 1, 2, 5, 24, 60, 80, 200, 1000, 999999999};
+	size_t len = 0;
+	while (len + 64 < size) {
+		if (sngRandBounded(r, 3) == 0) {
+			const char *s = texts[sngRandBounded(r, sizeof(texts) / sizeof(texts[0]))];
+			size_t n = strlen(s);
+			memcpy(&buf[len], s, n);
+			len += n;
+			continue;
+		}
+		len += (size_t)snprintf((char *)&buf[len], size - len, "\033[%s", sngRandBounded(r, 4) == 0 ? "?" : "");
+		int args = (int)sngRandBounded(r, 4);
+		for (int i = 0; i < args; i++) {
+			int v = params[sngRandBounded(r, sizeof(params) / sizeof(params[0]))];
+			if (sngRandBounded(r, 2)) {
+				v = (int)sngRandBounded(r, 2100);
+			}
+			len += (size_t)snprintf((char *)&buf[len], size - len, i > 0 ? ";%d" : "%d", v);
+		}
+		buf[len++] = (u8)finals[sngRandBounded(r, (u32)strlen(finals))];
+	}
+	return len;
+}
+
+static void testRandom(void) {
+	SngRand r;
+	sngRandInit(&r, 2048);
+	size_t size = 1 << 14;
+	u8 *buf = (u8 *)malloc(size);
+	SngTerm *t = newTerm();
+	size_t poolSize = sngTermRowPoolSize(WIDTH, HEIGHT);
+	void *poolMem = malloc(poolSize);
+	SngTermRowPool pool;
+	sngTermRowPoolInit(&pool, poolMem, poolSize, WIDTH);
+	size_t pooledSize = sngTermAllocSizePooled(WIDTH, HEIGHT);
+	SngTerm *pooled = sngTermInitPooled(malloc(pooledSize), pooledSize, WIDTH, HEIGHT, &pool, HEIGHT);
+	sngTermSetSize(pooled, WIDTH, HEIGHT);
+	u64 worst = 0;
+	for (int i = 0; i < 200; i++) {
+		size_t len = randomInput(&r, buf, size);
+		if (i % 20 == 19) {
+			sngTermSetSize(t, 1 + (int)sngRandBounded(&r, WIDTH), 1 + (int)sngRandBounded(&r, HEIGHT));
+		}
+		u64 c = writeInput(t, buf, len, 1 + sngRandBounded(&r, 512));
+		writeInput(pooled, buf, len, len);
+		worst = c / len > worst ? c / len : worst;
+		const char *err = checkTerm(t);
+		if (err == NULL) {
+			err = checkTerm(pooled);
+		}
+		if (err == NULL && sngTermRowsHeld(pooled) + pool.rowsFree != HEIGHT) {
+			err = "pool rows leaked";
+		}
+		if (err != NULL) {
+			FAIL("random input %d: %s", i, err);
+			break;
+		}
+	}
+	// Random inputs are short, so they get twice the budget for noise.
+	if (worst > 2*BUDGET) {
+		FAIL("random input took %d cycles/byte, over the budget of %d", (int)worst, BUDGET);
+	}
+	sngTermRelease(pooled);
+	free(pooled);
+	free(poolMem);
+	free(t);
+	free(buf);
+}
+
+// testCorruptSaves saves terminals left partway through random input,
+// changes a few bits, and loads the result, which must either be refused
+// or give a consistent terminal that keeps working.
+static void testCorruptSaves(void) {
+	SngRand r;
+	sngRandInit(&r, 4096);
+	size_t size = 1 << 14;
+	u8 *buf = (u8 *)malloc(size);
+	size_t saveSize = sngTermSaveSize(WIDTH, HEIGHT);
+	u8 *save = (u8 *)malloc(saveSize);
+	SngTerm *t = newTerm();
+	SngTerm *u = newTerm();
+	int loaded = 0;
+	for (int i = 0; i < 200; i++) {
+		size_t len = randomInput(&r, buf, size);
+		// Cut short, so the save often lands inside a sequence.
+		writeInput(t, buf, 1 + sngRandBounded(&r, (u32)len), len);
+		size_t saveLen = sngTermSave(t, save, saveSize);
+		size_t fixed = _SNG_TERM_SIZEOF_SAVE_FIXED(t->width);
+		size_t parser = fixed - sizeof(_SngTermSTR);
+		int flips = 1 + (int)sngRandBounded(&r, 3);
+		for (int j = 0; j < flips; j++) {
+			size_t at;
+			switch (sngRandBounded(&r, 4)) {
+				case 0: at = sngRandBounded(&r, sizeof(_SngTermSaveHeader)); break;
+				case 1: at = parser + sngRandBounded(&r, sizeof(_SngTermSTR)); break;
+				case 2: at = sngRandBounded(&r, (u32)fixed); break;
+				default: at = sngRandBounded(&r, (u32)saveLen); break;
+			}
+			save[at] ^= (u8)(1u << sngRandBounded(&r, 8));
+		}
+		if (!sngTermLoad(u, save, saveLen)) {
+			continue;
+		}
+		loaded++;
+		writeInput(u, buf, len, len);
+		const char *err = checkTerm(u);
+		if (err != NULL) {
+			FAIL("corrupt save %d: %s", i, err);
+			break;
+		}
+	}
+	if (loaded == 0) {
+		FAIL("no corrupt save loaded");
+	}
+	free(u);
+	free(t);
+	free(save);
+	free(buf);
+}
+
+// fuzzOne runs one input through terminals of a few shapes, split into
+// chunks at a size taken from its first byte, and returns what is wrong,
+// or NULL.
+static const char *fuzzOne(const u8 *data, size_t len) {
+	static SngTerm *t;
+	if (t == NULL) {
+		t = newTerm();
+	}
+	size_t chunk = len > 0 ? (size_t)data[0] + 1 : 1;
+	sngTermSetSize(t, WIDTH, HEIGHT);
+	sngTermWrite(t, "\033c", 2);
+	writeInput(t, data, len, chunk);
+	const char *err = checkTerm(t);
+	if (err != NULL) {
+		return err;
+	}
+	sngTermSetSize(t, 7, 3);
+	writeInput(t, data, len, chunk);
+	return checkTerm(t);
+}
+
+#ifdef SNG_FUZZ_LIBFUZZER
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+	const char *err = fuzzOne(data, size);
+	if (err != NULL) {
+		fprintf(stderr, "fuzz_test: %s\n", err);
+		abort();
+	}
+	return 0;
+}
+#else
+static void runFile(const char *path) {
+	FILE *f = fopen(path, "rb");
+	if (f == NULL) {
+		FAIL("cannot open %s", path);
+		return;
+	}
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	u8 *data = (u8 *)malloc(size > 0 ? (size_t)size : 1);
+	size_t len = fread(data, 1, (size_t)(size > 0 ? size : 0), f);
+	fclose(f);
+	u64 start = cycles();
+	const char *err = fuzzOne(data, len);
+	u64 c = cycles() - start;
+	if (err != NULL) {
+		FAIL("%s: %s", path, err);
+	}
+	printf("%s: %zu bytes, %.1f cycles/byte\n", path, len, (double)c / (double)(2*(len > 0 ? len : 1)));
+	free(data);
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && strcmp(argv[1], "-v") != 0) {
+		for (int i = 1; i < argc; i++) {
+			runFile(argv[i]);
+		}
+		return failures != 0;
+	}
+	testPatterns(argc > 1);
+	testRandom();
+	testCorruptSaves();
+	return failures != 0;
+}
+#endif
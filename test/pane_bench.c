@@ -0,0 +1,314 @@
+#define _GNU_SOURCE // posix_openpt, ptsname, cfmakeraw
+
+#define SNG_TERMINAL_IMPLEMENTATION
+#include "sng_terminal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// pane_bench runs sng_terminal the way a multiplexer does: many children
+// on PTYs, all read by one epoll loop, each into its own SngTerm. Linux
+// only.
+//
+//   pane_bench [-n panes] [-s seconds] [-r KB/s per pane, 0 for no limit]
+//
+// Each child is this program again, writing colored lines at the given
+// rate and stamping them with OSC 777 sequences that hold the time they
+// were written. The parent reports the bytes parsed per second across
+// all panes, percentiles of the time from a stamp being written to it
+// being parsed, its CPU time and its RSS.
+
+#define PANE_WIDTH 80
+#define PANE_HEIGHT 24
+
+// LATENCIES is how many of the latest latency samples are kept, a power
+// of two.
+#define LATENCIES (1 << 20)
+
+typedef struct {
+	SngTerm *t;
+	int fd;
+	int pid;
+	u64 bytes;
+	char stamp[32]; // OSC payload, as it arrives
+	int stampLen;
+	u8 _pad[4];
+} Pane;
+
+static u32 *latencies; // in microseconds
+static size_t latencyCount;
+
+static u64 nowNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000 + (u64)ts.tv_nsec;
+}
+
+// paneStr collects OSC 777 stamps, and records how long ago they were
+// written.
+static void paneStr(void *user, SngTerm *t, u32 type, const char *data, size_t len, int flags) {
+	(void)t;
+	Pane *p = (Pane *)user;
+	if (type != ']') {
+		return;
+	}
+	if (flags & SNG_TERM_STR_BEGIN) {
+		p->stampLen = 0;
+	}
+	size_t room = sizeof(p->stamp) - 1 - (size_t)p->stampLen;
+	size_t n = len < room ? len : room;
+	memcpy(&p->stamp[p->stampLen], data, n);
+	p->stampLen += (int)n;
+	if (!(flags & SNG_TERM_STR_END)) {
+		return;
+	}
+	p->stamp[p->stampLen] = 0;
+	if (strncmp(p->stamp, "777;", 4) != 0) {
+		return;
+	}
+	u64 sent = strtoull(&p->stamp[4], NULL, 10);
+	u64 elapsed = (nowNs() - sent) / 1000;
+	latencies[latencyCount++ & (LATENCIES - 1)] = elapsed > 0xffffffff ? 0xffffffff : (u32)elapsed;
+}
+
+// runChild writes stamped chunks of colored lines to stdout for seconds,
+// at rate bytes per second, or as fast as it can if rate is zero.
+static void runChild(double seconds, double rate) {
+	char lines[4096];
+	size_t linesLen = 0;
+	for (int i = 0; linesLen + 100 < sizeof(lines); i++) {
+		linesLen += (size_t)snprintf(
+			&lines[linesLen], sizeof(lines) - linesLen,
+			"\033[3%dmline %d \033[1mof\033[22m output from pid %d, as a build log might be\033[m\r\n",
+			i % 8, i, (int)getpid()
+		);
+	}
+	// Start when the parent says, once every pane is up.
+	char go;
+	if (read(0, &go, 1) != 1) {
+		return;
+	}
+	char buf[sizeof(lines) + 64];
+	u64 start = nowNs();
+	u64 end = start + (u64)(seconds * 1e9);
+	double sent = 0;
+	for (u64 now = start; now < end; now = nowNs()) {
+		int n = snprintf(buf, sizeof(buf), "\033]777;%llu\a", (unsigned long long)nowNs());
+		memcpy(&buf[n], lines, linesLen);
+		size_t len = (size_t)n + linesLen;
+		for (size_t off = 0; off < len;) {
+			ssize_t w = write(1, &buf[off], len - off);
+			if (w < 0 && errno != EINTR) {
+				return;
+			}
+			off += w > 0 ? (size_t)w : 0;
+		}
+		sent += (double)len;
+		if (rate > 0) {
+			double due = (double)start + sent / rate * 1e9;
+			double wait = due - (double)nowNs();
+			if (wait > 0) {
+				struct timespec ts;
+				ts.tv_sec = (time_t)(wait / 1e9);
+				ts.tv_nsec = (long)(wait - (double)ts.tv_sec * 1e9);
+				nanosleep(&ts, NULL);
+			}
+		}
+	}
+}
+
+// spawnPane starts this program as a child on a new PTY. Returns zero on
+// error.
+static int spawnPane(Pane *p, char **childArgv) {
+	int fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+		perror("posix_openpt");
+		return 0;
+	}
+	struct winsize ws = {};
+	ws.ws_col = PANE_WIDTH;
+	ws.ws_row = PANE_HEIGHT;
+	ioctl(fd, TIOCSWINSZ, &ws);
+	const char *name = ptsname(fd);
+	int pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		close(fd);
+		return 0;
+	}
+	if (pid == 0) {
+		setsid();
+		int slave = open(name, O_RDWR);
+		if (slave < 0) {
+			_exit(127);
+		}
+		struct termios tio;
+		tcgetattr(slave, &tio);
+		cfmakeraw(&tio);
+		tcsetattr(slave, TCSANOW, &tio);
+		dup2(slave, 0);
+		dup2(slave, 1);
+		dup2(slave, 2);
+		execv("/proc/self/exe", childArgv);
+		_exit(127);
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	size_t memSize = sngTermAllocSizeMin(PANE_WIDTH, PANE_HEIGHT);
+	p->t = sngTermInit(malloc(memSize), memSize, PANE_WIDTH, PANE_HEIGHT, NULL);
+	sngTermSetSize(p->t, PANE_WIDTH, PANE_HEIGHT);
+	sngTermSetStrFunc(p->t, paneStr, p);
+	p->fd = fd;
+	p->pid = pid;
+	return 1;
+}
+
+// rssKB returns the resident set size of this process now.
+static long rssKB(void) {
+	FILE *f = fopen("/proc/self/status", "r");
+	if (f == NULL) {
+		return 0;
+	}
+	char line[256];
+	long kb = 0;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (strncmp(line, "VmRSS:", 6) == 0) {
+			kb = strtol(&line[6], NULL, 10);
+		}
+	}
+	fclose(f);
+	return kb;
+}
+
+static int compareU32(const void *a, const void *b) {
+	u32 x = *(const u32 *)a;
+	u32 y = *(const u32 *)b;
+	return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+	int panes = 100;
+	double seconds = 5;
+	double rate = 64; // KB/s per pane
+	if (argc == 4 && strcmp(argv[1], "child") == 0) {
+		runChild(atof(argv[2]), atof(argv[3]));
+		return 0;
+	}
+	int opt;
+	while ((opt = getopt(argc, argv, "n:s:r:")) != -1) {
+		switch (opt) {
+		case 'n': panes = atoi(optarg); break;
+		case 's': seconds = atof(optarg); break;
+		case 'r': rate = atof(optarg); break;
+		default:
+			fprintf(stderr, "usage: %s [-n panes] [-s seconds] [-r KB/s per pane]\n", argv[0]);
+			return 1;
+		}
+	}
+	// Each pane takes a descriptor.
+	struct rlimit lim;
+	if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+		lim.rlim_cur = lim.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &lim);
+	}
+
+	char secondsArg[32];
+	char rateArg[32];
+	snprintf(secondsArg, sizeof(secondsArg), "%f", seconds);
+	snprintf(rateArg, sizeof(rateArg), "%f", rate * 1024);
+	char child[] = "child";
+	char *childArgv[] = {argv[0], child, secondsArg, rateArg, NULL};
+
+	latencies = (u32 *)calloc(LATENCIES, sizeof(u32));
+	memset(latencies, 0, sizeof(u32) * LATENCIES); // counted before the panes
+	static char buf[1 << 16];
+	memset(buf, 0, sizeof(buf));
+	Pane *pane = (Pane *)calloc((size_t)panes, sizeof(Pane));
+	long rssBefore = rssKB();
+	int epfd = epoll_create1(EPOLL_CLOEXEC);
+	int alive = 0;
+	for (int i = 0; i < panes; i++) {
+		if (!spawnPane(&pane[i], childArgv)) {
+			break;
+		}
+		struct epoll_event ev = {};
+		ev.events = EPOLLIN;
+		ev.data.ptr = &pane[i];
+		epoll_ctl(epfd, EPOLL_CTL_ADD, pane[i].fd, &ev);
+		alive++;
+	}
+	int spawned = alive;
+	u64 start = nowNs();
+	for (int i = 0; i < spawned; i++) {
+		if (write(pane[i].fd, "\n", 1) != 1) {
+			perror("write");
+		}
+	}
+
+	// One read per ready pane per wakeup, so a busy pane cannot starve the
+	// others.
+	struct epoll_event events[256];
+	u64 total = 0;
+	while (alive > 0) {
+		int n = epoll_wait(epfd, events, 256, 1000);
+		for (int i = 0; i < n; i++) {
+			Pane *p = (Pane *)events[i].data.ptr;
+			ssize_t r = read(p->fd, buf, sizeof(buf));
+			if (r > 0) {
+				sngTermWrite(p->t, buf, (size_t)r);
+				p->bytes += (u64)r;
+				total += (u64)r;
+			} else if (r == 0 || errno != EAGAIN) {
+				// EIO once the child has exited
+				epoll_ctl(epfd, EPOLL_CTL_DEL, p->fd, NULL);
+				close(p->fd);
+				waitpid(p->pid, NULL, 0);
+				alive--;
+			}
+		}
+	}
+	double elapsed = (double)(nowNs() - start) / 1e9;
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	double cpu =
+		(double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1e6 +
+		(double)ru.ru_stime.tv_sec + (double)ru.ru_stime.tv_usec / 1e6;
+
+	size_t samples = latencyCount < LATENCIES ? latencyCount : LATENCIES;
+	qsort(latencies, samples, sizeof(u32), compareU32);
+	double pct[] = {0.5, 0.9, 0.99, 0.999, 1.0};
+	u64 slowest = total;
+	for (int i = 0; i < spawned; i++) {
+		slowest = pane[i].bytes < slowest ? pane[i].bytes : slowest;
+	}
+	printf(
+		"%d panes, %.1f s: %.1f MB/s parsed, %.1f KB/s per pane (slowest %.1f), parent CPU %.0f%%\n",
+		spawned, elapsed, (double)total / elapsed / 1e6,
+		(double)total / elapsed / 1024 / (spawned > 0 ? spawned : 1),
+		(double)slowest / elapsed / 1024, 100 * cpu / elapsed
+	);
+	printf("latency over %zu stamps:", samples);
+	for (size_t i = 0; i < sizeof(pct) / sizeof(pct[0]) && samples > 0; i++) {
+		printf(" p%g %.2f ms", pct[i] * 100, (double)latencies[(size_t)(pct[i] * (double)(samples - 1))] / 1000);
+	}
+	printf("\n");
+	printf(
+		"peak RSS %ld KB, %.1f KB per pane\n",
+		ru.ru_maxrss, (double)(ru.ru_maxrss - rssBefore) / (spawned > 0 ? spawned : 1)
+	);
+	for (int i = 0; i < spawned; i++) {
+		free(pane[i].t);
+	}
+	free(pane);
+	free(latencies);
+	return 0;
+}
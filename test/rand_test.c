@@ -0,0 +1,347 @@
+#define SNG_RAND_IMPLEMENTATION
+#include "sng_rand.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// rand_test runs a small statistical battery against sng_rand by default.
+//
+//   rand_test        run the battery; exits non-zero on failure
+//   rand_test bench  print ns/number for each API
+//   rand_test pipe   stream raw sngRandU32 output to stdout, for example
+//                    into PractRand's `RNG_test stdin32`
+//
+// The battery is not a replacement for TestU01 or PractRand, but it
+// catches gross mistakes in the generator and in the distributions.
+
+// Any statistic beyond this many standard deviations from the mean fails.
+// The probability of a false failure is roughly 6e-7 per check.
+#define Z_LIMIT 5.0
+
+static int failures = 0;
+
+static void check(const char *file, int line, const char *name, double z) {
+	if (fabs(z) > Z_LIMIT) {
+		fprintf(stderr, "%s:%d: %s failed, z=%f\n", file, line, name, z);
+		failures++;
+	}
+}
+
+#define CHECK(name, z) check(__FILE__, __LINE__, name, z)
+
+// chiSquareZ returns the chi-square statistic of observed against expected,
+// normalized to a standard normal via the Wilson-Hilferty transform.
+static double chiSquareZ(const double *observed, const double *expected, int bins) {
+	double chi = 0.0;
+	for (int i = 0; i < bins; i++) {
+		double d = observed[i] - expected[i];
+		chi += d * d / expected[i];
+	}
+	double k = (double)(bins - 1);
+	double h = 2.0 / (9.0 * k);
+	return (pow(chi / k, 1.0 / 3.0) - (1.0 - h)) / sqrt(h);
+}
+
+static void testBytes(SngRand *r) {
+	enum { N = 1 << 22 };
+	double observed[4][256];
+	double expected[256];
+	memset(observed, 0, sizeof(observed));
+	for (int i = 0; i < 256; i++) {
+		expected[i] = (double)N / 256.0;
+	}
+	for (int i = 0; i < N; i++) {
+		u32 x = sngRandU32(r);
+		observed[0][x & 0xff] += 1.0;
+		observed[1][(x >> 8) & 0xff] += 1.0;
+		observed[2][(x >> 16) & 0xff] += 1.0;
+		observed[3][x >> 24] += 1.0;
+	}
+	for (int i = 0; i < 4; i++) {
+		CHECK("byte chi-square", chiSquareZ(observed[i], expected, 256));
+	}
+}
+
+static void testBounded(SngRand *r) {
+	enum { N = 1 << 21 };
+	// A bound of 3*2^30 makes modulo reduction visibly biased: 2^32 wraps
+	// past it once more over [0, 2^30), so the lowest third of the range
+	// would be hit twice as often as either of the others.
+	u32 n = 0xc0000000u;
+	double observed[3] = {0};
+	double expected[3] = {N / 3.0, N / 3.0, N / 3.0};
+	for (int i = 0; i < N; i++) {
+		u32 x = sngRandBounded(r, n);
+		if (x >= n) {
+			fprintf(stderr, "%s:%d: sngRandBounded out of range\n", __FILE__, __LINE__);
+			failures++;
+			return;
+		}
+		observed[x / 0x40000000u] += 1.0;
+	}
+	CHECK("bounded chi-square", chiSquareZ(observed, expected, 3));
+
+	double small[7] = {0};
+	double smallExpected[7];
+	for (int i = 0; i < 7; i++) {
+		smallExpected[i] = N / 7.0;
+	}
+	u32 buf[1024];
+	for (int i = 0; i < N; i += 1024) {
+		sngRandBoundedN(r, 7, buf, 1024);
+		for (int j = 0; j < 1024; j++) {
+			small[buf[j]] += 1.0;
+		}
+	}
+	CHECK("bounded bulk chi-square", chiSquareZ(small, smallExpected, 7));
+}
+
+static void testFloats(SngRand *r) {
+	enum { N = 1 << 21, BINS = 64 };
+	double observed32[BINS] = {0};
+	double observed64[BINS] = {0};
+	double expected[BINS];
+	for (int i = 0; i < BINS; i++) {
+		expected[i] = (double)N / BINS;
+	}
+	for (int i = 0; i < N; i++) {
+		f32 a = sngRandF32(r);
+		f64 b = sngRandF64(r);
+		if (a < 0.0f || a >= 1.0f || b < 0.0 || b >= 1.0) {
+			fprintf(stderr, "%s:%d: float out of range %f %f\n", __FILE__, __LINE__, (f64)a, b);
+			failures++;
+			return;
+		}
+		observed32[(int)(a * BINS)] += 1.0;
+		observed64[(int)(b * BINS)] += 1.0;
+	}
+	CHECK("f32 chi-square", chiSquareZ(observed32, expected, BINS));
+	CHECK("f64 chi-square", chiSquareZ(observed64, expected, BINS));
+}
+
+static double normalCDF(double x) {
+	return 0.5 * erfc(-x / sqrt(2.0));
+}
+
+static void testNormal(SngRand *r) {
+	enum { N = 1 << 21, BINS = 40 };
+	// bins of width 0.25 over [-5, 5], with the outer bins open ended
+	double observed[BINS] = {0};
+	double expected[BINS];
+	for (int i = 0; i < BINS; i++) {
+		double lo = (i == 0) ? -INFINITY : -5.0 + i * 0.25;
+		double hi = (i == BINS-1) ? INFINITY : -5.0 + (i + 1) * 0.25;
+		expected[i] = N * (normalCDF(hi) - normalCDF(lo));
+	}
+	f32 buf[1024];
+	for (int i = 0; i < N; i += 1024) {
+		sngRandNormalN(r, buf, 1024);
+		for (int j = 0; j < 1024; j++) {
+			int bin = (int)floor((buf[j] + 5.0) / 0.25);
+			if (bin < 0) bin = 0;
+			if (bin >= BINS) bin = BINS-1;
+			observed[bin] += 1.0;
+		}
+	}
+	// merge sparse tail bins so every expected count is large enough
+	double o[BINS], e[BINS];
+	int bins = 0;
+	double accO = 0.0, accE = 0.0;
+	for (int i = 0; i < BINS; i++) {
+		accO += observed[i];
+		accE += expected[i];
+		if (accE >= 20.0) {
+			o[bins] = accO;
+			e[bins] = accE;
+			bins++;
+			accO = accE = 0.0;
+		}
+	}
+	o[bins-1] += accO;
+	e[bins-1] += accE;
+	CHECK("normal chi-square", chiSquareZ(o, e, bins));
+}
+
+static void testExponential(SngRand *r) {
+	enum { N = 1 << 21, BINS = 48 };
+	// bins of width 0.25 over [0, 12], with the last bin open ended
+	double observed[BINS] = {0};
+	double expected[BINS];
+	for (int i = 0; i < BINS; i++) {
+		double lo = i * 0.25;
+		double hi = (i == BINS-1) ? INFINITY : (i + 1) * 0.25;
+		expected[i] = N * (exp(-lo) - exp(-hi));
+	}
+	for (int i = 0; i < N; i++) {
+		f32 x = sngRandExponential(r);
+		int bin = (int)(x / 0.25f);
+		if (x < 0.0f) {
+			fprintf(stderr, "%s:%d: exponential out of range %f\n", __FILE__, __LINE__, (f64)x);
+			failures++;
+			return;
+		}
+		if (bin >= BINS) bin = BINS-1;
+		observed[bin] += 1.0;
+	}
+	double o[BINS], e[BINS];
+	int bins = 0;
+	double accO = 0.0, accE = 0.0;
+	for (int i = 0; i < BINS; i++) {
+		accO += observed[i];
+		accE += expected[i];
+		if (accE >= 20.0) {
+			o[bins] = accO;
+			e[bins] = accE;
+			bins++;
+			accO = accE = 0.0;
+		}
+	}
+	o[bins-1] += accO;
+	e[bins-1] += accE;
+	CHECK("exponential chi-square", chiSquareZ(o, e, bins));
+}
+
+// testGap is Knuth's gap test: the lengths of runs between values landing
+// in [0, 0.25) should be geometrically distributed.
+static void testGap(SngRand *r) {
+	enum { GAPS = 1 << 19, MAX_GAP = 24 };
+	const double p = 0.25;
+	double observed[MAX_GAP+1] = {0};
+	double expected[MAX_GAP+1];
+	for (int i = 0; i < MAX_GAP; i++) {
+		expected[i] = GAPS * p * pow(1.0 - p, i);
+	}
+	expected[MAX_GAP] = GAPS * pow(1.0 - p, MAX_GAP);
+	for (int g = 0; g < GAPS; g++) {
+		int len = 0;
+		while (sngRandF32(r) >= (f32)p) {
+			len++;
+		}
+		observed[(len < MAX_GAP) ? len : MAX_GAP] += 1.0;
+	}
+	CHECK("gap chi-square", chiSquareZ(observed, expected, MAX_GAP+1));
+}
+
+static int compareU32(const void *a, const void *b) {
+	u32 x = *(const u32 *)a;
+	u32 y = *(const u32 *)b;
+	return (x > y) - (x < y);
+}
+
+// testBirthday is Marsaglia's birthday spacings test: choose m birthdays
+// in a year of n days and count duplicate spacings between the sorted
+// birthdays. The count is asymptotically Poisson with mean m^3/(4n).
+static void testBirthday(SngRand *r) {
+	enum { M = 1 << 10, REPS = 1000 };
+	const u32 days = 1u << 24;
+	const double lambda = (double)M * M * M / (4.0 * days);
+	u32 birthdays[M];
+	u32 spacings[M];
+	double total = 0.0;
+	for (int rep = 0; rep < REPS; rep++) {
+		for (int i = 0; i < M; i++) {
+			birthdays[i] = sngRandU32(r) >> 8;
+		}
+		qsort(birthdays, M, sizeof(u32), compareU32);
+		spacings[0] = birthdays[0];
+		for (int i = 1; i < M; i++) {
+			spacings[i] = birthdays[i] - birthdays[i-1];
+		}
+		qsort(spacings, M, sizeof(u32), compareU32);
+		for (int i = 1; i < M; i++) {
+			if (spacings[i] == spacings[i-1]) {
+				total += 1.0;
+			}
+		}
+	}
+	double mean = lambda * REPS;
+	CHECK("birthday spacings", (total - mean) / sqrt(mean));
+}
+
+static double nowNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// sink keeps the compiler from discarding benchmarked results.
+static volatile u32 sink;
+
+#define BENCH(name, count, body) do { \
+	double start = nowNs(); \
+	for (size_t i = 0; i < (count); i++) { \
+		body; \
+	} \
+	double elapsed = nowNs() - start; \
+	printf("%-28s %8.3f ns/number\n", name, elapsed / (double)(count)); \
+} while (0)
+
+#define BENCH_BULK(name, count, buf, body) do { \
+	double start = nowNs(); \
+	for (size_t i = 0; i < (count); i += sizeof(buf)/sizeof(buf[0])) { \
+		body; \
+		sink ^= (u32)buf[0]; \
+	} \
+	double elapsed = nowNs() - start; \
+	printf("%-28s %8.3f ns/number\n", name, elapsed / (double)(count)); \
+} while (0)
+
+static void bench(SngRand *r) {
+	const size_t count = 1 << 25;
+	u32 bufU32[4096];
+	f32 bufF32[4096];
+	f64 bufF64[4096];
+	u32 acc = 0;
+	f64 accF = 0.0;
+
+	// libc rand() is the reference engine; it only fills 31 bits at most.
+	BENCH("libc rand", count, acc += (u32)rand());
+	BENCH("sngRandU32", count, acc += sngRandU32(r));
+	BENCH("sngRandF32", count, accF += (f64)sngRandF32(r));
+	BENCH("sngRandF64", count, accF += sngRandF64(r));
+	BENCH("sngRandBounded(1000)", count, acc += sngRandBounded(r, 1000));
+	BENCH("sngRandU32() % 1000", count, acc += sngRandU32(r) % 1000);
+	BENCH("sngRandNormal", count, accF += (f64)sngRandNormal(r));
+	BENCH("sngRandExponential", count, accF += (f64)sngRandExponential(r));
+	BENCH_BULK("sngRandU32N", count, bufU32, sngRandU32N(r, bufU32, 4096));
+	BENCH_BULK("sngRandF32N", count, bufF32, sngRandF32N(r, bufF32, 4096));
+	BENCH_BULK("sngRandF64N", count, bufF64, sngRandF64N(r, bufF64, 4096));
+	BENCH_BULK("sngRandBoundedN(1000)", count, bufU32, sngRandBoundedN(r, 1000, bufU32, 4096));
+	BENCH_BULK("sngRandNormalN", count, bufF32, sngRandNormalN(r, bufF32, 4096));
+	BENCH_BULK("sngRandExponentialN", count, bufF32, sngRandExponentialN(r, bufF32, 4096));
+	sink ^= acc ^ (u32)accF;
+}
+
+static void pipeOutput(SngRand *r) {
+	u32 buf[4096];
+	for (;;) {
+		sngRandU32N(r, buf, 4096);
+		if (fwrite(buf, sizeof(buf), 1, stdout) != 1) {
+			return;
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	SngRand *r = (SngRand *)malloc(sizeof(SngRand));
+	sngRandInit(r, 1);
+	if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+		bench(r);
+		return 0;
+	}
+	if (argc > 1 && strcmp(argv[1], "pipe") == 0) {
+		pipeOutput(r);
+		return 0;
+	}
+	testBytes(r);
+	testBounded(r);
+	testFloats(r);
+	testNormal(r);
+	testExponential(r);
+	testGap(r);
+	testBirthday(r);
+	free(r);
+	return failures != 0;
+}
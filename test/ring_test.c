@@ -0,0 +1,300 @@
+#define _GNU_SOURCE // pthread_setaffinity_np
+
+#define SNG_RING_IMPLEMENTATION
+#include "sng_ring.h"
+
+#define SNG_TERMINAL_IMPLEMENTATION
+#include "sng_terminal.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ring_test checks sng_ring on one thread, then across two. Either side
+// yields its core while the ring is full or empty, so the tests also run
+// on one.
+//
+//   ring_test        run the tests; exits non-zero on failure
+//   ring_test bench  print throughput between two threads, each pinned to
+//                    its own core where supported
+
+static int failures = 0;
+
+#define FAIL(...) do { \
+	fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+	fprintf(stderr, __VA_ARGS__); \
+	fprintf(stderr, "\n"); \
+	failures++; \
+} while (0)
+
+// pattern is the byte at position i of the test streams.
+static u8 pattern(size_t i) {
+	return (u8)(i * 7 + (i >> 9));
+}
+
+static void testSingleThread(void) {
+	SngRing ring;
+	u8 buf[16];
+	if (sngRingInit(&ring, buf, 12)) {
+		FAIL("sngRingInit took a size of 12");
+	}
+	sngRingInit(&ring, buf, sizeof(buf));
+
+	u8 in[32];
+	u8 out[32];
+	for (size_t i = 0; i < sizeof(in); i++) {
+		in[i] = pattern(i);
+	}
+	if (sngRingWrite(&ring, in, 10) != 10 || sngRingRead(&ring, out, sizeof(out)) != 10) {
+		FAIL("sngRingWrite or sngRingRead short");
+	}
+	// The next 12 bytes wrap around the end of buf.
+	if (sngRingWrite(&ring, &in[10], 20) != 16) {
+		FAIL("sngRingWrite overfilled the ring");
+	}
+	const u8 *data;
+	size_t n = sngRingReadSpan(&ring, &data);
+	if (n != 6 || memcmp(data, &in[10], n) != 0) {
+		FAIL("sngRingReadSpan returned %d bytes", (int)n);
+	}
+	sngRingReadConsume(&ring, 4);
+	n = sngRingRead(&ring, &out[14], 18);
+	if (n != 12 || memcmp(&out[14], &in[14], n) != 0) {
+		FAIL("sngRingRead returned %d bytes", (int)n);
+	}
+	if (sngRingReadSpan(&ring, &data) != 0) {
+		FAIL("sngRingReadSpan found bytes in an empty ring");
+	}
+
+	// Spans are written in place.
+	u8 *dest;
+	n = sngRingWriteSpan(&ring, &dest);
+	if (n != 6) {
+		FAIL("sngRingWriteSpan returned %d bytes", (int)n);
+	}
+	memset(dest, 'x', 3);
+	if (sngRingReadSpan(&ring, &data) != 0) {
+		FAIL("sngRingReadSpan found bytes before the commit");
+	}
+	sngRingWriteCommit(&ring, 3);
+	if (sngRingReadSpan(&ring, &data) != 3 || data[2] != 'x') {
+		FAIL("sngRingReadSpan did not find the commit");
+	}
+}
+
+typedef struct {
+	SngRing *ring;
+	size_t total;
+	size_t chunk;
+} Producer;
+
+// producePattern writes the pattern in commits of up to chunk bytes,
+// alternating between spans and sngRingWrite.
+static void *producePattern(void *arg) {
+	Producer *p = (Producer *)arg;
+	u8 src[4096];
+	size_t i = 0;
+	while (i < p->total) {
+		size_t want = p->total - i < p->chunk ? p->total - i : p->chunk;
+		if ((i / p->chunk) & 1) {
+			if (want > sizeof(src)) {
+				want = sizeof(src);
+			}
+			for (size_t j = 0; j < want; j++) {
+				src[j] = pattern(i + j);
+			}
+			size_t n = sngRingWrite(p->ring, src, want);
+			if (n == 0) {
+				sched_yield();
+			}
+			i += n;
+			continue;
+		}
+		u8 *dest;
+		size_t n = sngRingWriteSpan(p->ring, &dest);
+		if (n == 0) {
+			sched_yield();
+			continue;
+		}
+		n = n < want ? n : want;
+		for (size_t j = 0; j < n; j++) {
+			dest[j] = pattern(i + j);
+		}
+		sngRingWriteCommit(p->ring, n);
+		i += n;
+	}
+	return NULL;
+}
+
+static void testTwoThreads(void) {
+	SngRing ring;
+	size_t size = 1 << 12;
+	u8 *buf = (u8 *)malloc(size);
+	sngRingInit(&ring, buf, size);
+	Producer p;
+	p.ring = &ring;
+	p.total = (size_t)1 << 24;
+	p.chunk = 1000;
+	pthread_t thread;
+	pthread_create(&thread, NULL, producePattern, &p);
+	size_t i = 0;
+	while (i < p.total) {
+		const u8 *data;
+		size_t n = sngRingReadSpan(&ring, &data);
+		if (n == 0) {
+			sched_yield();
+			continue;
+		}
+		for (size_t j = 0; j < n; j++) {
+			if (data[j] != pattern(i + j)) {
+				FAIL("byte %d is %d, not %d", (int)(i + j), data[j], pattern(i + j));
+				i = p.total;
+				break;
+			}
+		}
+		sngRingReadConsume(&ring, n);
+		i += n;
+	}
+	pthread_join(thread, NULL);
+	free(buf);
+}
+
+static void pinThread(size_t cpu) {
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)cpu;
+#endif
+}
+
+// sink keeps the sums of benchRing from being optimized away.
+static volatile u64 sink;
+
+static double nowNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+typedef struct {
+	SngRing *ring;
+	const u8 *src;
+	size_t srcLen;
+	size_t total;
+	size_t chunk;
+} BenchProducer;
+
+// produceCopies copies src into the ring over and over, committing every
+// chunk bytes, as a PTY reader passing the ring to read() would.
+static void *produceCopies(void *arg) {
+	BenchProducer *p = (BenchProducer *)arg;
+	pinThread(1);
+	size_t i = 0;
+	while (i < p->total) {
+		u8 *dest;
+		size_t n = sngRingWriteSpan(p->ring, &dest);
+		if (n == 0) {
+			sched_yield();
+			continue;
+		}
+		size_t off = i % p->srcLen;
+		n = n < p->chunk ? n : p->chunk;
+		n = n < p->srcLen - off ? n : p->srcLen - off;
+		memcpy(dest, &p->src[off], n);
+		sngRingWriteCommit(p->ring, n);
+		i += n;
+	}
+	return NULL;
+}
+
+// benchRing streams total bytes of src through a ring of size bytes, and
+// either sums them or parses them with a SngTerm on this thread.
+static void benchRing(const char *name, const u8 *src, size_t srcLen, size_t total, size_t size, size_t chunk, SngTerm *t) {
+	SngRing ring;
+	u8 *buf = (u8 *)malloc(size);
+	sngRingInit(&ring, buf, size);
+	BenchProducer p;
+	p.ring = &ring;
+	p.src = src;
+	p.srcLen = srcLen;
+	p.total = total;
+	p.chunk = chunk;
+	pinThread(0);
+	double start = nowNs();
+	pthread_t thread;
+	pthread_create(&thread, NULL, produceCopies, &p);
+	u64 sum = 0;
+	size_t i = 0;
+	while (i < total) {
+		const u8 *data;
+		size_t n = sngRingReadSpan(&ring, &data);
+		if (n == 0) {
+			sched_yield();
+			continue;
+		}
+		if (t != NULL) {
+			sngTermWrite(t, data, n);
+		} else {
+			size_t j = 0;
+			for (; j + 8 <= n; j += 8) {
+				u64 word;
+				memcpy(&word, &data[j], 8);
+				sum += word;
+			}
+			for (; j < n; j++) {
+				sum += data[j];
+			}
+		}
+		sngRingReadConsume(&ring, n);
+		i += n;
+	}
+	pthread_join(thread, NULL);
+	double elapsed = nowNs() - start;
+	printf("%-32s %8.2f GB/s\n", name, (double)total / elapsed);
+	sink ^= sum;
+	free(buf);
+}
+
+static void bench(void) {
+	size_t srcLen = 1 << 16;
+	u8 *src = (u8 *)malloc(srcLen);
+	for (size_t i = 0; i < srcLen; i++) {
+		src[i] = pattern(i);
+	}
+	size_t total = (size_t)1 << 32;
+	benchRing("ring 1M, 64K commits", src, srcLen, total, 1 << 20, 1 << 16, NULL);
+	benchRing("ring 1M, 4K commits", src, srcLen, total, 1 << 20, 1 << 12, NULL);
+	benchRing("ring 64K, 512 byte commits", src, srcLen, total >> 2, 1 << 16, 512, NULL);
+
+	// The same with a terminal parsing on the consumer side, straight
+	// from ring memory.
+	size_t textLen = 0;
+	for (int line = 0; textLen + 64 < srcLen; line++) {
+		textLen += (size_t)snprintf(
+			(char *)&src[textLen], srcLen - textLen,
+			"\033[3%dmline %d of some plain output\033[m\r\n", line % 8, line
+		);
+	}
+	size_t memSize = sngTermAllocSize(200, 60);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, 200, 60, NULL);
+	sngTermSetSize(t, 200, 60);
+	benchRing("ring 1M to sngTermWrite", src, textLen, total >> 5, 1 << 20, 1 << 16, t);
+	free(t);
+	free(src);
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+		bench();
+		return 0;
+	}
+	testSingleThread();
+	testTwoThreads();
+	return failures != 0;
+}
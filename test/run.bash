@@ -14,11 +14,24 @@ if [ "$1" == "-v" ]; then
 	set -x
 fi
 
-cc -o bin/build_c_test $FLAGS build_c_test.c
+cc -o bin/build_c_test $FLAGS build_c_test.c -lm
 ./bin/build_c_test
 
-cc -o bin/build_cpp_test $FLAGS build_cpp_test.cpp
+cc -o bin/build_cpp_test $FLAGS build_cpp_test.cpp -lm
 ./bin/build_cpp_test
 
-cc -o bin/terminal_test $FLAGS terminal_test.cpp
+cc -o bin/terminal_test $FLAGS terminal_test.cpp -pthread
 ./bin/terminal_test
+
+cc -o bin/rand_test $FLAGS rand_test.c -lm
+./bin/rand_test
+
+cc -o bin/ring_test $FLAGS ring_test.c -pthread
+./bin/ring_test
+
+cc -o bin/termrec_test $FLAGS termrec_test.c
+./bin/termrec_test
+
+# Optimized, since it holds the parser to a budget of cycles per byte.
+cc -o bin/fuzz_test $FLAGS -O2 fuzz_test.c -lm
+./bin/fuzz_test
@@ -0,0 +1,389 @@
+#define SNG_TERMINAL_IMPLEMENTATION
+#include "sng_terminal.h"
+
+#include <time.h>
+
+// terminal_bench measures parse throughput of sng_terminal on synthetic
+// output streams. Run it through bench.bash, which builds with -O2.
+
+static double nowNs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static SngTerm *newTerm(int width, int height) {
+	size_t memSize = sngTermAllocSize(width, height);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, width, height, NULL);
+	sngTermSetSize(t, width, height);
+	return t;
+}
+
+struct Stream {
+	char *buf;
+	size_t len;
+	size_t cap;
+	size_t escapes;
+};
+
+static void streamPut(Stream *s, const char *str) {
+	size_t n = strlen(str);
+	if (s->len + n > s->cap) {
+		s->cap = (s->cap + n) * 2;
+		s->buf = (char *)realloc(s->buf, s->cap);
+	}
+	memcpy(&s->buf[s->len], str, n);
+	s->len += n;
+}
+
+// benchStream parses s repeatedly for at least 64MB, and prints ns/byte
+// and ns per escape sequence.
+static void benchStream(const char *name, Stream *s) {
+	SngTerm *t = newTerm(80, 24);
+	size_t total = 0;
+	size_t reps = 0;
+	double start = nowNs();
+	while (total < ((size_t)64 << 20)) {
+		sngTermWrite(t, s->buf, s->len);
+		total += s->len;
+		reps++;
+	}
+	double elapsed = nowNs() - start;
+	printf(
+		"%-28s %8.3f ns/byte %8.1f MB/s %8.3f ns/escape\n",
+		name,
+		elapsed / (double)total,
+		(double)total / elapsed * 1e3,
+		elapsed / (double)(s->escapes * reps)
+	);
+	free(t);
+}
+
+enum {
+	COLOR_256,
+	COLOR_TRUE,     // 256 distinct truecolors, over and over
+	COLOR_GRADIENT, // a new truecolor for every word
+};
+
+// colorStream builds lines of text where every word changes color, in
+// the style of syntax highlighted or gradient output.
+static void colorStream(Stream *s, int kind) {
+	char seq[64];
+	for (int line = 0; line < 1000; line++) {
+		for (int word = 0; word < 10; word++) {
+			int i = line * 10 + word;
+			if (kind == COLOR_TRUE) {
+				snprintf(seq, sizeof(seq), "\033[38;2;%d;%d;%dm", (i * 7) & 0xff, (i * 13) & 0xff, 128);
+			} else if (kind == COLOR_GRADIENT) {
+				snprintf(seq, sizeof(seq), "\033[38;2;%d;%d;%dm", i & 0xff, (i >> 8) & 0xff, 128);
+			} else {
+				snprintf(seq, sizeof(seq), "\033[38;5;%dm", 16 + i % 216);
+			}
+			streamPut(s, seq);
+			streamPut(s, "word ");
+			s->escapes++;
+		}
+		streamPut(s, "\033[m\r\n");
+		s->escapes++;
+	}
+}
+
+static void benchColors() {
+	Stream s256 = {};
+	Stream sRGB = {};
+	Stream sGradient = {};
+	colorStream(&s256, COLOR_256);
+	colorStream(&sRGB, COLOR_TRUE);
+	colorStream(&sGradient, COLOR_GRADIENT);
+	benchStream("256 color SGR", &s256);
+	benchStream("truecolor SGR", &sRGB);
+	benchStream("truecolor gradient SGR", &sGradient);
+	free(s256.buf);
+	free(sRGB.buf);
+	free(sGradient.buf);
+}
+
+// redrawStream builds full screen redraws in the style of htop or a pager:
+// clear the screen, then write short colored lines, each cleared to its
+// end so leftovers of the previous frame go away.
+static void redrawStream(Stream *s) {
+	char seq[64];
+	for (int frame = 0; frame < 200; frame++) {
+		streamPut(s, "\033[H\033[2J");
+		s->escapes += 2;
+		for (int line = 0; line < 24; line++) {
+			snprintf(seq, sizeof(seq), "\033[%d;1H\033[4%dm", line + 1, (frame + line) % 8);
+			streamPut(s, seq);
+			streamPut(s, (line & 1) ? "  PID USER" : "  1234 root  20   0");
+			streamPut(s, "\033[K\033[m");
+			s->escapes += 4;
+		}
+	}
+}
+
+static void benchRedraw() {
+	Stream s = {};
+	redrawStream(&s);
+	benchStream("clear heavy redraw", &s);
+	free(s.buf);
+}
+
+// editStream builds readline style editing in insert mode: the cursor
+// sits in the middle of a long line and text is typed in front of the
+// rest of it.
+static void editStream(Stream *s) {
+	for (int line = 0; line < 1000; line++) {
+		streamPut(s, "\033[4h\r\033[K$ some long command line with arguments\033[20G");
+		s->escapes += 4;
+		for (int word = 0; word < 4; word++) {
+			streamPut(s, "inserted ");
+		}
+		streamPut(s, "\033[4l\r\n");
+		s->escapes++;
+	}
+}
+
+static void benchEdit() {
+	Stream s = {};
+	editStream(&s);
+	benchStream("insert mode editing", &s);
+	free(s.buf);
+}
+
+// wideStream builds lines of CJK text mixed with accented Latin text,
+// which goes through the width table for every character.
+static void wideStream(Stream *s) {
+	for (int line = 0; line < 1000; line++) {
+		streamPut(s, "\xe6\xbc\xa2\xe5\xad\x97\xe3\x81\xa8\xe3\x81\x8b\xe3\x81\xaa ");
+		streamPut(s, "caf\xc3\xa9 e\xcc\x81t\xc3\xa9 \xed\x95\x9c\xea\xb8\x80\r\n");
+		s->escapes++;
+	}
+}
+
+static void benchWide() {
+	Stream s = {};
+	wideStream(&s);
+	benchStream("wide and combining text", &s);
+	free(s.buf);
+}
+
+// benchReflow measures rewrapping a full screen of long wrapped lines, as
+// when a pane is drag-resized.
+static void benchReflow() {
+	int width = 400;
+	int height = 200;
+	SngTerm *t = newTerm(width, height);
+	const char *wrap = "\033[?7h";
+	sngTermWrite(t, wrap, strlen(wrap));
+	for (int i = 0; i < height * 3; i++) {
+		const char *text = "some words of text that wrap over several rows ";
+		for (int j = 0; j < 20; j++) {
+			sngTermWrite(t, text, strlen(text));
+		}
+		sngTermWrite(t, "\r\n", 2);
+	}
+	size_t scratchSize = sngTermReflowScratchSize(width, height);
+	void *scratch = malloc(scratchSize);
+	int reps = 2000;
+	double start = nowNs();
+	for (int i = 0; i < reps; i++) {
+		sngTermSetSizeReflow(t, (i & 1) ? width : width - 1 - i % 97, height, scratch, scratchSize);
+	}
+	double elapsed = nowNs() - start;
+	printf(
+		"%-28s %8.1f us/resize %8.3f ns/cell\n",
+		"reflow 400x200",
+		elapsed / reps / 1e3,
+		elapsed / reps / (width * height)
+	);
+	free(scratch);
+	free(t);
+}
+
+// benchRuns measures walking a full screen of colored text as style runs,
+// as a renderer does every frame.
+static void benchRuns() {
+	int width = 200;
+	int height = 60;
+	SngTerm *t = newTerm(width, height);
+	Stream s = {};
+	colorStream(&s, COLOR_256);
+	sngTermWrite(t, s.buf, s.len);
+	free(s.buf);
+	char text[256];
+	size_t bytes = 0;
+	int reps = 2000;
+	double start = nowNs();
+	for (int i = 0; i < reps; i++) {
+		for (int y = 0; y < height; y++) {
+			SngTermRun run;
+			for (int x = 0; (x = sngTermLineRun(t, y, x, &run, text, sizeof(text))) != 0;) {
+				bytes += run.textLen;
+			}
+		}
+	}
+	double elapsed = nowNs() - start;
+	printf(
+		"%-28s %8.1f us/frame %8.3f ns/cell\n",
+		"style runs 200x60",
+		elapsed / reps / 1e3,
+		elapsed / reps / (width * height)
+	);
+	if (bytes == 0) {
+		printf("no text\n");
+	}
+	free(t);
+}
+
+// benchResolve measures resolving the colors of a full screen, as a
+// renderer drawing cells rather than runs does every frame.
+static void benchResolve() {
+	int width = 200;
+	int height = 60;
+	SngTerm *t = newTerm(width, height);
+	Stream s = {};
+	colorStream(&s, COLOR_256);
+	sngTermWrite(t, s.buf, s.len);
+	free(s.buf);
+	u16 fg[200], bg[200];
+	u32 sum = 0;
+	int reps = 5000;
+	double start = nowNs();
+	for (int i = 0; i < reps; i++) {
+		for (int y = 0; y < height; y++) {
+			sngTermResolveColors(sngTermLine(t, y), width, t->mode, fg, bg);
+			sum += fg[y] ^ bg[width-1-y];
+		}
+	}
+	double elapsed = nowNs() - start;
+	printf(
+		"%-28s %8.1f us/frame %8.3f ns/cell\n",
+		"resolve colors 200x60",
+		elapsed / reps / 1e3,
+		elapsed / reps / (width * height)
+	);
+	if (sum == 1) {
+		printf("\n");
+	}
+	free(t);
+}
+
+// benchCopyText measures copying the text of a full screen out, as a
+// capture-pane or log scraper does.
+static void benchCopyText() {
+	int width = 200;
+	int height = 60;
+	SngTerm *t = newTerm(width, height);
+	Stream s = {};
+	colorStream(&s, COLOR_256);
+	sngTermWrite(t, s.buf, s.len);
+	free(s.buf);
+	size_t size = (size_t)(width * 4 + 1) * (size_t)height;
+	char *text = (char *)malloc(size);
+	size_t bytes = 0;
+	int reps = 5000;
+	double start = nowNs();
+	for (int i = 0; i < reps; i++) {
+		bytes += sngTermCopyText(t, 0, 0, width-1, height-1, text, size);
+	}
+	double elapsed = nowNs() - start;
+	printf(
+		"%-28s %8.1f us/screen %8.3f ns/byte\n",
+		"copy text 200x60",
+		elapsed / reps / 1e3,
+		elapsed / (double)bytes
+	);
+	free(text);
+	free(t);
+}
+
+// benchSearch measures searching a full screen for a pattern it does not
+// hold, though its first letter is common, then searching only what
+// changed after one row is written.
+static void benchSearch() {
+	int width = 200;
+	int height = 60;
+	SngTerm *t = newTerm(width, height);
+	Stream s = {};
+	colorStream(&s, COLOR_256);
+	sngTermWrite(t, s.buf, s.len);
+	free(s.buf);
+	size_t size = sngTermSearchSize(width, height);
+	void *mem = malloc(size);
+	SngTermSearch *search = sngTermSearchInit(mem, size, width, height, "words", 5);
+	SngTermMatch match;
+	int reps = 5000;
+	double start = nowNs();
+	for (int i = 0; i < reps; i++) {
+		sngTermSearch(search, t, 0, &match, 1);
+	}
+	double elapsed = nowNs() - start;
+	int changedReps = 100000;
+	double changedStart = nowNs();
+	for (int i = 0; i < changedReps; i++) {
+		sngTermWrite(t, "\033[30Hx", 6);
+		sngTermSearch(search, t, SNG_TERM_SEARCH_CHANGED, &match, 1);
+	}
+	double changedElapsed = nowNs() - changedStart;
+	printf(
+		"%-28s %8.1f us/screen %8.1f ns/changed row\n",
+		"search 200x60",
+		elapsed / reps / 1e3,
+		changedElapsed / changedReps
+	);
+	free(mem);
+	free(t);
+}
+
+// benchPublish measures publishing snapshots for another thread to
+// render, after one row is written and after the screen scrolls.
+static void benchPublish() {
+	int width = 200;
+	int height = 60;
+	SngTerm *t = newTerm(width, height);
+	Stream s = {};
+	colorStream(&s, COLOR_256);
+	sngTermWrite(t, s.buf, s.len);
+	free(s.buf);
+	size_t size = sngTermSnapshotsSize(width, height);
+	SngTermSnapshots *snaps = sngTermSnapshotsInit(malloc(size), size, width, height);
+	int reps = 100000;
+	double start = nowNs();
+	for (int i = 0; i < reps; i++) {
+		sngTermWrite(t, "\033[30Hx", 6);
+		sngTermPublish(snaps, t);
+	}
+	double rowElapsed = nowNs() - start;
+	int scrollReps = 5000;
+	start = nowNs();
+	for (int i = 0; i < scrollReps; i++) {
+		sngTermWrite(t, "\033[60H\n", 6);
+		sngTermPublish(snaps, t);
+	}
+	double scrollElapsed = nowNs() - start;
+	printf(
+		"%-28s %8.1f ns/row    %8.1f us/scroll\n",
+		"publish 200x60",
+		rowElapsed / reps,
+		scrollElapsed / scrollReps / 1e3
+	);
+	free(snaps);
+	free(t);
+}
+
+int main(int argc, char **argv) {
+	// suppress -Wunused-parameter
+	(void)argc;
+	(void)argv;
+	benchColors();
+	benchRedraw();
+	benchEdit();
+	benchWide();
+	benchReflow();
+	benchRuns();
+	benchResolve();
+	benchCopyText();
+	benchSearch();
+	benchPublish();
+	return 0;
+}
@@ -1,26 +1,35 @@
+#define SNG_TERM_DIAGNOSTICS
+#define SNG_TERM_STATS
+#define SNG_TERM_STATS_CYCLES
 #define SNG_TERMINAL_IMPLEMENTATION
 #include "sng_terminal.h"
 
+#include <pthread.h>
+#include <stddef.h> // offsetof
+
+// csiPut feeds str into c, and returns non-zero if the last character
+// completed the sequence.
+b32 csiPut(_SngTermCSI *c, const char *str) {
+	b32 done = 0;
+	_sngTermCSIReset(c);
+	for (const char *s = str; *s != 0; s++) {
+		done = _sngTermCSIPut(c, (u32)*s);
+	}
+	return done;
+}
+
 void testCSIParse() {
 	_SngTermCSI c;
-	_sngTermCSIReset(&c);
-	c.bufLen = snprintf(c.buf, sizeof(c.buf), "s");
-	_sngTermCSIParse(&c);
-	if (c.mode != 's' || _sngTermCSIArg(&c, 0, 17) != 17 || c.argsLen != 0) {
+	if (!csiPut(&c, "s") || c.mode != 's' || _sngTermCSIArg(&c, 0, 17) != 17 || c.argsLen != 0) {
 		fprintf(stderr, "%s:%d: CSI parse mismatch\n", __FILE__, __LINE__);
 	}
 
-	_sngTermCSIReset(&c);
-	c.bufLen = snprintf(c.buf, sizeof(c.buf), "31T");
-	_sngTermCSIParse(&c);
-	if (c.mode != 'T' || _sngTermCSIArg(&c, 0, 0) != 31 || c.argsLen != 1) {
+	if (!csiPut(&c, "31T") || c.mode != 'T' || _sngTermCSIArg(&c, 0, 0) != 31 || c.argsLen != 1) {
 		fprintf(stderr, "%s:%d: CSI parse mismatch\n", __FILE__, __LINE__);
 	}
 
-	_sngTermCSIReset(&c);
-	c.bufLen = snprintf(c.buf, sizeof(c.buf), "48;2f");
-	_sngTermCSIParse(&c);
 	if (
+		!csiPut(&c, "48;2f") ||
 		c.mode != 'f' ||
 		_sngTermCSIArg(&c, 0, 0) != 48 ||
 		_sngTermCSIArg(&c, 1, 0) != 2 ||
@@ -29,10 +38,38 @@ void testCSIParse() {
 		fprintf(stderr, "%s:%d: CSI parse mismatch\n", __FILE__, __LINE__);
 	}
 
-	_sngTermCSIReset(&c);
-	c.bufLen = snprintf(c.buf, sizeof(c.buf), "?25l");
-	_sngTermCSIParse(&c);
-	if (c.mode != 'l' || _sngTermCSIArg(&c, 0, 0) != 25 || c.priv == 0 || c.argsLen != 1) {
+	if (!csiPut(&c, "?25l") || c.mode != 'l' || _sngTermCSIArg(&c, 0, 0) != 25 || c.priv != '?' || c.argsLen != 1) {
+		fprintf(stderr, "%s:%d: CSI parse mismatch\n", __FILE__, __LINE__);
+	}
+
+	if (
+		!csiPut(&c, ";5H") ||
+		c.argsLen != 2 ||
+		_sngTermCSIArg(&c, 0, 1) != 0 ||
+		_sngTermCSIArg(&c, 1, 1) != 5
+	) {
+		fprintf(stderr, "%s:%d: CSI parse mismatch\n", __FILE__, __LINE__);
+	}
+
+	if (
+		!csiPut(&c, "38:2::1:2:3m") ||
+		c.argsLen != 6 ||
+		c.sub != 0x3e ||
+		_sngTermCSIArg(&c, 5, 0) != 3
+	) {
+		fprintf(stderr, "%s:%d: CSI parse mismatch argsLen=%d sub=%x\n", __FILE__, __LINE__, c.argsLen, c.sub);
+	}
+
+	// parameters past the end of args are dropped, not overflowed
+	if (
+		!csiPut(&c, "1;2;3;4;5;6;7;8;9;10;11;12;13;14;15;16;17;99999999999m") ||
+		c.argsLen != 16 ||
+		_sngTermCSIArg(&c, 15, 0) != 16
+	) {
+		fprintf(stderr, "%s:%d: CSI parse mismatch argsLen=%d\n", __FILE__, __LINE__, c.argsLen);
+	}
+
+	if (csiPut(&c, "12") || !csiPut(&c, "1?2m") || c.bad != '?') {
 		fprintf(stderr, "%s:%d: CSI parse mismatch\n", __FILE__, __LINE__);
 	}
 }
@@ -85,7 +122,7 @@ void extractString(SngTerm *t, char *dest, size_t destSize, int x0, int x1, int
 			dest[destSize-1] = 0;
 			return;
 		}
-		dest[i++] = (char)t->lines[y][x].codepoint;
+		dest[i++] = (char)sngTermCell(t, x, y).codepoint;
 	}
 	dest[i] = 0;
 }
@@ -159,7 +196,7 @@ void testNewline() {
 	for (const char *c = output; *c != 0; c++) {
 		sngTermUpdate(t, (u32)*c);
 	}
-	SngTermCell c = t->lines[t->cur.y][t->cur.x];
+	SngTermCell c = sngTermCell(t, t->cur.x, t->cur.y);
 	if (c.fg != SNG_TERM_COLOR_DEFAULT_FG) {
 		fprintf(
 			stderr,
@@ -170,6 +207,1311 @@ void testNewline() {
 	}
 }
 
+void testTrueColor() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	const char *output = "\033[38;2;1;2;3;48;5;17mX\033[41;30mY\033[4:3;38:2::1:2:3mZ";
+	for (const char *c = output; *c != 0; c++) {
+		sngTermUpdate(t, (u32)*c);
+	}
+	SngTermCell x = sngTermCell(t, 0, 0);
+	SngTermCell y = sngTermCell(t, 1, 0);
+	SngTermCell z = sngTermCell(t, 2, 0);
+	u32 rgb = 0;
+	if (
+		(x.fg & SNG_TERM_COLOR_RGB_FLAG) == 0 ||
+		!sngTermColorRGB(t, x.fg, &rgb) ||
+		rgb != 0x010203 ||
+		x.bg != 17
+	) {
+		fprintf(stderr, "%s:%d: testTrueColor fg=%x bg=%x rgb=%x\n", __FILE__, __LINE__, x.fg, x.bg, rgb);
+	}
+	if (y.fg != SNG_TERM_COLOR_BLACK || y.bg != SNG_TERM_COLOR_RED) {
+		fprintf(stderr, "%s:%d: testTrueColor fg=%x bg=%x\n", __FILE__, __LINE__, y.fg, y.bg);
+	}
+	if (z.fg != x.fg || t->rgbLen != 1 || (z.attr & SNG_TERM_ATTR_UNDERLINE) == 0) {
+		fprintf(stderr, "%s:%d: testTrueColor fg=%x rgbLen=%d\n", __FILE__, __LINE__, z.fg, t->rgbLen);
+	}
+
+	// Once the table fills up with colors still on screen, colors fall back
+	// to the 256 color cube.
+	sngTermWrite(t, "\033[?7h", 5);
+	for (int i = 0; i < SNG_TERM_RGB_TABLE_SIZE; i++) {
+		char seq[64];
+		snprintf(seq, sizeof(seq), "\033[38;2;%d;%d;0m.", i & 0xff, i >> 8);
+		sngTermWrite(t, seq, strlen(seq));
+	}
+	if (t->rgbLen >= SNG_TERM_RGB_TABLE_SIZE || (t->cur.attr.fg & SNG_TERM_COLOR_RGB_FLAG) != 0) {
+		fprintf(stderr, "%s:%d: testTrueColor rgbLen=%d fg=%x\n", __FILE__, __LINE__, t->rgbLen, t->cur.attr.fg);
+	}
+
+	// Colors cleared from the screen are reclaimed.
+	const char *clear = "\033[2J\033[38;2;9;9;9mA";
+	sngTermWrite(t, clear, strlen(clear));
+	if (t->rgbLen != 1 || !sngTermColorRGB(t, t->cur.attr.fg, &rgb) || rgb != 0x090909) {
+		fprintf(stderr, "%s:%d: testTrueColor rgbLen=%d fg=%x\n", __FILE__, __LINE__, t->rgbLen, t->cur.attr.fg);
+	}
+
+	// Colors scrolled off are reclaimed once the table fills.
+	sngTermWrite(t, "\033[m\033[H", 6);
+	for (int i = 0; i < 4*SNG_TERM_RGB_TABLE_SIZE; i++) {
+		char seq[64];
+		snprintf(seq, sizeof(seq), "\033[38;2;%d;%d;1m.\r\n", i & 0xff, i >> 8);
+		sngTermWrite(t, seq, strlen(seq));
+	}
+	if (!sngTermColorRGB(t, t->cur.attr.fg, &rgb) || rgb != 0xff0701) {
+		fprintf(stderr, "%s:%d: testTrueColor rgbLen=%d fg=%x\n", __FILE__, __LINE__, t->rgbLen, t->cur.attr.fg);
+	}
+
+	// RIS empties the table.
+	sngTermWrite(t, "\033c", 2);
+	if (t->rgbLen != 0) {
+		fprintf(stderr, "%s:%d: testTrueColor rgbLen=%d\n", __FILE__, __LINE__, t->rgbLen);
+	}
+	free(t);
+}
+
+struct TestClipboard {
+	SngTermBase64 b64;
+	u8 data[4096];
+	size_t dataLen;
+	int calls;
+	int flags;
+	u32 type;
+	b8 sawPrefix;
+	u8 _pad[3];
+};
+
+void testStrFunc(void *user, SngTerm *t, u32 type, const char *data, size_t len, int flags) {
+	(void)t;
+	TestClipboard *clip = (TestClipboard *)user;
+	clip->calls++;
+	clip->flags |= flags;
+	clip->type = type;
+	// skip the "52;c;" prefix, which arrives with the first chunk here
+	if (flags & SNG_TERM_STR_BEGIN) {
+		if (len < 5 || memcmp(data, "52;c;", 5) != 0) {
+			return;
+		}
+		clip->sawPrefix = 1;
+		data += 5;
+		len -= 5;
+	}
+	if (clip->sawPrefix) {
+		clip->dataLen += sngTermBase64Decode(&clip->b64, data, len, &clip->data[clip->dataLen]);
+	}
+}
+
+void testWrite() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	// UTF-8 split across writes
+	const char *text = "h\xc3\xa9\xe2\x94\x80!";
+	for (size_t i = 0; i < strlen(text); i++) {
+		sngTermWrite(t, &text[i], 1);
+	}
+	if (
+		sngTermCell(t, 0, 0).codepoint != 'h' ||
+		sngTermCell(t, 1, 0).codepoint != 0xe9 ||
+		sngTermCell(t, 2, 0).codepoint != 0x2500 ||
+		sngTermCell(t, 3, 0).codepoint != '!'
+	) {
+		fprintf(stderr, "%s:%d: testWrite bad UTF-8 decode\n", __FILE__, __LINE__);
+	}
+
+	// A large OSC 52 payload, well over the 256 byte buffer, in pieces.
+	TestClipboard clip = {};
+	sngTermSetStrFunc(t, testStrFunc, &clip);
+	char payload[3000];
+	u8 expected[2048];
+	const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	for (size_t i = 0; i < sizeof(expected); i++) {
+		expected[i] = (u8)(i * 7);
+	}
+	size_t payloadLen = 0;
+	for (size_t i = 0; i < sizeof(expected); i += 3) {
+		u32 v = (u32)expected[i] << 16;
+		if (i+1 < sizeof(expected)) v |= (u32)expected[i+1] << 8;
+		if (i+2 < sizeof(expected)) v |= expected[i+2];
+		payload[payloadLen++] = alphabet[(v >> 18) & 63];
+		payload[payloadLen++] = alphabet[(v >> 12) & 63];
+		payload[payloadLen++] = (i+1 < sizeof(expected)) ? alphabet[(v >> 6) & 63] : '=';
+		payload[payloadLen++] = (i+2 < sizeof(expected)) ? alphabet[v & 63] : '=';
+	}
+	sngTermWrite(t, "\033]52;c;", strlen("\033]52;c;"));
+	for (size_t i = 0; i < payloadLen; i += 1000) {
+		size_t n = (payloadLen - i < 1000) ? payloadLen - i : 1000;
+		sngTermWrite(t, &payload[i], n);
+	}
+	sngTermWrite(t, "\033\\\033]0;title\a", strlen("\033\\\033]0;title\a"));
+	if (
+		clip.type != ']' ||
+		clip.dataLen != sizeof(expected) ||
+		memcmp(clip.data, expected, sizeof(expected)) != 0 ||
+		(clip.flags & SNG_TERM_STR_END) == 0 ||
+		(clip.flags & SNG_TERM_STR_ABORT) != 0
+	) {
+		fprintf(stderr, "%s:%d: testWrite clipboard len=%zu flags=%x\n", __FILE__, __LINE__, clip.dataLen, clip.flags);
+	}
+	if (strcmp(t->title, "title") != 0) {
+		fprintf(stderr, "%s:%d: testWrite title='%s'\n", __FILE__, __LINE__, t->title);
+	}
+
+	// An STR cut off by another escape is reported as aborted.
+	clip.flags = 0;
+	sngTermWrite(t, "\033]2;abc\033[m", strlen("\033]2;abc\033[m"));
+	if ((clip.flags & SNG_TERM_STR_ABORT) == 0 || t->state != _sngTermStateParse) {
+		fprintf(stderr, "%s:%d: testWrite abort flags=%x\n", __FILE__, __LINE__, clip.flags);
+	}
+}
+
+struct TestEvents {
+	int count;
+	int lastEvent;
+	int lastArg;
+};
+
+void testEventFunc(void *user, SngTerm *t, int event, int arg) {
+	(void)t;
+	TestEvents *events = (TestEvents *)user;
+	events->count++;
+	events->lastEvent = event;
+	events->lastArg = arg;
+}
+
+void testDiagnostics() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+	TestEvents events = {};
+	sngTermSetEventFunc(t, testEventFunc, &events);
+
+	const char *output = "\033[1;31mok\033[0m\033[?9999h\033[9999h\033[38mhi\033[y\033[y";
+	for (const char *c = output; *c != 0; c++) {
+		sngTermUpdate(t, (u32)*c);
+	}
+	if (
+		events.count != 5 ||
+		sngTermEventCount(t, SNG_TERM_EVENT_UNKNOWN_PRIVATE_MODE) != 1 ||
+		sngTermEventCount(t, SNG_TERM_EVENT_UNKNOWN_MODE) != 1 ||
+		sngTermEventCount(t, SNG_TERM_EVENT_BAD_SGR_COLOR) != 1 ||
+		sngTermEventCount(t, SNG_TERM_EVENT_UNKNOWN_CSI) != 2 ||
+		events.lastEvent != SNG_TERM_EVENT_UNKNOWN_CSI ||
+		events.lastArg != 'y'
+	) {
+		fprintf(
+			stderr,
+			"%s:%d: testDiagnostics count=%d last=%s arg=%d\n",
+			__FILE__, __LINE__,
+			events.count, sngTermEventName(events.lastEvent), events.lastArg
+		);
+	}
+
+	// Insert mode is supported, so switching it raises nothing.
+	const char *insert = "\033[4h\033[4l";
+	sngTermWrite(t, insert, strlen(insert));
+	if (events.count != 5 || sngTermEventCount(t, SNG_TERM_EVENT_UNSUPPORTED_MODE) != 0) {
+		fprintf(stderr, "%s:%d: testDiagnostics count=%d\n", __FILE__, __LINE__, events.count);
+	}
+}
+
+void testStats() {
+	int maxWidth = 10;
+	int maxHeight = 4;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+	sngTermResetStats(t);
+
+	const char *output = "ab\xc3\xa9\033[31mc\033[m\r\n\033]2;x\a\033[2J\033[H\033M\033[1;2r\n\n";
+	sngTermWrite(t, output, strlen(output));
+	SngTermStats stats;
+	sngTermGetStats(t, &stats);
+	if (
+		stats.bytes != strlen(output) || stats.chars != 4 ||
+		stats.csi['m' - 0x40] != 2 || stats.csi['J' - 0x40] != 1 ||
+		stats.esc['[' - 0x20] != 5 || stats.esc['M' - 0x20] != 1 ||
+		stats.strs != 1 || stats.osc != 1 ||
+		stats.scrolls != 2 || stats.linesScrolled != 2 ||
+		stats.cellsCleared != 60 ||
+		stats.calls[SNG_TERM_TIMER_CSI] != 5 ||
+		stats.calls[SNG_TERM_TIMER_SCROLL] != 2 ||
+		stats.calls[SNG_TERM_TIMER_STR] != 1
+	) {
+		fprintf(
+			stderr, "%s:%d: testStats chars=%d scrolls=%d cleared=%d\n",
+			__FILE__, __LINE__, (int)stats.chars, (int)stats.scrolls, (int)stats.cellsCleared
+		);
+	}
+
+	// Frames count the rows dirty when each is ready.
+	memset(t->dirtyLines, 0, (size_t)maxHeight);
+	t->changed = 0;
+	sngTermWrite(t, "\033[3Hx", 5);
+	sngTermFrameReady(t, 0);
+	sngTermGetStats(t, &stats);
+	if (stats.frames != 1 || stats.frameRows != 1 || stats.frameRowsMax != 1) {
+		fprintf(stderr, "%s:%d: testStats frames=%d rows=%d\n", __FILE__, __LINE__, (int)stats.frames, (int)stats.frameRows);
+	}
+	sngTermResetStats(t);
+	sngTermGetStats(t, &stats);
+	if (stats.bytes != 0 || stats.frames != 0 || stats.cycles[SNG_TERM_TIMER_CHARS] != 0) {
+		fprintf(stderr, "%s:%d: testStats not reset\n", __FILE__, __LINE__);
+	}
+	free(t);
+}
+
+void testResolveColors() {
+	int maxWidth = 10;
+	int maxHeight = 4;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	// Cells keep the colors as set; bold and reverse apply when resolved.
+	const char *output = "\033[1;31;42ma\033[7mb\033[22mc\033[K";
+	sngTermWrite(t, output, strlen(output));
+	SngTermCell cells[4];
+	for (int x = 0; x < 4; x++) {
+		cells[x] = sngTermCell(t, x, 0);
+	}
+	u16 fg[4], bg[4];
+	sngTermResolveColors(cells, 4, t->mode, fg, bg);
+	if (
+		cells[1].fg != SNG_TERM_COLOR_RED || cells[1].bg != SNG_TERM_COLOR_GREEN ||
+		fg[0] != SNG_TERM_COLOR_LIGHT_RED || bg[0] != SNG_TERM_COLOR_GREEN ||
+		fg[1] != SNG_TERM_COLOR_GREEN || bg[1] != SNG_TERM_COLOR_LIGHT_RED ||
+		fg[2] != SNG_TERM_COLOR_GREEN || bg[2] != SNG_TERM_COLOR_RED ||
+		fg[3] != SNG_TERM_COLOR_RED || bg[3] != SNG_TERM_COLOR_GREEN
+	) {
+		fprintf(stderr, "%s:%d: testResolveColors fg=%d,%d,%d,%d\n", __FILE__, __LINE__, fg[0], fg[1], fg[2], fg[3]);
+	}
+
+	// Reverse video swaps every cell back, and redraws the screen.
+	memset(t->dirtyLines, 0, (size_t)maxHeight);
+	t->changed = 0;
+	sngTermWrite(t, "\033[?5h", 5);
+	sngTermResolveColors(cells, 4, t->mode, fg, bg);
+	if (
+		fg[1] != SNG_TERM_COLOR_LIGHT_RED || bg[1] != SNG_TERM_COLOR_GREEN ||
+		fg[3] != SNG_TERM_COLOR_GREEN || bg[3] != SNG_TERM_COLOR_RED ||
+		!t->dirtyLines[maxHeight-1] || !(t->changed & SNG_TERM_CHANGED_SCREEN)
+	) {
+		fprintf(stderr, "%s:%d: testResolveColors fg=%d,%d\n", __FILE__, __LINE__, fg[1], fg[3]);
+	}
+	SngTermRun run;
+	sngTermLineRun(t, 0, 1, &run, NULL, 0);
+	if (run.fg != SNG_TERM_COLOR_LIGHT_RED || run.bg != SNG_TERM_COLOR_GREEN) {
+		fprintf(stderr, "%s:%d: testResolveColors run fg=%d bg=%d\n", __FILE__, __LINE__, run.fg, run.bg);
+	}
+	free(t);
+}
+
+void testLazyClear() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, 10, 4);
+
+	// Lines cleared with one color, then partly written and cleared again
+	// with another, must read back the same as if cleared eagerly.
+	const char *output =
+		"abcdefghij\033[H\033[41m\033[2J\033[HXY\033[44m\033[K"
+		"\033[2;1Habcdef\033[2;3H\033[42m\033[2X\033[2;2H\033[K"
+		"\033[3;1Habcdef\033[3;2H\033[2P\033[3;1H\033[@";
+	for (const char *c = output; *c != 0; c++) {
+		sngTermUpdate(t, (u32)*c);
+	}
+	char line[16];
+	extractString(t, line, sizeof(line), 0, 9, 0);
+	SngTermCell blank;
+	int blankX = sngTermLineBlank(t, 0, &blank);
+	if (
+		strcmp(line, "XY        ") != 0 ||
+		sngTermCell(t, 0, 0).bg != SNG_TERM_COLOR_RED ||
+		sngTermCell(t, 2, 0).bg != SNG_TERM_COLOR_BLUE ||
+		blankX != 2 ||
+		blank.bg != SNG_TERM_COLOR_BLUE
+	) {
+		fprintf(stderr, "%s:%d: testLazyClear line 0 %s blankX=%d\n", __FILE__, __LINE__, line, blankX);
+	}
+	extractString(t, line, sizeof(line), 0, 9, 1);
+	if (
+		strcmp(line, "a         ") != 0 ||
+		sngTermCell(t, 1, 1).bg != SNG_TERM_COLOR_GREEN ||
+		sngTermCell(t, 9, 1).bg != SNG_TERM_COLOR_GREEN ||
+		sngTermLine(t, 1)[9].bg != SNG_TERM_COLOR_GREEN ||
+		sngTermLineBlank(t, 1, &blank) != 10
+	) {
+		fprintf(stderr, "%s:%d: testLazyClear line 1 %s\n", __FILE__, __LINE__, line);
+	}
+	extractString(t, line, sizeof(line), 0, 9, 2);
+	if (
+		strcmp(line, " adef     ") != 0 ||
+		sngTermCell(t, 5, 2).bg != SNG_TERM_COLOR_RED ||
+		sngTermCell(t, 9, 2).bg != SNG_TERM_COLOR_GREEN
+	) {
+		fprintf(stderr, "%s:%d: testLazyClear line 2 %s\n", __FILE__, __LINE__, line);
+	}
+}
+
+void testLazyAlt() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSizeMin(maxWidth, maxHeight);
+	if (memSize + sngTermAltAllocSize(maxWidth, maxHeight) != sngTermAllocSizeMax(maxWidth, maxHeight)) {
+		fprintf(stderr, "%s:%d: testLazyAlt sizes do not add up\n", __FILE__, __LINE__);
+	}
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	// Without an allocator, the alternate screen is ignored.
+	const char *enter = "\033[?1049hvim";
+	sngTermWrite(t, enter, strlen(enter));
+	if ((t->mode & SNG_TERM_MODE_ALT_SCREEN) || sngTermEventCount(t, SNG_TERM_EVENT_NO_ALT_SCREEN) != 1) {
+		fprintf(stderr, "%s:%d: testLazyAlt entered without an allocator\n", __FILE__, __LINE__);
+	}
+
+	size_t poolSize = sngTermAltAllocSize(maxWidth, maxHeight) * 2;
+	void *poolMem = malloc(poolSize);
+	SngTermAltPool pool;
+	sngTermAltPoolInit(&pool, poolMem, poolSize, maxWidth, maxHeight);
+	sngTermSetAltAlloc(t, sngTermAltPoolAlloc, &pool, 1000);
+	const char *output = "\033[H$ \033[?1049h\033[Hvim";
+	sngTermWrite(t, output, strlen(output));
+	char line[8];
+	extractString(t, line, sizeof(line), 0, 4, 0);
+	if (!(t->mode & SNG_TERM_MODE_ALT_SCREEN) || pool.blocksFree != 1 || strcmp(line, "vim  ") != 0) {
+		fprintf(stderr, "%s:%d: testLazyAlt alt screen %s free=%d\n", __FILE__, __LINE__, line, pool.blocksFree);
+	}
+	if (sngTermReleaseIdle(t, 0)) {
+		fprintf(stderr, "%s:%d: testLazyAlt released while in use\n", __FILE__, __LINE__);
+	}
+
+	const char *leave = "\033[?1049l";
+	sngTermWrite(t, leave, strlen(leave));
+	extractString(t, line, sizeof(line), 0, 1, 0);
+	if ((t->mode & SNG_TERM_MODE_ALT_SCREEN) || strcmp(line, "$ ") != 0) {
+		fprintf(stderr, "%s:%d: testLazyAlt main screen %s\n", __FILE__, __LINE__, line);
+	}
+	if (sngTermReleaseIdle(t, 5000) || sngTermReleaseIdle(t, 5999)) {
+		fprintf(stderr, "%s:%d: testLazyAlt released too early\n", __FILE__, __LINE__);
+	}
+	if (!sngTermReleaseIdle(t, 6000) || pool.blocksFree != 2) {
+		fprintf(stderr, "%s:%d: testLazyAlt not released free=%d\n", __FILE__, __LINE__, pool.blocksFree);
+	}
+
+	// Resizing and switching again still works after the release.
+	sngTermSetSize(t, 20, 10);
+	sngTermWrite(t, output, strlen(output));
+	if (!(t->mode & SNG_TERM_MODE_ALT_SCREEN) || pool.blocksFree != 1) {
+		fprintf(stderr, "%s:%d: testLazyAlt not reacquired\n", __FILE__, __LINE__);
+	}
+	sngTermReleaseAlt(t);
+	if ((t->mode & SNG_TERM_MODE_ALT_SCREEN) || pool.blocksFree != 2) {
+		fprintf(stderr, "%s:%d: testLazyAlt not released on teardown\n", __FILE__, __LINE__);
+	}
+	free(t);
+	free(poolMem);
+}
+
+void testPooledRows() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	int poolRows = 30;
+	size_t poolSize = sngTermRowPoolSize(maxWidth, poolRows);
+	void *poolMem = malloc(poolSize);
+	SngTermRowPool pool;
+	// The blank line alone is not a pool.
+	if (
+		sngTermRowPoolInit(&pool, poolMem, sngTermRowPoolSize(maxWidth, 0), maxWidth) ||
+		sngTermRowPoolInit(&pool, poolMem, 8, maxWidth)
+	) {
+		fprintf(stderr, "%s:%d: testPooledRows took memory for no rows\n", __FILE__, __LINE__);
+	}
+	if (!sngTermRowPoolInit(&pool, poolMem, poolSize, maxWidth)) {
+		fprintf(stderr, "%s:%d: testPooledRows sngTermRowPoolInit failed\n", __FILE__, __LINE__);
+	}
+	size_t memSize = sngTermAllocSizePooled(maxWidth, maxHeight);
+	SngTerm *a = sngTermInitPooled(malloc(memSize), memSize, maxWidth, maxHeight, &pool, 25);
+	SngTerm *b = sngTermInitPooled(malloc(memSize), memSize, maxWidth, maxHeight, &pool, 4);
+	sngTermSetSize(a, maxWidth, maxHeight);
+	sngTermSetSize(b, maxWidth, maxHeight);
+	if (pool.rowsFree != poolRows || sngTermRowsHeld(a) != 0) {
+		fprintf(stderr, "%s:%d: testPooledRows blank terminals hold rows\n", __FILE__, __LINE__);
+	}
+
+	// Only written lines take rows, and clearing gives them back.
+	const char *output = "one\r\ntwo\r\n\033[41m\033[2K\033[mthree";
+	sngTermWrite(a, output, strlen(output));
+	char line[8];
+	extractString(a, line, sizeof(line), 0, 4, 2);
+	if (sngTermRowsHeld(a) != 3 || pool.rowsFree != poolRows-3 || strcmp(line, "three") != 0) {
+		fprintf(stderr, "%s:%d: testPooledRows held=%d %s\n", __FILE__, __LINE__, sngTermRowsHeld(a), line);
+	}
+	const char *clear = "\033[H\033[J";
+	sngTermWrite(a, clear, strlen(clear));
+	extractString(a, line, sizeof(line), 0, 4, 0);
+	if (sngTermRowsHeld(a) != 0 || pool.rowsFree != poolRows || strcmp(line, "     ") != 0) {
+		fprintf(stderr, "%s:%d: testPooledRows after clear held=%d %s\n", __FILE__, __LINE__, sngTermRowsHeld(a), line);
+	}
+
+	// Output past the quota is dropped rather than taking more rows.
+	for (int i = 0; i < 8; i++) {
+		sngTermWrite(b, "x\r\n", 3);
+	}
+	if (sngTermRowsHeld(b) != 4 || sngTermEventCount(b, SNG_TERM_EVENT_NO_ROW) != 4) {
+		fprintf(stderr, "%s:%d: testPooledRows quota held=%d\n", __FILE__, __LINE__, sngTermRowsHeld(b));
+	}
+
+	// Scrolling, the alternate screen, and shrinking keep rows accounted.
+	for (int i = 0; i < 50; i++) {
+		sngTermWrite(a, "line\r\n", 6);
+	}
+	const char *alt = "\033[?1049halt\033[?1049l";
+	sngTermWrite(a, alt, strlen(alt));
+	sngTermSetSize(a, 20, 5);
+	sngTermWrite(a, "end", 3);
+	if (sngTermRowsHeld(a) + sngTermRowsHeld(b) + pool.rowsFree != poolRows) {
+		fprintf(stderr, "%s:%d: testPooledRows rows leaked\n", __FILE__, __LINE__);
+	}
+	sngTermRelease(a);
+	sngTermRelease(b);
+	if (pool.rowsFree != poolRows) {
+		fprintf(stderr, "%s:%d: testPooledRows not released free=%d\n", __FILE__, __LINE__, pool.rowsFree);
+	}
+	free(a);
+	free(b);
+	free(poolMem);
+}
+
+void testInsertMode() {
+	int maxWidth = 12;
+	int maxHeight = 4;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *a = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	SngTerm *b = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(a, 10, 4);
+	sngTermSetSize(b, 10, 4);
+
+	// sngTermWrite puts runs of characters at once, and must end up the
+	// same as sngTermUpdate one character at a time.
+	const char *output =
+		"abcdef\033[1;3H\033[4hXY\033[4l"
+		"\033[2;1H0123456789wrapped\033[1mbold\033[7mrev\033[m"
+		"\033[4;8H\033[4hlong insert\033(0qqx\033(B\033[?7l\033[1;9Hnowrap!";
+	sngTermWrite(a, output, strlen(output));
+	for (const char *c = output; *c != 0; c++) {
+		sngTermUpdate(b, (u32)*c);
+	}
+	char line[16];
+	extractString(a, line, sizeof(line), 0, 9, 0);
+	if (strcmp(line, "abXYcdefn!") != 0) {
+		fprintf(stderr, "%s:%d: testInsertMode %s\n", __FILE__, __LINE__, line);
+	}
+	for (int y = 0; y < 4; y++) {
+		for (int x = 0; x < 10; x++) {
+			SngTermCell ca = sngTermCell(a, x, y);
+			SngTermCell cb = sngTermCell(b, x, y);
+			if (!_sngTermCellEqual(&ca, &cb)) {
+				fprintf(
+					stderr, "%s:%d: testInsertMode %d,%d %x/%x %x/%x\n",
+					__FILE__, __LINE__, x, y, ca.codepoint, cb.codepoint, ca.attr, cb.attr
+				);
+			}
+		}
+	}
+	if (a->cur.x != b->cur.x || a->cur.y != b->cur.y || a->cur.state != b->cur.state) {
+		fprintf(stderr, "%s:%d: testInsertMode cursor %d,%d %d,%d\n", __FILE__, __LINE__, a->cur.x, a->cur.y, b->cur.x, b->cur.y);
+	}
+	free(a);
+	free(b);
+}
+
+void testWideChars() {
+	u32 widths[][2] = {
+		{'a', 1}, {0xe9, 1}, {0x301, 0}, {0x200b, 0}, {0x1160, 0},
+		{0x4e2d, 2}, {0xac00, 2}, {0xff21, 2}, {0x1f600, 2}, {0x2500, 1},
+	};
+	for (size_t i = 0; i < sizeof(widths)/sizeof(widths[0]); i++) {
+		if (sngTermCharWidth(widths[i][0]) != (int)widths[i][1]) {
+			fprintf(stderr, "%s:%d: testWideChars width of %x\n", __FILE__, __LINE__, widths[i][0]);
+		}
+	}
+
+	int maxWidth = 10;
+	int maxHeight = 4;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	// U+4E2D takes two cells; U+0301 and U+0323 attach to the e.
+	const char *output = "\033[?7ha\xe4\xb8\xad" "be\xcc\x81\xcc\xa3\xcc\x88\033[1;10H\xe4\xb8\xad";
+	sngTermWrite(t, output, strlen(output));
+	SngTermCell wide = sngTermCell(t, 1, 0);
+	SngTermCell spacer = sngTermCell(t, 2, 0);
+	if (
+		wide.codepoint != 0x4e2d || (wide.attr & SNG_TERM_ATTR_WIDE) == 0 ||
+		spacer.codepoint != 0 || (spacer.attr & SNG_TERM_ATTR_WIDE_SPACER) == 0 ||
+		sngTermCell(t, 3, 0).codepoint != 'b'
+	) {
+		fprintf(stderr, "%s:%d: testWideChars wide %x %x\n", __FILE__, __LINE__, wide.codepoint, spacer.codepoint);
+	}
+	SngTermCell e = sngTermCell(t, 4, 0);
+	u32 marks[2] = {};
+	if (e.codepoint != 'e' || sngTermCellMarks(t, &e, marks) != 2 || marks[0] != 0x301 || marks[1] != 0x323) {
+		fprintf(stderr, "%s:%d: testWideChars marks %x %x\n", __FILE__, __LINE__, marks[0], marks[1]);
+	}
+	if (
+		(sngTermCell(t, 9, 0).attr & SNG_TERM_ATTR_WRAP) == 0 ||
+		sngTermCell(t, 0, 1).codepoint != 0x4e2d ||
+		t->cur.x != 2 || t->cur.y != 1
+	) {
+		fprintf(stderr, "%s:%d: testWideChars wrap %d,%d\n", __FILE__, __LINE__, t->cur.x, t->cur.y);
+	}
+
+	// Overwriting either half of a wide character blanks the other half.
+	const char *overwrite = "\033[1;3Hx\033[3;1H\xe4\xb8\xad\xe4\xb8\xad\033[3;2Hab";
+	sngTermWrite(t, overwrite, strlen(overwrite));
+	char line[16];
+	extractString(t, line, sizeof(line), 0, 3, 0);
+	if (strcmp(line, "a xb") != 0 || (sngTermCell(t, 1, 0).attr & SNG_TERM_ATTR_WIDE) != 0) {
+		fprintf(stderr, "%s:%d: testWideChars overwrite %s\n", __FILE__, __LINE__, line);
+	}
+	extractString(t, line, sizeof(line), 0, 3, 2);
+	if (strcmp(line, " ab ") != 0 || (sngTermCell(t, 3, 2).attr & SNG_TERM_ATTR_WIDE_SPACER) != 0) {
+		fprintf(stderr, "%s:%d: testWideChars overwrite %s\n", __FILE__, __LINE__, line);
+	}
+
+	// Marks scrolled off are reclaimed once the table fills, and RIS frees
+	// the rest.
+	for (u32 i = 0; i < 2*SNG_TERM_MARKS_TABLE_SIZE; i++) {
+		u32 m0 = 0x300 + i % 0x70;
+		u32 m1 = 0x300 + i / 0x70;
+		char seq[16];
+		snprintf(
+			seq, sizeof(seq), "\r\ne%c%c%c%c",
+			0xc0 | (m0 >> 6), 0x80 | (m0 & 0x3f), 0xc0 | (m1 >> 6), 0x80 | (m1 & 0x3f)
+		);
+		sngTermWrite(t, seq, strlen(seq));
+		e = sngTermCell(t, 0, t->cur.y);
+		if (sngTermCellMarks(t, &e, marks) != 2 || marks[0] != m0 || marks[1] != m1) {
+			fprintf(stderr, "%s:%d: testWideChars marks %u: %x %x\n", __FILE__, __LINE__, i, marks[0], marks[1]);
+			break;
+		}
+	}
+	sngTermWrite(t, "\033c", 2);
+	if (t->markTableLen != 0) {
+		fprintf(stderr, "%s:%d: testWideChars markTableLen=%d\n", __FILE__, __LINE__, t->markTableLen);
+	}
+	free(t);
+}
+
+void testReflow() {
+	int maxWidth = 20;
+	int maxHeight = 4;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, 10, 4);
+	size_t scratchSize = sngTermReflowScratchSize(maxWidth, maxHeight);
+	void *scratch = malloc(scratchSize);
+
+	const char *output = "\033[?7h0123456789abcdef";
+	sngTermWrite(t, output, strlen(output));
+	struct {
+		const char *lines[4];
+		int width;
+		int x, y;
+		u8 _pad[4];
+	} steps[] = {
+		{{"0123456789abcdef", "", "", ""}, 20, 16, 0, {}},
+		{{"01234", "56789", "abcde", "f"}, 5, 1, 3, {}},
+		{{"4567", "89ab", "cdef", ""}, 4, 0, 3, {}},
+		{{"456789abcd", "ef", "", ""}, 10, 2, 1, {}},
+	};
+	for (size_t i = 0; i < sizeof(steps)/sizeof(steps[0]); i++) {
+		if (!sngTermSetSizeReflow(t, steps[i].width, 4, scratch, scratchSize)) {
+			fprintf(stderr, "%s:%d: testReflow step %d failed\n", __FILE__, __LINE__, (int)i);
+		}
+		for (int y = 0; y < 4; y++) {
+			char line[32];
+			int len = (int)strlen(steps[i].lines[y]);
+			extractString(t, line, sizeof(line), 0, t->width-1, y);
+			if (strncmp(line, steps[i].lines[y], (size_t)len) != 0 || strspn(&line[len], " ") != strlen(&line[len])) {
+				fprintf(stderr, "%s:%d: testReflow step %d line %d %s\n", __FILE__, __LINE__, (int)i, y, line);
+			}
+		}
+		if (t->cur.x != steps[i].x || t->cur.y != steps[i].y) {
+			fprintf(stderr, "%s:%d: testReflow step %d cursor %d,%d\n", __FILE__, __LINE__, (int)i, t->cur.x, t->cur.y);
+		}
+	}
+
+	// Wide characters are never split, and a colored tail stays with its
+	// line.
+	const char *wide = "\033[2J\033[Habcdefghi\xe4\xb8\xad\033[41m\033[K\033[m\r\nx";
+	sngTermWrite(t, wide, strlen(wide));
+	sngTermSetSizeReflow(t, 20, 4, scratch, scratchSize);
+	SngTermCell c = sngTermCell(t, 9, 0);
+	if (c.codepoint != 0x4e2d || sngTermCell(t, 15, 0).bg != SNG_TERM_COLOR_RED || sngTermCell(t, 0, 1).codepoint != 'x') {
+		fprintf(stderr, "%s:%d: testReflow wide %x\n", __FILE__, __LINE__, c.codepoint);
+	}
+	sngTermSetSizeReflow(t, 4, 4, scratch, scratchSize);
+	char line[8];
+	extractString(t, line, sizeof(line), 0, 3, 1);
+	if (strcmp(line, "efgh") != 0 || sngTermCell(t, 0, 2).codepoint != 'i' || sngTermCell(t, 1, 2).codepoint != 0x4e2d) {
+		fprintf(stderr, "%s:%d: testReflow wide %s\n", __FILE__, __LINE__, line);
+	}
+	free(scratch);
+	free(t);
+}
+
+// drainOutput copies t's output into dest as a string, the way a host
+// would write it back to the application.
+static void drainOutput(SngTerm *t, char *dest, size_t destSize) {
+	size_t len = 0;
+	const char *data;
+	size_t n;
+	while ((n = sngTermOutputPeek(t, &data)) > 0) {
+		if (len + n >= destSize) {
+			n = destSize - 1 - len;
+		}
+		memcpy(&dest[len], data, n);
+		len += n;
+		sngTermOutputConsume(t, n);
+	}
+	dest[len] = 0;
+}
+
+void testOutput() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	const char *output = "\033[c\033[>c\033[5n\033[3;7H\033[6n\033Z";
+	sngTermWrite(t, output, strlen(output));
+	char reply[64];
+	drainOutput(t, reply, sizeof(reply));
+	const char *expected = "\033[?6c\033[>0;0;0c\033[0n\033[3;7R\033[?6c";
+	if (strcmp(reply, expected) != 0 || (t->changed & SNG_TERM_CHANGED_OUTPUT) == 0) {
+		fprintf(stderr, "%s:%d: testOutput %s\n", __FILE__, __LINE__, reply + 1);
+	}
+
+	// Replies wrap around the end of the buffer, and are dropped whole
+	// once it is full.
+	for (int i = 0; i < SNG_TERM_OUTPUT_SIZE; i++) {
+		sngTermWrite(t, "\033[6n", 4);
+	}
+	size_t pending = 0;
+	const char *data;
+	size_t n;
+	while ((n = sngTermOutputPeek(t, &data)) > 0) {
+		pending += n;
+		sngTermOutputConsume(t, n);
+	}
+	if (pending != SNG_TERM_OUTPUT_SIZE / 7 * 7 || sngTermEventCount(t, SNG_TERM_EVENT_OUTPUT_FULL) == 0) {
+		fprintf(stderr, "%s:%d: testOutput pending=%d\n", __FILE__, __LINE__, (int)pending);
+	}
+	free(t);
+}
+
+void testSync() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+	t->changed = 0;
+
+	// A frame split over several writes is held until it ends, while
+	// replies still go out.
+	const char *begin = "\033[?2026h\033[2Jhalf";
+	sngTermWrite(t, begin, strlen(begin));
+	sngTermWrite(t, "\033[?2026$p", 10);
+	if (sngTermFrameReady(t, 1000) || t->changed != SNG_TERM_CHANGED_OUTPUT) {
+		fprintf(stderr, "%s:%d: testSync changed=%d\n", __FILE__, __LINE__, t->changed);
+	}
+	char reply[32];
+	drainOutput(t, reply, sizeof(reply));
+	if (strcmp(reply, "\033[?2026;1$y") != 0) {
+		fprintf(stderr, "%s:%d: testSync %s\n", __FILE__, __LINE__, reply + 1);
+	}
+	t->changed = 0;
+	sngTermWrite(t, " done\033[?2026l", 13);
+	if (!sngTermFrameReady(t, 1010) || sngTermCell(t, 5, 0).codepoint != 'd') {
+		fprintf(stderr, "%s:%d: testSync frame not ready\n", __FILE__, __LINE__);
+	}
+
+	// An update left open is given up on after the timeout.
+	t->changed = 0;
+	sngTermWrite(t, "\033[?2026hx", 9);
+	if (sngTermFrameReady(t, 2000) || sngTermFrameReady(t, 2000 + SNG_TERM_SYNC_TIMEOUT - 1)) {
+		fprintf(stderr, "%s:%d: testSync released early\n", __FILE__, __LINE__);
+	}
+	if (
+		!sngTermFrameReady(t, 2000 + SNG_TERM_SYNC_TIMEOUT) ||
+		(t->mode & SNG_TERM_MODE_SYNC) ||
+		sngTermEventCount(t, SNG_TERM_EVENT_SYNC_TIMEOUT) != 1
+	) {
+		fprintf(stderr, "%s:%d: testSync timeout\n", __FILE__, __LINE__);
+	}
+	free(t);
+}
+
+static b32 sameStyle(const SngTermCell *a, const SngTermCell *b) {
+	u16 mask = (u16)~(SNG_TERM_ATTR_WRAP | SNG_TERM_ATTR_GFX | SNG_TERM_ATTR_WIDE | SNG_TERM_ATTR_WIDE_SPACER);
+	return a->fg == b->fg && a->bg == b->bg && (a->attr & mask) == (b->attr & mask);
+}
+
+// checkRuns compares the runs of every line against the cells, and
+// returns the number of runs found.
+static int checkRuns(SngTerm *t, int line) {
+	int runs = 0;
+	for (int y = 0; y < t->height; y++) {
+		SngTermRun run;
+		char text[SNG_TERM_RUN_TEXT_MIN];
+		int end = 0;
+		for (int x = 0; (x = sngTermLineRun(t, y, x, &run, text, sizeof(text))) != 0;) {
+			runs++;
+			SngTermCell first = sngTermCell(t, run.x, y);
+			u16 fg, bg;
+			sngTermResolveColors(&first, 1, t->mode, &fg, &bg);
+			if (run.x != end || run.width < 1 || run.fg != fg || run.bg != bg) {
+				fprintf(stderr, "%s:%d: checkRuns bad run at %d,%d\n", __FILE__, line, run.x, y);
+				return runs;
+			}
+			for (int i = 1; i < run.width; i++) {
+				SngTermCell cell = sngTermCell(t, run.x + i, y);
+				if (!sameStyle(&first, &cell)) {
+					fprintf(stderr, "%s:%d: checkRuns missed boundary at %d,%d\n", __FILE__, line, run.x + i, y);
+					return runs;
+				}
+			}
+			end = x;
+		}
+		if (end != t->width) {
+			fprintf(stderr, "%s:%d: checkRuns line %d ends at %d\n", __FILE__, line, y, end);
+		}
+	}
+	return runs;
+}
+
+void testStyleRuns() {
+	int maxWidth = 40;
+	int maxHeight = 20;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	const char *output = "ab\033[31mcd\033[42mef\033[m\xe6\xbc\xa2" "e\xcc\x81";
+	sngTermWrite(t, output, strlen(output));
+	struct {
+		const char *text;
+		int x, width;
+		u16 fg, bg;
+		u8 _pad[4];
+	} want[] = {
+		{"ab", 0, 2, SNG_TERM_COLOR_DEFAULT_FG, SNG_TERM_COLOR_DEFAULT_BG, {}},
+		{"cd", 2, 2, SNG_TERM_COLOR_RED, SNG_TERM_COLOR_DEFAULT_BG, {}},
+		{"ef", 4, 2, SNG_TERM_COLOR_RED, SNG_TERM_COLOR_GREEN, {}},
+		{"\xe6\xbc\xa2" "e\xcc\x81 ", 6, 34, SNG_TERM_COLOR_DEFAULT_FG, SNG_TERM_COLOR_DEFAULT_BG, {}},
+	};
+	SngTermRun run;
+	char text[64];
+	int i = 0;
+	for (int x = 0; (x = sngTermLineRun(t, 0, x, &run, text, sizeof(text))) != 0; i++) {
+		if (
+			i >= 4 ||
+			run.x != want[i].x || run.width != want[i].width ||
+			run.fg != want[i].fg || run.bg != want[i].bg ||
+			strncmp(text, want[i].text, strlen(want[i].text)) != 0 ||
+			run.textLen != strlen(want[i].text) + (i == 3 ? 30 : 0)
+		) {
+			fprintf(stderr, "%s:%d: testStyleRuns run %d at %d\n", __FILE__, __LINE__, i, run.x);
+			break;
+		}
+	}
+
+	// A small buffer cuts runs short, without splitting characters.
+	sngTermLineRun(t, 0, 6, &run, text, SNG_TERM_RUN_TEXT_MIN);
+	if (run.width != 9 || run.textLen != SNG_TERM_RUN_TEXT_MIN) {
+		fprintf(stderr, "%s:%d: testStyleRuns width=%d len=%d\n", __FILE__, __LINE__, run.width, (int)run.textLen);
+	}
+
+	// Boundaries follow insertions, deletions, clears and wrapping.
+	const char *edits =
+		"\033[?7h\033[1G\033[3@\033[1;33mxy\033[5G\033[2P\033[m\033[10X"
+		"\r\n\033[7mreverse\033[m plain \033[4munder\033[m\033[1K"
+		"\033[3;38H\033[44mwide \xe6\xbc\xa2\xe6\xbc\xa2 wrapped\033[m"
+		"\033[5;1H\033[42m\033[K\033[m\033[5;4Hmid\033[2;6H\033[2@\033[1;2H\033[3@";
+	sngTermWrite(t, edits, strlen(edits));
+	// a line with boundaries in every word, shifted both ways
+	for (int x = 0; x < maxWidth; x++) {
+		char seq[16];
+		snprintf(seq, sizeof(seq), "\033[6;%dH\033[3%dmx", x+1, x % 5 == 0);
+		sngTermWrite(t, seq, strlen(seq));
+	}
+	const char *shifts = "\033[m\033[6;2H\033[3@\033[6;5H\033[2P";
+	sngTermWrite(t, shifts, strlen(shifts));
+	if (checkRuns(t, __LINE__) < maxHeight + 8) {
+		fprintf(stderr, "%s:%d: testStyleRuns too few runs\n", __FILE__, __LINE__);
+	}
+	size_t scratchSize = sngTermReflowScratchSize(maxWidth, maxHeight);
+	void *scratch = malloc(scratchSize);
+	sngTermSetSizeReflow(t, 27, maxHeight, scratch, scratchSize);
+	checkRuns(t, __LINE__);
+	sngTermSetSizeReflow(t, maxWidth, maxHeight, scratch, scratchSize);
+	checkRuns(t, __LINE__);
+	free(scratch);
+	free(t);
+
+	// Pooled rows may be wider than the terminal.
+	SngTermRowPool pool;
+	size_t poolSize = sngTermRowPoolSize(maxWidth + 24, maxHeight);
+	void *poolMem = malloc(poolSize);
+	sngTermRowPoolInit(&pool, poolMem, poolSize, maxWidth + 24);
+	memSize = sngTermAllocSizePooled(maxWidth, maxHeight);
+	t = sngTermInitPooled(malloc(memSize), memSize, maxWidth, maxHeight, &pool, maxHeight);
+	sngTermSetSize(t, maxWidth, maxHeight);
+	sngTermWrite(t, output, strlen(output));
+	sngTermWrite(t, edits, strlen(edits));
+	checkRuns(t, __LINE__);
+	sngTermRelease(t);
+	free(t);
+	free(poolMem);
+}
+
+void testCopyText() {
+	int maxWidth = 20;
+	int maxHeight = 10;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+
+	const char *output =
+		"hello\r\n"
+		"\033[2Cworld  \033[41m \033[m\r\n"
+		"\xe6\xbc\xa2" "e\xcc\x81\r\n"
+		"\033[?7hwrapped text that goes\033[31m over the edge\r\n"
+		"\033[10Xtrailing";
+	sngTermWrite(t, output, strlen(output));
+	// Trailing blanks go whatever their colors, and wrapped rows are
+	// joined.
+	const char *expected =
+		"hello\n"
+		"  world\n"
+		"\xe6\xbc\xa2" "e\xcc\x81\n"
+		"wrapped text that goes over the edge\n"
+		"trailing";
+	char text[128];
+	size_t len = sngTermCopyText(t, 0, 0, maxWidth-1, 5, text, sizeof(text));
+	if (len != strlen(expected) || strcmp(text, expected) != 0) {
+		fprintf(stderr, "%s:%d: testCopyText '%s'\n", __FILE__, __LINE__, text);
+	}
+
+	// Partial lines, given in either order.
+	len = sngTermCopyText(t, 2, 1, 2, 0, text, sizeof(text));
+	if (len != 7 || strcmp(text, "llo\n  w") != 0) {
+		fprintf(stderr, "%s:%d: testCopyText '%s'\n", __FILE__, __LINE__, text);
+	}
+
+	// Text that does not fit is cut at a character boundary.
+	len = sngTermCopyText(t, 0, 2, maxWidth-1, 2, text, 3);
+	if (len != 6 || text[0] != 0) {
+		fprintf(stderr, "%s:%d: testCopyText len=%d\n", __FILE__, __LINE__, (int)len);
+	}
+	len = sngTermCopyText(t, 0, 3, maxWidth-1, 4, text, 13);
+	if (len != 36 || strcmp(text, "wrapped text") != 0) {
+		fprintf(stderr, "%s:%d: testCopyText '%s'\n", __FILE__, __LINE__, text);
+	}
+
+	// DECALN fills rows lazily, with a tail that is not blank.
+	const char *align = "\033#8\033[2;3Hab";
+	sngTermWrite(t, align, strlen(align));
+	len = sngTermCopyText(t, 0, 0, 4, 1, text, sizeof(text));
+	if (len != (size_t)maxWidth+6 || strcmp(&text[maxWidth], "\nEEabE") != 0) {
+		fprintf(stderr, "%s:%d: testCopyText '%s'\n", __FILE__, __LINE__, text);
+	}
+	free(t);
+}
+
+// search returns the matches of pattern on t, checking that none were
+// dropped.
+int search(SngTermSearch *s, const SngTerm *t, int flags, SngTermMatch *matches, int len) {
+	int n = sngTermSearch(s, t, flags, matches, len);
+	if (n > len) {
+		fprintf(stderr, "%s:%d: testSearch %d matches\n", __FILE__, __LINE__, n);
+		return len;
+	}
+	return n;
+}
+
+void testSearch() {
+	int maxWidth = 40;
+	int maxHeight = 6;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+	size_t searchSize = sngTermSearchSize(maxWidth, maxHeight);
+	void *searchMem = malloc(searchSize);
+	if (sngTermSearchInit(searchMem, searchSize, maxWidth, maxHeight, "", 0) != NULL) {
+		fprintf(stderr, "%s:%d: testSearch took an empty pattern\n", __FILE__, __LINE__);
+	}
+	SngTermSearch *s = sngTermSearchInit(searchMem, searchSize, maxWidth, maxHeight, "error", 5);
+
+	const char *output =
+		"error: one\r\n"
+		"  no errors here error\r\n"
+		"\xe6\xbc\xa2" "error\r\n"
+		"aaaaa\r\n"
+		"\033[36Gerror";
+	sngTermWrite(t, output, strlen(output));
+	SngTermMatch matches[8];
+	SngTermMatch expected[] = {{0, 0}, {5, 1}, {17, 1}, {2, 2}, {35, 4}};
+	int n = search(s, t, SNG_TERM_SEARCH_CHANGED, matches, 8);
+	if (n != 5 || memcmp(matches, expected, sizeof(expected)) != 0) {
+		fprintf(stderr, "%s:%d: testSearch n=%d\n", __FILE__, __LINE__, n);
+	}
+	if (sngTermSearch(s, t, 0, matches, 2) != 5 || matches[1].x != 5) {
+		fprintf(stderr, "%s:%d: testSearch stored too many\n", __FILE__, __LINE__);
+	}
+
+	// Wide characters are one character of the pattern, and matches do
+	// not overlap.
+	s = sngTermSearchInit(searchMem, searchSize, maxWidth, maxHeight, "\xe6\xbc\xa2" "e", 4);
+	n = search(s, t, 0, matches, 8);
+	if (n != 1 || matches[0].x != 0 || matches[0].y != 2) {
+		fprintf(stderr, "%s:%d: testSearch n=%d\n", __FILE__, __LINE__, n);
+	}
+	s = sngTermSearchInit(searchMem, searchSize, maxWidth, maxHeight, "aa", 2);
+	n = search(s, t, 0, matches, 8);
+	if (n != 2 || matches[1].x != 2 || matches[1].y != 3) {
+		fprintf(stderr, "%s:%d: testSearch n=%d\n", __FILE__, __LINE__, n);
+	}
+
+	// Only rows written since are searched, and not those scrolled.
+	s = sngTermSearchInit(searchMem, searchSize, maxWidth, maxHeight, "error", 5);
+	search(s, t, 0, matches, 8);
+	if ((n = search(s, t, SNG_TERM_SEARCH_CHANGED, matches, 8)) != 0) {
+		fprintf(stderr, "%s:%d: testSearch n=%d\n", __FILE__, __LINE__, n);
+	}
+	sngTermWrite(t, "\033[6Herror", 9);
+	n = search(s, t, SNG_TERM_SEARCH_CHANGED, matches, 8);
+	if (n != 1 || matches[0].x != 0 || matches[0].y != 5) {
+		fprintf(stderr, "%s:%d: testSearch n=%d\n", __FILE__, __LINE__, n);
+	}
+	sngTermWrite(t, "\n\n", 2);
+	if ((n = search(s, t, SNG_TERM_SEARCH_CHANGED, matches, 8)) != 0) {
+		fprintf(stderr, "%s:%d: testSearch n=%d after scrolling\n", __FILE__, __LINE__, n);
+	}
+	sngTermWrite(t, "\033[1Hx", 5);
+	n = search(s, t, SNG_TERM_SEARCH_CHANGED, matches, 8);
+	if (n != 1 || matches[0].x != 2 || matches[0].y != 0) {
+		fprintf(stderr, "%s:%d: testSearch n=%d\n", __FILE__, __LINE__, n);
+	}
+
+	free(searchMem);
+	free(t);
+}
+
+// snapshotDirty returns the dirty rows of snap as bits.
+int snapshotDirty(const SngTermSnapshot *snap) {
+	int bits = 0;
+	for (int y = 0; y < snap->height; y++) {
+		bits |= snap->dirty[y] << y;
+	}
+	return bits;
+}
+
+void testSnapshots() {
+	int maxWidth = 20;
+	int maxHeight = 5;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(t, maxWidth, maxHeight);
+	size_t size = sngTermSnapshotsSize(maxWidth, maxHeight);
+	SngTermSnapshots *s = sngTermSnapshotsInit(malloc(size), size, maxWidth, maxHeight);
+	if (sngTermSnapshotAcquire(s) != NULL) {
+		fprintf(stderr, "%s:%d: testSnapshots acquired before publishing\n", __FILE__, __LINE__);
+	}
+
+	const char *output = "hello\r\n\033[38;2;1;2;3mrgb";
+	sngTermWrite(t, output, strlen(output));
+	sngTermPublish(s, t);
+	const SngTermSnapshot *snap = sngTermSnapshotAcquire(s);
+	const SngTermCell *line = snap != NULL ? sngTermSnapshotLine(snap, 0) : NULL;
+	u32 rgb = 0;
+	if (
+		line == NULL || snapshotDirty(snap) != 0x1f ||
+		line[4].codepoint != 'o' || line[maxWidth-1].codepoint != ' ' ||
+		snap->cur.x != 3 || snap->cur.y != 1 ||
+		!sngTermSnapshotColorRGB(snap, sngTermSnapshotLine(snap, 1)[0].fg, &rgb) || rgb != 0x010203
+	) {
+		fprintf(stderr, "%s:%d: testSnapshots mismatch\n", __FILE__, __LINE__);
+		return;
+	}
+	if (sngTermSnapshotAcquire(s) != NULL) {
+		fprintf(stderr, "%s:%d: testSnapshots acquired twice\n", __FILE__, __LINE__);
+	}
+
+	// Rows written in snapshots the renderer skipped are still dirty.
+	sngTermWrite(t, "\033[3Hx", 5);
+	sngTermPublish(s, t);
+	sngTermWrite(t, "\033[5Hy", 5);
+	sngTermPublish(s, t);
+	sngTermPublish(s, t);
+	snap = sngTermSnapshotAcquire(s);
+	if (
+		snap == NULL || snapshotDirty(snap) != 0x14 ||
+		sngTermSnapshotLine(snap, 2)[0].codepoint != 'x' ||
+		sngTermSnapshotLine(snap, 4)[0].codepoint != 'y' ||
+		sngTermSnapshotLine(snap, 0)[0].codepoint != 'h'
+	) {
+		fprintf(stderr, "%s:%d: testSnapshots dirty=%x\n", __FILE__, __LINE__, snap ? snapshotDirty(snap) : 0);
+	}
+
+	// Scrolled rows are dirty where they moved to.
+	sngTermWrite(t, "\n", 1);
+	sngTermPublish(s, t);
+	snap = sngTermSnapshotAcquire(s);
+	if (
+		snap == NULL || snapshotDirty(snap) != 0x1f ||
+		sngTermSnapshotLine(snap, 1)[0].codepoint != 'x' ||
+		sngTermSnapshotLine(snap, 4)[0].codepoint != ' '
+	) {
+		fprintf(stderr, "%s:%d: testSnapshots dirty=%x\n", __FILE__, __LINE__, snap ? snapshotDirty(snap) : 0);
+	}
+
+	// Loading a state whose tables are as long but hold other colors still
+	// recopies them.
+	SngTerm *u = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(u, maxWidth, maxHeight);
+	sngTermWrite(u, "\033[38;2;4;5;6mz", 15);
+	size_t saveSize = sngTermSaveSize(maxWidth, maxHeight);
+	char *save = (char *)malloc(saveSize);
+	size_t saveLen = sngTermSave(u, save, saveSize);
+	if (t->rgbLen != u->rgbLen || !sngTermLoad(t, save, saveLen)) {
+		fprintf(stderr, "%s:%d: testSnapshots load\n", __FILE__, __LINE__);
+	}
+	sngTermPublish(s, t);
+	snap = sngTermSnapshotAcquire(s);
+	rgb = 0;
+	if (
+		snap == NULL ||
+		!sngTermSnapshotColorRGB(snap, sngTermSnapshotLine(snap, 0)[0].fg, &rgb) || rgb != 0x040506
+	) {
+		fprintf(stderr, "%s:%d: testSnapshots rgb=%x\n", __FILE__, __LINE__, rgb);
+	}
+	free(save);
+	free(u);
+	free(s);
+	free(t);
+}
+
+typedef struct {
+	SngTerm *t;
+	SngTermSnapshots *s;
+	int frames;
+	u8 _pad[4];
+} SnapshotWriter;
+
+// snapshotWrite writes frames that fill every row with the frame number,
+// publishing each.
+void *snapshotWrite(void *arg) {
+	SnapshotWriter *w = (SnapshotWriter *)arg;
+	for (int frame = 1; frame <= w->frames; frame++) {
+		char buf[32];
+		for (int y = 0; y < w->t->height; y++) {
+			snprintf(buf, sizeof(buf), "\033[%dH%08d", y+1, frame);
+			sngTermWrite(w->t, buf, strlen(buf));
+		}
+		sngTermPublish(w->s, w->t);
+	}
+	return NULL;
+}
+
+void testSnapshotThreads() {
+	int maxWidth = 40;
+	int maxHeight = 24;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SnapshotWriter w;
+	w.t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	sngTermSetSize(w.t, maxWidth, maxHeight);
+	size_t size = sngTermSnapshotsSize(maxWidth, maxHeight);
+	w.s = sngTermSnapshotsInit(malloc(size), size, maxWidth, maxHeight);
+	w.frames = 20000;
+	pthread_t thread;
+	pthread_create(&thread, NULL, snapshotWrite, &w);
+	// Every snapshot must be one whole frame, never older than the last.
+	int last = 0;
+	while (last < w.frames) {
+		const SngTermSnapshot *snap = sngTermSnapshotAcquire(w.s);
+		if (snap == NULL) {
+			continue;
+		}
+		int frame = -1;
+		for (int y = 0; y < snap->height; y++) {
+			const SngTermCell *line = sngTermSnapshotLine(snap, y);
+			int n = 0;
+			for (int x = 0; x < 8; x++) {
+				n = n*10 + (int)line[x].codepoint - '0';
+			}
+			if (frame == -1) {
+				frame = n;
+			} else if (n != frame) {
+				fprintf(stderr, "%s:%d: testSnapshotThreads torn frame %d %d\n", __FILE__, __LINE__, frame, n);
+				frame = w.frames;
+				break;
+			}
+		}
+		if (frame < last) {
+			fprintf(stderr, "%s:%d: testSnapshotThreads frame %d after %d\n", __FILE__, __LINE__, frame, last);
+		}
+		last = frame;
+	}
+	pthread_join(thread, NULL);
+	free(w.s);
+	free(w.t);
+}
+
+// sameSave reports whether a and b save the same bytes.
+static b32 sameSave(const SngTerm *a, const SngTerm *b) {
+	size_t size = sngTermSaveSize(a->maxWidth, a->maxHeight);
+	u8 *bufA = (u8 *)malloc(size);
+	u8 *bufB = (u8 *)malloc(size);
+	size_t lenA = sngTermSave(a, bufA, size);
+	size_t lenB = sngTermSave(b, bufB, size);
+	b32 same = lenA == lenB && memcmp(bufA, bufB, lenA) == 0;
+	free(bufA);
+	free(bufB);
+	return same;
+}
+
+// loadPatched loads the save in buf into t with n bytes at offset at
+// replaced by patch, returning what sngTermLoad does.
+static b32 loadPatched(SngTerm *t, const u8 *buf, size_t len, size_t at, const void *patch, size_t n) {
+	u8 *bad = (u8 *)malloc(len);
+	memcpy(bad, buf, len);
+	memcpy(&bad[at], patch, n);
+	b32 loaded = sngTermLoad(t, bad, len);
+	free(bad);
+	return loaded;
+}
+
+void testSaveLoad() {
+	int maxWidth = 30;
+	int maxHeight = 8;
+	size_t memSize = sngTermAllocSize(maxWidth, maxHeight);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	SngTerm *u = sngTermInit(malloc(memSize), memSize, maxWidth, maxHeight, NULL);
+	size_t poolSize = sngTermRowPoolSize(maxWidth, 2*maxHeight);
+	void *poolMem = malloc(poolSize);
+	SngTermRowPool pool;
+	sngTermRowPoolInit(&pool, poolMem, poolSize, maxWidth);
+	size_t pooledSize = sngTermAllocSizePooled(maxWidth, maxHeight);
+	SngTerm *p = sngTermInitPooled(malloc(pooledSize), pooledSize, maxWidth, maxHeight, &pool, 2*maxHeight);
+	sngTermSetSize(t, 25, 6);
+
+	// Both screens, tables and the title, saved partway through a CSI.
+	const char *output =
+		"\033]2;saved\a\033[31mred \033[38;2;1;2;3mrgb\033[m e\xcc\x81 \xe4\xb8\xad\r\n"
+		"\033[?1049halt\033[?1049l\033[2;5r\033[4;3H\0337\033[1;1H\033[3";
+	sngTermWrite(t, output, strlen(output));
+	size_t size = sngTermSaveSize(maxWidth, maxHeight);
+	u8 *buf = (u8 *)malloc(size);
+	size_t len = sngTermSave(t, buf, size);
+	if (len > size || sngTermSave(t, buf, 10) != len) {
+		fprintf(stderr, "%s:%d: testSaveLoad len=%d size=%d\n", __FILE__, __LINE__, (int)len, (int)size);
+	}
+	sngTermSave(t, buf, size);
+	if (!sngTermLoad(u, buf, len) || !sngTermLoad(p, buf, len)) {
+		fprintf(stderr, "%s:%d: testSaveLoad did not load\n", __FILE__, __LINE__);
+	}
+	if (
+		u->width != 25 || u->height != 6 || strcmp(u->title, "saved") != 0 ||
+		!(u->changed & SNG_TERM_CHANGED_TITLE) || !u->dirtyLines[5] ||
+		!sameSave(t, u) || !sameSave(t, p)
+	) {
+		fprintf(stderr, "%s:%d: testSaveLoad state differs\n", __FILE__, __LINE__);
+	}
+
+	// The loaded terminals carry on from the same place.
+	const char *more = "1;4mZ\0338\xe2\x82\xac\033[?1049hA\033[?1049lB\r\n\n\n\n\n\n";
+	sngTermWrite(t, more, strlen(more));
+	sngTermWrite(u, more, strlen(more));
+	sngTermWrite(p, more, strlen(more));
+	SngTermCell z = sngTermCell(u, 0, 0);
+	if (z.codepoint != 'Z' || z.fg != SNG_TERM_COLOR_RED || !sameSave(t, u) || !sameSave(t, p)) {
+		fprintf(stderr, "%s:%d: testSaveLoad continued differently\n", __FILE__, __LINE__);
+	}
+
+	// Saves that are cut short, or do not fit, are refused whole.
+	const char *alt = "\033[?1049hon alt";
+	sngTermWrite(t, alt, strlen(alt));
+	len = sngTermSave(t, buf, size);
+	size_t smallSize = sngTermAllocSizeMin(maxWidth, maxHeight);
+	SngTerm *small = sngTermInit(malloc(smallSize), smallSize, 20, maxHeight, NULL);
+	SngTerm *noAlt = sngTermInit(malloc(smallSize), smallSize, maxWidth, maxHeight, NULL);
+	if (sngTermLoad(u, buf, len - 1) || sngTermLoad(small, buf, len) || sngTermLoad(noAlt, buf, len)) {
+		fprintf(stderr, "%s:%d: testSaveLoad loaded a bad save\n", __FILE__, __LINE__);
+	}
+	if (!sameSave(u, p) || !sngTermLoad(u, buf, len) || !sameSave(t, u)) {
+		fprintf(stderr, "%s:%d: testSaveLoad alt screen differs\n", __FILE__, __LINE__);
+	}
+
+	// So are saves whose title, tables or parser state do not add up.
+	sngTermWrite(t, "\033[1;2", 5);
+	len = sngTermSave(t, buf, size);
+	size_t title = sizeof(_SngTermSaveHeader);
+	size_t parser = title + sizeof(t->title) + (size_t)t->width + sizeof(t->rgb) + sizeof(t->markTable);
+	char unterminated = 'x';
+	int rgbLen = t->rgbLen + 1;
+	int csiArgs = 17;
+	if (
+		loadPatched(u, buf, len, title + sizeof(t->title) - 1, &unterminated, 1) ||
+		loadPatched(u, buf, len, offsetof(_SngTermSaveHeader, rgbLen), &rgbLen, sizeof(rgbLen)) ||
+		loadPatched(u, buf, len, parser + offsetof(_SngTermCSI, argsLen), &csiArgs, sizeof(csiArgs))
+	) {
+		fprintf(stderr, "%s:%d: testSaveLoad loaded a corrupt save\n", __FILE__, __LINE__);
+	}
+	const char *osc = "m\033]2;partial";
+	sngTermWrite(t, osc, strlen(osc));
+	len = sngTermSave(t, buf, size);
+	int bufLen = 256;
+	int strArgs = 1;
+	u32 type = 'x';
+	if (
+		loadPatched(u, buf, len, parser + offsetof(_SngTermSTR, bufLen), &bufLen, sizeof(bufLen)) ||
+		loadPatched(u, buf, len, parser + offsetof(_SngTermSTR, argsLen), &strArgs, sizeof(strArgs)) ||
+		loadPatched(u, buf, len, parser + offsetof(_SngTermSTR, typeCodepoint), &type, sizeof(type))
+	) {
+		fprintf(stderr, "%s:%d: testSaveLoad loaded a corrupt save\n", __FILE__, __LINE__);
+	}
+	if (!sngTermLoad(u, buf, len) || !sameSave(t, u)) {
+		fprintf(stderr, "%s:%d: testSaveLoad did not load\n", __FILE__, __LINE__);
+	}
+	sngTermRelease(p);
+	free(noAlt);
+	free(small);
+	free(buf);
+	free(p);
+	free(poolMem);
+	free(u);
+	free(t);
+}
+
 int main(int argc, char **argv) {
 	// suppress -Wunused-parameter
 	(void)argc;
@@ -178,5 +1520,24 @@ int main(int argc, char **argv) {
 	testSTRParse();
 	testPlainChars();
 	testNewline();
+	testTrueColor();
+	testDiagnostics();
+	testStats();
+	testResolveColors();
+	testWrite();
+	testLazyClear();
+	testLazyAlt();
+	testPooledRows();
+	testInsertMode();
+	testWideChars();
+	testReflow();
+	testOutput();
+	testSync();
+	testStyleRuns();
+	testCopyText();
+	testSearch();
+	testSnapshots();
+	testSnapshotThreads();
+	testSaveLoad();
 	return 0;
 }
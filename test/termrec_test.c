@@ -0,0 +1,212 @@
+#define SNG_TERMINAL_IMPLEMENTATION
+#include "sng_terminal.h"
+
+#define SNG_TERMREC_IMPLEMENTATION
+#include "sng_termrec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// termrec_test records a generated session, and checks that seeking to
+// any time gives the state the terminal had then.
+//
+//   termrec_test        run the tests; exits non-zero on failure
+//   termrec_test bench  print how long seeking takes against replaying
+//                       the whole recording
+
+static int failures = 0;
+
+#define FAIL(...) do { \
+	fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+	fprintf(stderr, __VA_ARGS__); \
+	fprintf(stderr, "\n"); \
+	failures++; \
+} while (0)
+
+#define WIDTH 60
+#define HEIGHT 20
+
+// Buffer is where a recording is written, growing as needed.
+typedef struct {
+	u8 *data;
+	size_t len;
+	size_t cap;
+} Buffer;
+
+static b32 bufferWrite(void *user, const void *data, size_t len) {
+	Buffer *b = (Buffer *)user;
+	if (b->len + len > b->cap) {
+		b->cap = (b->len + len) * 2;
+		b->data = (u8 *)realloc(b->data, b->cap);
+	}
+	memcpy(&b->data[b->len], data, len);
+	b->len += len;
+	return 1;
+}
+
+static SngTerm *newTerm(void) {
+	size_t memSize = sngTermAllocSize(WIDTH, HEIGHT);
+	SngTerm *t = sngTermInit(malloc(memSize), memSize, WIDTH, HEIGHT, NULL);
+	sngTermSetSize(t, WIDTH, HEIGHT);
+	return t;
+}
+
+// chunk writes the output of step i of a session to buf, and returns
+// its length. Steps end partway through sequences and characters, so
+// keyframes are taken with the parser in all sorts of states.
+static size_t chunk(int i, char *buf, size_t size) {
+	static const char *pieces[] = {
+		"\033[3%dmline %d \033[1mbold\033[22m and \033[38;2;%d;2;3mrgb\033[m\r\n",
+		"\033]2;title %d\a\033[%dHcursor",
+		"\033[?1049h\033[Halt %d\033[%d;1Hmore\033[?1049l",
+		"\xe4\xb8\xad wide %d e\xcc\x81 %d\r\n",
+		"\033[2;%dr\033[5Hscroll\n\n\n\033[r%d",
+		"\033[%d;%dH\033[K\033[1J",
+	};
+	int n = snprintf(buf, size, pieces[i % 6], i % 8 + 1, i % 200);
+	// Cut each chunk somewhere, leaving the rest for the next.
+	return (size_t)n - (size_t)(i % 3);
+}
+
+// Checkpoint is the saved state of the recorded terminal at a time.
+typedef struct {
+	u64 timeMs;
+	u8 *save;
+	size_t len;
+} Checkpoint;
+
+// record records steps of a session into b, with keyframes every
+// keyframeBytes, saving the recorded terminal's state every checkEvery
+// steps into checks. Returns how many checkpoints it saved.
+static int record(Buffer *b, int steps, u64 keyframeBytes, int checkEvery, Checkpoint *checks) {
+	SngTerm *t = newTerm();
+	size_t scratchSize = sngTermRecScratchSize(WIDTH, HEIGHT);
+	void *scratch = malloc(scratchSize);
+	SngTermRecorder r;
+	sngTermRecInit(&r, t, scratch, scratchSize, keyframeBytes, bufferWrite, b, 1000);
+	char buf[256];
+	char rest[256];
+	size_t restLen = 0;
+	int checksLen = 0;
+	for (int i = 0; i < steps; i++) {
+		u64 now = 1000 + (u64)i * 10;
+		size_t n = chunk(i, buf, sizeof(buf));
+		size_t full = strlen(buf);
+		// Write the rest of the last chunk, then this one cut short.
+		sngTermRecWrite(&r, rest, restLen, now);
+		sngTermRecWrite(&r, buf, n, now);
+		memcpy(rest, &buf[n], full - n);
+		restLen = full - n;
+		if (i % 97 == 50) {
+			sngTermRecResize(&r, WIDTH - i % 7, HEIGHT - i % 5, now);
+		}
+		if (checks != NULL && i % checkEvery == 0) {
+			Checkpoint *c = &checks[checksLen++];
+			c->timeMs = now;
+			c->len = sngTermSave(t, NULL, 0);
+			c->save = (u8 *)malloc(c->len);
+			sngTermSave(t, c->save, c->len);
+		}
+	}
+	sngTermRecFinish(&r, 1000 + (u64)steps * 10);
+	free(scratch);
+	free(t);
+	return checksLen;
+}
+
+// checkSeek seeks p into t at the time of c, and compares the state.
+static void checkSeek(SngTermPlayer *p, SngTerm *t, const Checkpoint *c, u64 offsetMs) {
+	if (!sngTermPlayerSeek(p, t, c->timeMs + offsetMs)) {
+		FAIL("seek to %d failed", (int)c->timeMs);
+		return;
+	}
+	u8 *save = (u8 *)malloc(c->len);
+	size_t len = sngTermSave(t, save, c->len);
+	if (len != c->len || memcmp(save, c->save, len) != 0) {
+		FAIL("seek to %d+%d differs", (int)c->timeMs, (int)offsetMs);
+	}
+	free(save);
+}
+
+static void testSeek(void) {
+	Buffer b = {};
+	Checkpoint checks[64];
+	int steps = 3000;
+	int checksLen = record(&b, steps, 4096, steps / 60, checks);
+	SngTermPlayer p;
+	if (!sngTermPlayerInit(&p, b.data, b.len) || p.startMs != 1000 || p.endMs != 1000 + (u64)steps * 10) {
+		FAIL("sngTermPlayerInit failed");
+		return;
+	}
+	SngTerm *t = newTerm();
+	// Forward, in order, then backward and from a fresh terminal.
+	for (int i = 0; i < checksLen; i++) {
+		checkSeek(&p, t, &checks[i], 5);
+	}
+	for (int i = checksLen - 1; i >= 0; i -= 7) {
+		checkSeek(&p, t, &checks[i], 0);
+	}
+	SngTerm *fresh = newTerm();
+	checkSeek(&p, fresh, &checks[checksLen / 2], 0);
+
+	// Cut short, without its end record, the recording plays up to where
+	// it was cut.
+	size_t cut = b.len * 3 / 4;
+	if (!sngTermPlayerInit(&p, b.data, cut) || p.len > cut) {
+		FAIL("sngTermPlayerInit failed on a cut recording");
+	}
+	for (int i = 0; i < checksLen && checks[i].timeMs < p.endMs; i += 5) {
+		checkSeek(&p, t, &checks[i], 0);
+	}
+	if (sngTermPlayerInit(&p, b.data, 8)) {
+		FAIL("sngTermPlayerInit took a recording without keyframes");
+	}
+	for (int i = 0; i < checksLen; i++) {
+		free(checks[i].save);
+	}
+	free(fresh);
+	free(t);
+	free(b.data);
+}
+
+static double nowMs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static void bench(void) {
+	int steps = 4000000;
+	Buffer b = {};
+	record(&b, steps, 1 << 20, 0, NULL);
+	SngTermPlayer p;
+	sngTermPlayerInit(&p, b.data, b.len);
+	SngTerm *t = newTerm();
+	printf("recording of %.1f MB\n", (double)b.len / 1e6);
+
+	double start = nowMs();
+	sngTermPlayerPlay(&p, t, p.endMs);
+	printf("%-32s %8.2f ms\n", "replay from the start", nowMs() - start);
+
+	int seeks = 200;
+	start = nowMs();
+	for (int i = 0; i < seeks; i++) {
+		// Backward each time, so every seek loads a keyframe.
+		u64 target = p.endMs - (p.endMs - p.startMs) * (u64)i / (u64)seeks;
+		sngTermPlayerSeek(&p, t, target);
+	}
+	printf("%-32s %8.2f ms\n", "seek, 1 MB keyframes", (nowMs() - start) / seeks);
+	free(t);
+	free(b.data);
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+		bench();
+		return 0;
+	}
+	testSeek();
+	return failures != 0;
+}
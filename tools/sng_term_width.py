@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# sng_term_width.py generates the character width table in sng_terminal.h
+# from the Unicode data of the running Python, and rewrites the table in
+# place:
+#
+#     python3 tools/sng_term_width.py sng_terminal.h
+#
+# Widths follow wcwidth: 0 for combining marks and other zero width
+# characters, 2 for East Asian wide and fullwidth characters, and 1 for
+# everything else. Control characters are left to the parser, as 1.
+
+import sys
+import unicodedata
+
+BEGIN = "// BEGIN GENERATED WIDTH TABLE\n"
+END = "// END GENERATED WIDTH TABLE\n"
+BLOCK = 256
+
+WIDE_UNASSIGNED = [
+	(0x3400, 0x4dbf),
+	(0x4e00, 0x9fff),
+	(0xf900, 0xfaff),
+	(0x20000, 0x2fffd),
+	(0x30000, 0x3fffd),
+]
+
+def width(cp):
+	c = chr(cp)
+	cat = unicodedata.category(c)
+	if cp == 0xad:
+		return 1 # soft hyphen is visible in terminals
+	if cat in ("Mn", "Me", "Cf") or cp == 0x200b:
+		return 0
+	if 0x1160 <= cp <= 0x11ff or 0xd7b0 <= cp <= 0xd7ff:
+		return 0 # Hangul medial vowels and final consonants
+	if unicodedata.east_asian_width(c) in ("W", "F"):
+		return 2
+	if cat == "Cn" and any(lo <= cp <= hi for lo, hi in WIDE_UNASSIGNED):
+		return 2
+	return 1
+
+def table():
+	blocks = []
+	index = {}
+	stage1 = []
+	for base in range(0, 0x110000, BLOCK):
+		packed = bytearray(BLOCK // 4)
+		for i in range(BLOCK):
+			packed[i // 4] |= width(base + i) << ((i % 4) * 2)
+		packed = bytes(packed)
+		if packed not in index:
+			index[packed] = len(blocks)
+			blocks.append(packed)
+		stage1.append(index[packed])
+	assert len(blocks) <= 256
+	return stage1, blocks
+
+def cArray(decl, values):
+	lines = ["%s = {" % decl]
+	for i in range(0, len(values), 16):
+		lines.append("\t" + " ".join("0x%02x," % v for v in values[i:i+16]))
+	lines.append("};")
+	return "\n".join(lines) + "\n"
+
+def main():
+	path = sys.argv[1]
+	stage1, blocks = table()
+	stage2 = b"".join(blocks)
+	out = BEGIN
+	out += "// Unicode %s, from tools/sng_term_width.py\n" % unicodedata.unidata_version
+	out += cArray("static const u8 _sngTermWidthBlocks[%d]" % len(stage1), stage1)
+	out += cArray("static const u8 _sngTermWidthBits[%d]" % len(stage2), stage2)
+	out += END
+	with open(path) as f:
+		src = f.read()
+	begin = src.index(BEGIN)
+	end = src.index(END) + len(END)
+	with open(path, "w") as f:
+		f.write(src[:begin] + out + src[end:])
+
+if __name__ == "__main__":
+	main()